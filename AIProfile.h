@@ -0,0 +1,72 @@
+#pragma once
+
+#ifndef	BZF_AIPROFILE_H
+#define	BZF_AIPROFILE_H
+
+#include <atomic>
+#include <chrono>
+
+// ============================================================
+// Time the robots spend thinking, by the kind of work, for the robot simulation benchmark
+// (benchmark/RobotSim.cxx). Only compiled in with AI_PROFILE defined; otherwise AI_PROFILE_SCOPE is empty.
+// A scope's time counts for its part less the time of the scopes opened inside it, so that, e.g., a plan
+// made while following a path only counts as planning. The totals add up the time of all threads,
+// including plans made on planner threads.
+
+#ifdef AI_PROFILE
+#define AI_PROFILE_SCOPE(part) AIProfile::Scope aiProfileScope(part)
+#else
+#define AI_PROFILE_SCOPE(part)
+#endif
+
+class AIProfile
+{
+public:
+	enum Part
+	{
+		DECISIONS, // walking the decision trees, and the actions that only set controls
+		PLANNING, // planning paths and taking the planned ones
+		PATH_FOLLOWING, // steering along the current path
+		PERCEPTION, // looking at shots, players, flags and their influence
+		PARTS
+	};
+
+	static const char* getName(Part part)
+	{
+		static const char* names[PARTS] = { "decisions", "planning", "path_following", "perception" };
+		return names[part];
+	}
+
+	// milliseconds spent in part since it was last taken
+	static double take(Part part) { return getTotals()[part].exchange(0) / 1.0e6; }
+
+	class Scope
+	{
+	public:
+		Scope(Part part) : part(part), inner(0), outer(getCurrent()), begin(std::chrono::steady_clock::now())
+			{ getCurrent() = this; }
+		~Scope()
+		{
+			long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+			getTotals()[part] += elapsed - inner;
+			if (outer)
+				outer->inner += elapsed;
+			getCurrent() = outer;
+		}
+
+	private:
+		Scope(const Scope&);
+		Scope& operator=(const Scope&);
+
+		Part part;
+		long long inner; // nanoseconds in the scopes inside this one
+		Scope* outer;
+		std::chrono::steady_clock::time_point begin;
+	};
+
+private:
+	static std::atomic<long long>* getTotals(void) { static std::atomic<long long> totals[PARTS]; return totals; } // nanoseconds
+	static Scope*& getCurrent(void) { static thread_local Scope* current = NULL; return current; } // innermost scope of this thread
+};
+
+#endif // BZF_AIPROFILE_H
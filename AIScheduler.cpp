@@ -0,0 +1,123 @@
+#include "AIScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include "common.h"
+#include "RobotPlayer.h"
+#include "WorldView.h" // needed for the flags of this tick
+#include "Roster.h" // needed for robots[]
+
+std::vector<AIScheduler::Slot> AIScheduler::slots;
+std::vector<bool> AIScheduler::flagTaken;
+std::vector<int> AIScheduler::lineup;
+int AIScheduler::lineupNext = 0;
+float AIScheduler::clock = 0.0f, AIScheduler::budget = AI_SCHEDULER_BUDGET;
+double AIScheduler::frameStart = 0.0;
+
+static double now(void)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void AIScheduler::beginFrame(float dt)
+{
+	clock += dt;
+	frameStart = now();
+	if ((int)slots.size() < numRobots) {
+		Slot empty = { NULL, 0.0f, false };
+		slots.resize(numRobots, empty);
+	}
+	checkFlags();
+
+	lineup.clear();
+	lineupNext = 0;
+	for (int i = 0; i < numRobots; i++) {
+		Slot& slot = slots[i];
+		if (!robots[i]) {
+			slot.robot = NULL;
+			continue;
+		}
+		if (slot.robot != robots[i]) {
+			// a new robot: its first turn somewhere in the next period
+			slot.robot = robots[i];
+			slot.due = clock + AI_SCHEDULER_PERIOD * (float)bzfrand();
+			slot.urgent = false;
+		}
+		if (!robots[i]->isAlive() && robots[i]->isExploding())
+			continue; // cannot be started yet, so its turn waits
+		const Player* target = robots[i]->getTarget();
+		if (robots[i]->isAlive() && (!target || !target->isAlive()))
+			slot.urgent = true;
+		if (slot.urgent || slot.due <= clock)
+			lineup.push_back(i);
+	}
+	std::sort(lineup.begin(), lineup.end(), turnBefore);
+}
+
+int AIScheduler::nextRobot(void)
+{
+	if (lineupNext >= (int)lineup.size())
+		return -1;
+	if (lineupNext > 0 && budget > 0.0f && now() - frameStart > budget)
+		return -1; // the rest stay due, and come first in the next frame
+	int index = lineup[lineupNext++];
+	slots[index].urgent = false;
+	slots[index].due = nextDue();
+	return index;
+}
+
+void AIScheduler::makeUrgent(int index)
+{
+	if (index >= 0 && index < (int)slots.size())
+		slots[index].urgent = true;
+}
+
+void AIScheduler::setBudget(float seconds)
+{
+	budget = std::max(0.0f, seconds);
+}
+
+void AIScheduler::reset(void)
+{
+	slots.clear();
+	flagTaken.clear();
+	lineup.clear();
+	lineupNext = 0;
+	clock = 0.0f;
+}
+
+// lineup order: urgent robots first, then the earliest turns
+bool AIScheduler::turnBefore(int a, int b)
+{
+	if (slots[a].urgent != slots[b].urgent)
+		return slots[a].urgent;
+	if (slots[a].due != slots[b].due)
+		return slots[a].due < slots[b].due;
+	return a < b;
+}
+
+// a period from now, give or take the jitter, so that turns that fell on the same frame drift apart
+float AIScheduler::nextDue(void)
+{
+	return clock + AI_SCHEDULER_PERIOD * (1.0f + AI_SCHEDULER_JITTER * (2.0f * (float)bzfrand() - 1.0f));
+}
+
+// the robots of a team whose flag was just taken off the ground are urgent: their goals change
+void AIScheduler::checkFlags(void)
+{
+	const WorldView& view = WorldView::get();
+	if ((int)flagTaken.size() != view.flagCount) {
+		// another world: compare from now on
+		flagTaken.assign(view.flagCount, false);
+		for (int i = 0; i < view.flagCount; i++)
+			flagTaken[i] = view.flagStatus[i] == FlagOnTank;
+		return;
+	}
+	for (int i = 0; i < view.flagCount; i++) {
+		bool taken = view.flagStatus[i] == FlagOnTank;
+		if (taken && !flagTaken[i] && view.flagTeam[i] != NoTeam)
+			for (int r = 0; r < numRobots; r++)
+				if (robots[r] && robots[r]->getTeam() == view.flagTeam[i] && robots[r]->isAlive())
+					makeUrgent(r);
+		flagTaken[i] = taken;
+	}
+}
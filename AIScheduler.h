@@ -0,0 +1,65 @@
+#pragma once
+
+#ifndef	BZF_AISCHEDULER_H
+#define	BZF_AISCHEDULER_H
+
+#include <vector>
+
+#define AI_SCHEDULER_PERIOD 1.0f // seconds between a robot's turns to be retargeted
+#define AI_SCHEDULER_JITTER 0.1f // turns come up to this fraction of the period early or late
+#define AI_SCHEDULER_BUDGET 0.004f // seconds per frame for retargeting, 0 for no limit
+
+class RobotPlayer;
+
+// ============================================================
+// Decides which robots of robots[] (Roster.h) are retargeted in a frame. Retargeting plans a path, so
+// instead of retargeting all robots on the same frame once a period, each robot gets a turn of its
+// own: the first at a random time within a period, the next a period later, give or take the jitter,
+// so the turns stay spread over the frames. A frame takes the robots whose turn came in the order of
+// their turns, until the frame's budget is spent; the rest come first in the next frame. Urgent
+// robots come before all others: a live robot without a target or whose target died, the robots of a
+// team whose flag was just taken, and robots marked urgent by the caller (e.g. just restarted). A dead
+// robot is not taken while it is still exploding; it keeps its turn for the first frame after. At
+// least one robot is taken per frame, so no robot waits forever. Game thread only, after
+// WorldView::update.
+//
+// A frame is:
+//	AIScheduler::beginFrame(dt);
+//	for (int i = AIScheduler::nextRobot(); i >= 0; i = AIScheduler::nextRobot())
+//		... retarget (or start) robots[i] ...
+
+class AIScheduler
+{
+public:
+	// Advances the clock by dt and lines up the robots to retarget this frame
+	static void beginFrame(float dt);
+	// Index in robots[] of the next robot to retarget, -1 when the frame has none left or its budget is spent.
+	// The robot's next turn is a period from now.
+	static int nextRobot(void);
+	// robots[index] is retargeted first in the next frame
+	static void makeUrgent(int index);
+
+	static void setBudget(float seconds); // 0 for no limit, which keeps runs independent of the machine's speed
+	static void reset(void); // forgets all robots and flags, e.g. for a new game
+
+private:
+	struct Slot
+	{
+		const RobotPlayer* robot; // the robot the turns are for; another one in the slot starts afresh
+		float due; // clock time of the next turn
+		bool urgent;
+	};
+
+	static bool turnBefore(int a, int b);
+	static float nextDue(void);
+	static void checkFlags(void);
+
+	static std::vector<Slot> slots; // by index in robots[]
+	static std::vector<bool> flagTaken; // by flag index: a team flag was on a tank
+	static std::vector<int> lineup; // of this frame, urgent first, then by turn
+	static int lineupNext;
+	static float clock, budget;
+	static double frameStart; // seconds, steady clock
+};
+
+#endif // BZF_AISCHEDULER_H
@@ -0,0 +1,392 @@
+#include "AStarHierarchy.h"
+#include <math.h>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include "common.h"
+
+AStarHierarchy::AStarHierarchy(void)
+	: xmin(0), ymin(0), width(0), height(0), clustersX(0), clustersY(0),
+	  straightCost(0), diagonalCost(0), worldGeneration(-1)
+{
+}
+
+// -------------------------------
+// building the abstraction
+
+void AStarHierarchy::build(void)
+{
+	FixedCostGraphFunctionContainer costs;
+	straightCost = costs.getStraightCost();
+	diagonalCost = costs.getDiagonalCost();
+
+	xmin = GraphFunctionContainer::Xmin;
+	ymin = GraphFunctionContainer::Ymin;
+	width = GraphFunctionContainer::Xmax - xmin + 1;
+	height = GraphFunctionContainer::Ymax - ymin + 1;
+	clustersX = (width + HPA_CLUSTER_SIZE - 1) / HPA_CLUSTER_SIZE;
+	clustersY = (height + HPA_CLUSTER_SIZE - 1) / HPA_CLUSTER_SIZE;
+
+	access.assign(width * height, 0);
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			access[x + y * width] = AStarNode::isAccessible(x + xmin, y + ymin) ? 1 : 0;
+
+	nodeIndex.assign(width * height, -1);
+	nodes.clear();
+	clusterNodes.assign(clustersX * clustersY, std::vector<int>());
+
+	// transitions across the vertical and horizontal cluster borders
+	for (int cy = 0; cy < clustersY; cy++)
+		for (int cx = 0; cx < clustersX; cx++) {
+			int x0, y0, x1, y1;
+			clusterBounds(cx + cy * clustersX, x0, y0, x1, y1);
+			if (cx + 1 < clustersX)
+				addEntrances(x1, y0, 0, 1, y1 - y0 + 1, 1, 0);
+			if (cy + 1 < clustersY)
+				addEntrances(x0, y1, 1, 0, x1 - x0 + 1, 0, 1);
+		}
+
+	// costs of the shortest paths between the nodes of each cluster; the paths are found again when refining
+	std::vector<int> dist, parent;
+	for (int c = 0; c < (int)clusterNodes.size(); c++) {
+		std::vector<int>& members = clusterNodes[c];
+		for (int i = 0; i < (int)members.size(); i++) {
+			Node& from = nodes[members[i]];
+			clusterSearch(c, from.x, from.y, dist, parent);
+			int x0, y0, x1, y1;
+			clusterBounds(c, x0, y0, x1, y1);
+			for (int j = 0; j < (int)members.size(); j++) {
+				const Node& to = nodes[members[j]];
+				int d = dist[(to.x - x0) + (to.y - y0) * HPA_CLUSTER_SIZE];
+				if (i == j || d < 0)
+					continue;
+				Edge e = { members[j], d };
+				from.edges.push_back(e);
+			}
+		}
+	}
+
+	worldGeneration = GraphFunctionContainer::getWorldGeneration();
+}
+
+// Scans one cluster border for openings. The border starts at (x, y) on the near side, runs for length
+// nodes in direction (dx, dy), and (nx, ny) steps across it.
+void AStarHierarchy::addEntrances(int x, int y, int dx, int dy, int length, int nx, int ny)
+{
+	int runStart = -1;
+	for (int i = 0; i <= length; i++) {
+		bool open = i < length && accessible(x + i * dx, y + i * dy) && accessible(x + i * dx + nx, y + i * dy + ny);
+		if (open && runStart < 0)
+			runStart = i;
+		if (open || runStart < 0)
+			continue;
+
+		int runEnd = i - 1;
+		std::vector<int> transitions;
+		if (runEnd - runStart + 1 < HPA_MAX_SINGLE_ENTRANCE)
+			transitions.push_back((runStart + runEnd) / 2);
+		else {
+			for (int t = runStart; t < runEnd; t += HPA_TRANSITION_SPACING)
+				transitions.push_back(t);
+			transitions.push_back(runEnd);
+		}
+		for (int t = 0; t < (int)transitions.size(); t++) {
+			int ax = x + transitions[t] * dx, ay = y + transitions[t] * dy;
+			int a = nodeAt(ax, ay);
+			int b = nodeAt(ax + nx, ay + ny);
+			Edge ab = { b, straightCost };
+			Edge ba = { a, straightCost };
+			nodes[a].edges.push_back(ab);
+			nodes[b].edges.push_back(ba);
+		}
+		runStart = -1;
+	}
+}
+
+int AStarHierarchy::nodeAt(int x, int y)
+{
+	int& index = nodeIndex[(x - xmin) + (y - ymin) * width];
+	if (index < 0) {
+		Node n;
+		n.x = x;
+		n.y = y;
+		n.cluster = clusterOf(x, y);
+		index = nodes.size();
+		nodes.push_back(n);
+		clusterNodes[n.cluster].push_back(index);
+	}
+	return index;
+}
+
+int AStarHierarchy::clusterOf(int x, int y) const
+{
+	return (x - xmin) / HPA_CLUSTER_SIZE + ((y - ymin) / HPA_CLUSTER_SIZE) * clustersX;
+}
+
+void AStarHierarchy::clusterBounds(int cluster, int& x0, int& y0, int& x1, int& y1) const
+{
+	x0 = xmin + (cluster % clustersX) * HPA_CLUSTER_SIZE;
+	y0 = ymin + (cluster / clustersX) * HPA_CLUSTER_SIZE;
+	x1 = std::min(x0 + HPA_CLUSTER_SIZE, xmin + width) - 1;
+	y1 = std::min(y0 + HPA_CLUSTER_SIZE, ymin + height) - 1;
+}
+
+// Dijkstra from (sx, sy) over the 8-connected nodes of one cluster. dist and parent are indexed by the
+// position inside the cluster, (x - x0) + (y - y0) * HPA_CLUSTER_SIZE; dist is -1 where unreachable.
+void AStarHierarchy::clusterSearch(int cluster, int sx, int sy, std::vector<int>& dist, std::vector<int>& parent) const
+{
+	typedef std::pair<int, int> Entry; // (distance, local index)
+	int x0, y0, x1, y1;
+	clusterBounds(cluster, x0, y0, x1, y1);
+	dist.assign(HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE, -1);
+	parent.assign(HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE, -1);
+
+	std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > open;
+	int s = (sx - x0) + (sy - y0) * HPA_CLUSTER_SIZE;
+	dist[s] = 0;
+	open.push(Entry(0, s));
+	while (!open.empty()) {
+		Entry e = open.top();
+		open.pop();
+		if (e.first != dist[e.second])
+			continue; // stale entry
+		int x = x0 + e.second % HPA_CLUSTER_SIZE, y = y0 + e.second / HPA_CLUSTER_SIZE;
+		for (int a = -1; a <= 1; a++)
+			for (int b = -1; b <= 1; b++) {
+				int tx = x + a, ty = y + b;
+				if ((a == 0 && b == 0) || tx < x0 || tx > x1 || ty < y0 || ty > y1 || !accessible(tx, ty))
+					continue;
+				int t = (tx - x0) + (ty - y0) * HPA_CLUSTER_SIZE;
+				int d = e.first + ((a != 0 && b != 0) ? diagonalCost : straightCost);
+				if (dist[t] < 0 || d < dist[t]) {
+					dist[t] = d;
+					parent[t] = e.second;
+					open.push(Entry(d, t));
+				}
+			}
+	}
+}
+
+// Appends the path from the source of the last clusterSearch to (tx, ty), both included
+void AStarHierarchy::clusterPath(int cluster, const std::vector<int>& parent, int tx, int ty, std::vector<AStarNode>& path) const
+{
+	int x0, y0, x1, y1;
+	clusterBounds(cluster, x0, y0, x1, y1);
+	size_t first = path.size();
+	for (int t = (tx - x0) + (ty - y0) * HPA_CLUSTER_SIZE; t >= 0; t = parent[t])
+		path.push_back(AStarNode(x0 + t % HPA_CLUSTER_SIZE, y0 + t / HPA_CLUSTER_SIZE));
+	std::reverse(path.begin() + first, path.end());
+}
+
+int AStarHierarchy::getEdgeCount(void) const
+{
+	int count = 0;
+	for (int i = 0; i < (int)nodes.size(); i++)
+		count += nodes[i].edges.size();
+	return count;
+}
+
+// -------------------------------
+// planning
+
+bool AStarHierarchy::isLongRange(const AStarNode& start, const AStarNode& goal) const
+{
+	return abs(start.getX() - goal.getX()) >= 2 * HPA_CLUSTER_SIZE || abs(start.getY() - goal.getY()) >= 2 * HPA_CLUSTER_SIZE;
+}
+
+bool AStarHierarchy::plan(const AStarNode& start, const AStarNode& goal, std::vector<AStarNode>& path, int* expansionCount) const
+{
+	if (expansionCount)
+		*expansionCount = 0;
+	int sx = start.getX(), sy = start.getY(), gx = goal.getX(), gy = goal.getY();
+	if (!isBuilt() || sx < xmin || sy < ymin || sx >= xmin + width || sy >= ymin + height
+		|| gx < xmin || gy < ymin || gx >= xmin + width || gy >= ymin + height
+		|| !accessible(sx, sy) || !accessible(gx, gy))
+		return false;
+
+	int startId = nodes.size(), goalId = nodes.size() + 1;
+	int startCluster = clusterOf(sx, sy), goalCluster = clusterOf(gx, gy);
+	AStarHierarchyGraph graph(this, startId, goalId, goalCluster, straightCost, diagonalCost);
+	graph.startX = sx; graph.startY = sy;
+	graph.goalX = gx; graph.goalY = gy;
+
+	// join start and goal to the nodes of their clusters
+	int x0, y0, x1, y1;
+	std::vector<int> startDist, startParent, goalDist, goalParent, dist, parent;
+	clusterSearch(startCluster, sx, sy, startDist, startParent);
+	clusterBounds(startCluster, x0, y0, x1, y1);
+	for (int i = 0; i < (int)clusterNodes[startCluster].size(); i++) {
+		const Node& n = nodes[clusterNodes[startCluster][i]];
+		int d = startDist[(n.x - x0) + (n.y - y0) * HPA_CLUSTER_SIZE];
+		if (d >= 0) {
+			AStarHierarchy::Edge e = { clusterNodes[startCluster][i], d };
+			graph.startEdges.push_back(e);
+		}
+	}
+	clusterSearch(goalCluster, gx, gy, goalDist, goalParent);
+	clusterBounds(goalCluster, x0, y0, x1, y1);
+	graph.goalCosts.assign(nodes.size(), -1);
+	for (int i = 0; i < (int)clusterNodes[goalCluster].size(); i++) {
+		const Node& n = nodes[clusterNodes[goalCluster][i]];
+		graph.goalCosts[clusterNodes[goalCluster][i]] = goalDist[(n.x - x0) + (n.y - y0) * HPA_CLUSTER_SIZE];
+	}
+
+	// abstract search
+	typedef StaticSearchGraphDescriptor<AStarHierarchyNode, int, AStarHierarchyGraph> AbstractDescriptor;
+	AbstractDescriptor abstractGraph;
+	abstractGraph.graph = &graph;
+	abstractGraph.hashTableSize = nodes.size() + 2;
+	abstractGraph.perfectHash = true;
+	abstractGraph.SeedNode = AStarHierarchyNode(startId);
+	abstractGraph.TargetNode = AStarHierarchyNode(goalId);
+	A_star_planner<AStarHierarchyNode, int, DefaultOpenList< AStarHierarchyNode, int, A_star_variables<int> >::type,
+		AbstractDescriptor> planner;
+	planner.setParams(1.0, 10, 0);
+	planner.setNodePooling();
+	planner.init(&abstractGraph);
+	planner.plan();
+	if (expansionCount)
+		*expansionCount = planner.hash->nodeCount();
+	std::vector< std::vector<AStarHierarchyNode> > abstractPaths = planner.getPlannedPaths();
+	if (abstractPaths.empty())
+		return false;
+
+	// refine: abstract path is goal first, so walk it backwards from the start
+	std::vector<AStarHierarchyNode>& abstractPath = abstractPaths[0];
+	std::vector<AStarNode> forward;
+	std::vector<int> waypoints; // where the abstract nodes are in forward
+	forward.push_back(start);
+	for (int i = abstractPath.size() - 1; i > 0; i--) {
+		int from = abstractPath[i].id, to = abstractPath[i - 1].id;
+		waypoints.push_back(forward.size() - 1);
+		if (from == startId) {
+			const Node& n = nodes[to];
+			std::vector<AStarNode> leg;
+			clusterPath(startCluster, startParent, n.x, n.y, leg);
+			forward.insert(forward.end(), leg.begin() + 1, leg.end());
+		}
+		else if (to == goalId) {
+			const Node& n = nodes[from];
+			std::vector<AStarNode> leg;
+			clusterPath(goalCluster, goalParent, n.x, n.y, leg); // goal to n
+			forward.insert(forward.end(), leg.rbegin() + 1, leg.rend());
+		}
+		else if (nodes[from].cluster != nodes[to].cluster)
+			forward.push_back(AStarNode(nodes[to].x, nodes[to].y));
+		else {
+			std::vector<AStarNode> leg;
+			clusterSearch(nodes[from].cluster, nodes[from].x, nodes[from].y, dist, parent);
+			clusterPath(nodes[from].cluster, parent, nodes[to].x, nodes[to].y, leg);
+			forward.insert(forward.end(), leg.begin() + 1, leg.end());
+		}
+	}
+
+	waypoints.push_back(forward.size() - 1);
+	shortcut(forward, waypoints);
+
+	path.assign(forward.rbegin(), forward.rend());
+	return true;
+}
+
+// Appends the nodes after (x0, y0) up to (x1, y1) of an octile line, its diagonal steps first or last.
+// Returns false, with path unchanged, if one of them is not accessible.
+bool AStarHierarchy::octileLine(int x0, int y0, int x1, int y1, bool diagonalFirst, std::vector<AStarNode>& path) const
+{
+	size_t first = path.size();
+	int dx = x1 > x0 ? 1 : (x1 < x0 ? -1 : 0), dy = y1 > y0 ? 1 : (y1 < y0 ? -1 : 0);
+	int diagonals = std::min(abs(x1 - x0), abs(y1 - y0)), straights = std::max(abs(x1 - x0), abs(y1 - y0)) - diagonals;
+	int sx = abs(x1 - x0) > abs(y1 - y0) ? dx : 0, sy = sx ? 0 : dy;
+	int x = x0, y = y0;
+	for (int k = 0; k < diagonals + straights; k++) {
+		bool diagonal = diagonalFirst ? k < diagonals : k >= straights;
+		x += diagonal ? dx : sx;
+		y += diagonal ? dy : sy;
+		if (!accessible(x, y)) {
+			path.resize(first);
+			return false;
+		}
+		path.push_back(AStarNode(x, y));
+	}
+	return true;
+}
+
+// Shortens a refined path (start first): from each waypoint, jumps to the farthest of the next
+// HPA_SHORTCUT_REACH waypoints that an octile line reaches through accessible nodes for less.
+// The transitions fix where a path crosses cluster borders, and this takes out most of the detours
+// that forces (see planPaths for what is left).
+void AStarHierarchy::shortcut(std::vector<AStarNode>& path, const std::vector<int>& waypoints) const
+{
+	std::vector<int> cost(path.size(), 0); // from the start, along path
+	for (int i = 1; i < (int)path.size(); i++) {
+		bool diagonal = path[i].getX() != path[i - 1].getX() && path[i].getY() != path[i - 1].getY();
+		cost[i] = cost[i - 1] + (diagonal ? diagonalCost : straightCost);
+	}
+	std::vector<AStarNode> shortened, line;
+	shortened.push_back(path[0]);
+	int w = 0;
+	while (w + 1 < (int)waypoints.size()) {
+		int a = waypoints[w], next = w + 1;
+		for (int v = std::min(w + HPA_SHORTCUT_REACH, (int)waypoints.size() - 1); v > w + 1; v--) {
+			int b = waypoints[v];
+			int dx = abs(path[b].getX() - path[a].getX()), dy = abs(path[b].getY() - path[a].getY());
+			int direct = std::min(dx, dy) * diagonalCost + (std::max(dx, dy) - std::min(dx, dy)) * straightCost;
+			if (direct >= cost[b] - cost[a])
+				continue;
+			line.clear();
+			if (octileLine(path[a].getX(), path[a].getY(), path[b].getX(), path[b].getY(), true, line)
+				|| octileLine(path[a].getX(), path[a].getY(), path[b].getX(), path[b].getY(), false, line)) {
+				next = v;
+				break;
+			}
+		}
+		if (next == w + 1)
+			shortened.insert(shortened.end(), path.begin() + a + 1, path.begin() + waypoints[next] + 1);
+		else
+			shortened.insert(shortened.end(), line.begin(), line.end());
+		w = next;
+	}
+	path.swap(shortened);
+}
+
+// -------------------------------
+// abstract search graph
+
+AStarHierarchyGraph::AStarHierarchyGraph(const AStarHierarchy* hierarchy, int startId, int goalId, int goalCluster,
+	int straightCost, int diagonalCost)
+	: goalX(0), goalY(0), startX(0), startY(0), hierarchy(hierarchy), startId(startId), goalId(goalId),
+	  goalCluster(goalCluster), straightCost(straightCost), diagonalCost(diagonalCost)
+{
+}
+
+void AStarHierarchyGraph::getSuccessors(AStarHierarchyNode& n, std::vector<AStarHierarchyNode>* s, std::vector<int>* c)
+{
+	if (n.id == goalId)
+		return;
+	const std::vector<AStarHierarchy::Edge>& edges = (n.id == startId) ? startEdges : hierarchy->getNode(n.id).edges;
+	for (int e = 0; e < (int)edges.size(); e++) {
+		s->push_back(AStarHierarchyNode(edges[e].to));
+		c->push_back(edges[e].cost);
+	}
+	if (n.id != startId && hierarchy->getNode(n.id).cluster == goalCluster && goalCosts[n.id] >= 0) {
+		s->push_back(AStarHierarchyNode(goalId));
+		c->push_back(goalCosts[n.id]);
+	}
+}
+
+// octile distance in fixed-point costs; never more than the cost of a grid path, so admissible and consistent
+int AStarHierarchyGraph::getHeuristics(AStarHierarchyNode& n1, AStarHierarchyNode& n2)
+{
+	int x1, y1, x2, y2;
+	position(n1.id, x1, y1);
+	position(n2.id, x2, y2);
+	int dx = abs(x2 - x1), dy = abs(y2 - y1);
+	return (dx < dy) ? dx * diagonalCost + (dy - dx) * straightCost : dy * diagonalCost + (dx - dy) * straightCost;
+}
+
+void AStarHierarchyGraph::position(int n, int& x, int& y)
+{
+	if (n == startId) { x = startX; y = startY; }
+	else if (n == goalId) { x = goalX; y = goalY; }
+	else { x = hierarchy->getNode(n).x; y = hierarchy->getNode(n).y; }
+}
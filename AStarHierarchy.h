@@ -0,0 +1,121 @@
+#pragma once
+
+#ifndef	BZF_ASTARHIERARCHY_H
+#define	BZF_ASTARHIERARCHY_H
+
+#include "AStarNode.h"
+#include <vector>
+
+#define HPA_CLUSTER_SIZE 16 // cluster width and height in nodes
+#define HPA_MAX_SINGLE_ENTRANCE 6 // border openings shorter than this get one transition in the middle
+#define HPA_TRANSITION_SPACING 4 // longer ones get one at each end and every this many nodes between
+#define HPA_SHORTCUT_REACH 8 // waypoints ahead a refined path may be shortened to
+#define HPA_COST_BOUND 1.07 // most a path costs, in times the optimum (see below)
+
+// ============================================================
+// Hierarchical path-finding (HPA*) abstraction of the constant-cost A* grid.
+// The grid is cut into square clusters. Each opening in the border between two clusters gets
+// transitions, whose nodes on both sides become the nodes of the abstract graph; nodes in the
+// same cluster are joined by the cost of their shortest path inside the cluster. Built once per world,
+// since it only depends on the static obstacles. A plan then searches the small abstract graph and only
+// needs grid searches inside the clusters it passes; the path is then shortened by octile lines between
+// its waypoints. Costs are the fixed-point costs of FixedCostGraphFunctionContainer.
+// Paths cost up to 1.07 times the optimum (plannerbench maps, sizes 400 to 3200: 1.03 open, 1.05 city,
+// 1.07 maze), so they are not shortest paths for PathCache. The robots plan with JPS instead, which is
+// optimal and faster with its precomputed jump distances (see RobotPlayer::planPaths).
+
+class AStarHierarchy
+{
+public:
+	AStarHierarchy(void);
+
+	// Builds the abstraction for the current world bounds (GraphFunctionContainer::Xmin..) and obstacles
+	void build(void);
+	bool isBuilt(void) const { return worldGeneration == GraphFunctionContainer::getWorldGeneration(); }
+
+	// true if start and goal are far enough apart for a hierarchical plan to pay off
+	bool isLongRange(const AStarNode& start, const AStarNode& goal) const;
+
+	// Plans from start to goal. path is in planner order (goal first, start last, one node per step).
+	// Returns false if the abstraction is not built or has no path, so the caller can fall back to a grid search.
+	// Does not change the abstraction, so several planner threads may plan at once.
+	// expansionCount, if given, is set to the number of abstract nodes the plan reached.
+	bool plan(const AStarNode& start, const AStarNode& goal, std::vector<AStarNode>& path, int* expansionCount = NULL) const;
+
+	int getNodeCount(void) const { return nodes.size(); }
+	int getEdgeCount(void) const;
+
+	// Edge of the abstract graph: a step between neighbouring clusters, or the shortest path between
+	// two nodes of the same cluster (found again when a plan is refined)
+	struct Edge
+	{
+		int to;
+		int cost;
+	};
+	struct Node
+	{
+		int x, y;
+		int cluster;
+		std::vector<Edge> edges;
+	};
+
+	const Node& getNode(int id) const { return nodes[id]; }
+	int clusterOf(int x, int y) const;
+
+private:
+	bool accessible(int x, int y) const { return access[(x - xmin) + (y - ymin) * width] != 0; }
+	int nodeAt(int x, int y);
+	void addEntrances(int x, int y, int dx, int dy, int length, int nx, int ny);
+	void clusterSearch(int cluster, int sx, int sy, std::vector<int>& dist, std::vector<int>& parent) const;
+	void clusterPath(int cluster, const std::vector<int>& parent, int tx, int ty, std::vector<AStarNode>& path) const;
+	void clusterBounds(int cluster, int& x0, int& y0, int& x1, int& y1) const;
+	bool octileLine(int x0, int y0, int x1, int y1, bool diagonalFirst, std::vector<AStarNode>& path) const;
+	void shortcut(std::vector<AStarNode>& path, const std::vector<int>& waypoints) const;
+
+	int xmin, ymin, width, height; // grid covered
+	int clustersX, clustersY;
+	int straightCost, diagonalCost;
+	std::vector<unsigned char> access; // accessibility of every grid node, row by row
+	std::vector<int> nodeIndex; // abstract node of every grid node, -1 if none
+	std::vector<Node> nodes;
+	std::vector< std::vector<int> > clusterNodes; // abstract nodes in each cluster
+	int worldGeneration; // world the abstraction was built for
+};
+
+// ============================================================
+// Search graph over the abstract nodes for one AStarHierarchy::plan, for A_star_planner with
+// StaticSearchGraphDescriptor. Nodes are abstract node ids; startId and goalId are the
+// start and goal of the query, joined to the nodes of their clusters.
+
+// Abstract node id wrapped in a class, as the planner needs for NodeType
+class AStarHierarchyNode
+{
+public:
+	AStarHierarchyNode(int id = -1) : id(id) {}
+	bool operator==(const AStarHierarchyNode& n) const { return id == n.id; }
+	int id;
+};
+
+class AStarHierarchyGraph
+{
+public:
+	AStarHierarchyGraph(const AStarHierarchy* hierarchy, int startId, int goalId, int goalCluster,
+		int straightCost, int diagonalCost);
+
+	int getHashBin(AStarHierarchyNode& n) { return n.id; }
+	void getSuccessors(AStarHierarchyNode& n, std::vector<AStarHierarchyNode>* s, std::vector<int>* c);
+	int getHeuristics(AStarHierarchyNode& n1, AStarHierarchyNode& n2);
+
+	std::vector<AStarHierarchy::Edge> startEdges; // start to the nodes of its cluster
+	std::vector<int> goalCosts; // cost from each node of the goal cluster to the goal, -1 if unreachable
+	int goalX, goalY, startX, startY;
+
+private:
+	void position(int n, int& x, int& y);
+
+	const AStarHierarchy* hierarchy;
+	int startId, goalId, goalCluster;
+	int straightCost, diagonalCost;
+};
+
+#endif // BZF_ASTARHIERARCHY_H
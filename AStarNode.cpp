@@ -1,9 +1,12 @@
 #include "AStarNode.h"
 #include <math.h>
+#include <algorithm>
 #include "common.h"
 #include "BZDBCache.h"
 #include "World.h"
 #include "playing.h" // needed for controlPanel
+#include "OccupancyGrid.h"
+#include "Landmarks.h"
 
 #define BAD_FLAG_TRACE
 
@@ -46,9 +49,11 @@ AStarNode::AStarNode(int xi, int yi)
 	x = xi;
 	y = yi;
 }
-int GraphFunctionContainer::getHashBin(AStarNode& n)
+// getHashBin (in the header) is a perfect hash over Xmin-1..Xmax+1 x Ymin-1..Ymax+1, so the out-of-world
+// neighbours that getSuccessors generates along the border get bins of their own too
+int GraphFunctionContainer::getHashTableSize(void)
 {
-	return ((n.getY() + abs(Ymin) + 1) * ((abs(Xmin) * 2) + 1)) + (n.getX() + abs(Xmin) + 1);
+	return ((abs(Xmin) * 2) + 3) * ((abs(Ymin) * 2) + 3);
 }
 
 // returns true if the location (x, y) is inside the world boundaries and not in a building
@@ -58,7 +63,9 @@ bool AStarNode::isAccessible(int x, int y)
 	if (x<GraphFunctionContainer::Xmin || x>GraphFunctionContainer::Xmax ||
 		y<GraphFunctionContainer::Ymin || y>GraphFunctionContainer::Ymax)
 		return false;
-	// if not inside an obstacle
+	if (OccupancyGrid::isBuilt())
+		return !OccupancyGrid::isBlocked(x, y);
+	// no grid for this world yet: if not inside an obstacle
 	float pos[3];
 	pos[0] = x * SCALE;
 	pos[1] = y * SCALE;
@@ -73,162 +80,139 @@ bool GraphFunctionContainer::isAccessible(AStarNode& n)
 	return AStarNode::isAccessible(n.getX(), n.getY());
 }
 
-// return the neighbors of the AStarNode as a vector { NW, W, SW, N, S, NE, W, NW } in vector c
-void GraphFunctionContainer::getSuccessors(AStarNode& n, std::vector<AStarNode>* s, std::vector<double>* c) // Define a 8-connected graph
+// return the neighbors of the AStarNode { NW, W, SW, N, S, NE, W, NW } and their transition costs in span s.
+// Writes into the caller's fixed-size span and reuses the member scratch lists, so it does not allocate.
+void GraphFunctionContainer::getSuccessorSpan(AStarNode& n, SuccessorSpan<AStarNode,double>* s) // Define a 8-connected graph
 {
-	// Defining the initial transition costs
-	std::vector<double> costVector;
-	std::vector<Flag*> nearbyFlags;
-	std::vector<Player*> nearbyEnemies;
-
-	float maxAreaOfInfluence = 20.0f; // maximum area of influence (in front of tank)
-	float minAreaOfInfluence = 3.0f; // minimum area of influence (not in front of tank)
-	bool avoidBadFlags = currentStatus == OFFENSE || currentStatus == PATROL || !(player->getFlag() != NULL && player->getFlag() != Flags::Null && (player->getFlag()->flagTeam != NoTeam || player->getFlag()->flagQuality == FlagGood));
-	bool avoidEnemies = currentStatus == RETURN; //only consider enemy influence if returning flag
-	bool seekCover =  currentStatus == RETURN || currentStatus == OFFENSE;
-
-	if(avoidBadFlags)
-	for (int i = 0; i < numFlags; i++) { //get all nearby flags
-		Flag* flag = &World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag->type->flagTeam;
-		if (flagTeamColor != NoTeam && flag->status != FlagOnTank && flag->type->flagQuality == FlagQuality::FlagBad
-			&& hypotf(convertCoordinate(flag->position[0]) - n.getX(), convertCoordinate(flag->position[1]) - n.getY()) <= 3.0f) {
-			nearbyFlags.push_back(flag);
-		}
-	}
-
-	if(avoidEnemies)
-	for (int t = 0; t <= World::getWorld()->getCurMaxPlayers(); t++){ //get all nearby players
-		Player *p = 0;
-		if (t < World::getWorld()->getCurMaxPlayers())
-			p = World::getWorld()->getPlayer(t);
-		if (!p || p->getId() == player->getId() || p->getColor() == player->getColor())
-			continue;
-		float distance = hypotf((float) convertCoordinate(p->getPosition()[0]) - n.getX(), (float) convertCoordinate(p->getPosition()[1]) - n.getY());
-		if (distance < maxAreaOfInfluence + 2.0f) {
-			nearbyEnemies.push_back(p);
-		}
-	}
-
-	double multiplier = 1.0;
-	if (avoidBadFlags)
-		multiplier *= badFlagInfluence(nearbyFlags, n);
-	if (avoidEnemies)
-		multiplier *= enemyInfluence(nearbyEnemies, n, maxAreaOfInfluence, minAreaOfInfluence);
-	if(seekCover)
-		multiplier *= coverInfluence(n);
+	double multiplier = hasConstantCosts() ? 1.0 : costMultiplier(n);
 
 	// This function needn't account for obstacles or size of environment. That's done by "isAccessible"
 	AStarNode tn;
-	s->clear(); c->clear(); // Planner is supposed to clear these. Still, for safety we clear it again.
+	int k = 0;
+	s->clear(); // Planner is supposed to clear this. Still, for safety we clear it again.
 	for (int a=-1; a<=1; a++)
 		for (int b=-1; b<=1; b++) {
 			if (a==0 && b==0) continue;
 			tn.setX(n.getX() + a);
 			tn.setY(n.getY() + b);
-			s->push_back(tn);
-			if (avoidBadFlags || avoidEnemies || seekCover) {
-				double cost = hypotf(a, b);
-				cost *= multiplier;
-				costVector.push_back(cost);
-			}
+			if (hasConstantCosts())
+				s->push_back(tn, ConstCostVector[k]);
+			else
+				s->push_back(tn, hypotf(a, b) * multiplier);
+			k++;
 		}
-	if (avoidBadFlags || avoidEnemies || seekCover) {
-		*c = costVector;
-	} else {
-		*c = ConstCostVector;
-	}
+}
 
+// vector version of the above, for planners that use the runtime graph descriptor
+void GraphFunctionContainer::getSuccessors(AStarNode& n, std::vector<AStarNode>* s, std::vector<double>* c)
+{
+	SuccessorSpan<AStarNode,double> span;
+	getSuccessorSpan(n, &span);
+	s->assign(span.nodes, span.nodes + span.size());
+	c->assign(span.costs, span.costs + span.size());
 }
 
-/**
-Calculates the influence of bad flags on the weight of the path.
-A flag increases the weight of nearby nodes (at most 2 units away);
-*/
-double GraphFunctionContainer::badFlagInfluence(std::vector<Flag*> flagList, AStarNode n) {
+// product of the cost multipliers that apply for currentStatus at node n
+double GraphFunctionContainer::costMultiplier(AStarNode& n)
+{
+	int bin = getHashBin(n);
 	double multiplier = 1.0;
-	for (Flag* flag : flagList) {
-		double distance = hypotf(convertCoordinate(flag->position[0]) - n.getX(), convertCoordinate(flag->position[1]) - n.getY());
-		if ( distance <= 2.0) {
-			multiplier += 5.0 / (distance + 1.0);
-#ifdef BAD_FLAG_TRACE
-			char buffer[128];
-			sprintf(buffer, "Bad Flag Found at (%f, %f), multiplier is now at %d", n.getScaledX(), n.getScaledY(), multiplier);
-			controlPanel->addMessage(buffer);
-#endif
-		}
-	}
+	if (avoidBadFlags)
+		multiplier *= 1.0 + (*badFlagGrid)[bin];
+	if (avoidEnemies)
+		multiplier *= 1.0 + (*enemyGrid)[bin];
+	if(seekCover)
+		multiplier *= coverInfluence(n);
 	return multiplier;
 }
 
-/**
-Calculates the influence of enemies on the weight of the path.
-Greater influence in the direction that enemy is facing.
-Influence within a certain distance from tank (minAOI).
-Influence within a 45 degree angle in front of tank, up to a certain distance (maxAOI).
-*/
-double GraphFunctionContainer::enemyInfluence(std::vector<Player*> enemyList, AStarNode n, float maxAOI, float minAOI) {
-	double multiplier = 1.0;
+bool GraphFunctionContainer::lineOfSight(AStarNode& a, AStarNode& b)
+{
+	if (OccupancyGrid::isBuilt())
+		return OccupancyGrid::isLineClear(a.getX(), a.getY(), b.getX(), b.getY());
+	return abs(b.getX() - a.getX()) <= 1 && abs(b.getY() - a.getY()) <= 1;
+}
 
-	for (Player* enemy : enemyList) {
-		double distance = hypotf(convertCoordinate(enemy->getPosition()[0]) - n.getX(), convertCoordinate(enemy->getPosition()[1]) - n.getY());
-		if (distance <= minAOI) {
-			multiplier += minAOI / (distance + 1.0);
-		}
-		if (distance <= maxAOI) {
-			float direction[3] = { n.getX() - convertCoordinate(enemy->getPosition()[0]), n.getY() - convertCoordinate(enemy->getPosition()[1]), 0.0f };
-			float angleFrom = atan2(direction[1], direction[0]);
-			float enemyAngle = enemy->getAngle();
-			float angleMin = trueAngle(enemyAngle - M_PI / 16.0);
-			if (trueAngle(angleFrom - angleMin) <= M_PI / 8.0) { // if position is in front of enemy tank (45 degree angle)
-				multiplier += (maxAOI / 4.0) / (distance + 1.0);
-			}
-		}
+// costMultiplier inlined: a plan calls this for every node it relaxes, on segments that may be long
+double GraphFunctionContainer::getSegmentCost(AStarNode& a, AStarNode& b)
+{
+	int dx = b.getX() - a.getX(), dy = b.getY() - a.getY();
+	int steps = std::max(abs(dx), abs(dy));
+	if (steps == 0)
+		return 0.0;
+	double stepLength = hypotf((float)dx, (float)dy) / steps;
+	if (hasConstantCosts())
+		return stepLength * steps;
+	const double* flagValues = avoidBadFlags ? &(*badFlagGrid)[0] : NULL;
+	const double* enemyValues = avoidEnemies ? &(*enemyGrid)[0] : NULL;
+	const float* coverValues = (seekCover && coverGeneration == worldGeneration) ? &coverField[0] : NULL;
+	double multipliers = 0.0;
+	for (int i = 0; i < steps; i++) {
+		// i/steps of the way, rounded to the nearest node (halves away from a)
+		int x = a.getX() + (2 * i * dx + (dx < 0 ? -steps : steps)) / (2 * steps);
+		int y = a.getY() + (2 * i * dy + (dy < 0 ? -steps : steps)) / (2 * steps);
+		int bin = computeHashBin(x, y);
+		double multiplier = 1.0;
+		if (flagValues)
+			multiplier *= 1.0 + flagValues[bin];
+		if (enemyValues)
+			multiplier *= 1.0 + enemyValues[bin];
+		if (coverValues)
+			multiplier *= coverValues[bin];
+		multipliers += multiplier;
 	}
-	return multiplier;
+	return stepLength * multipliers;
 }
 
-/**
-Convert angle to equivalent value between 0.0 and 6.28
-*/
-float GraphFunctionContainer::trueAngle(float angle) {
-	if (angle < 0.0f) return angle + (float)(2.0 * M_PI);
-	if (angle > 2.0f * M_PI) return angle - (float)(2.0 * M_PI);
-	return angle;
+// nodes of the flags that raise costs around them, in flag order
+void GraphFunctionContainer::getCostSources(std::vector<AStarNode>& sources)
+{
+	sources = badFlags;
 }
 
 /**
-Calculates the cover value for a specific node.
-All calculated values are stored permanently into a hash map.
-Values are calculated when needed and are readily available if called a second time.
+Looks up the cover value of a node in the cover field.
+The field is computed for the whole world when it is loaded (see buildCoverField),
+so this is a single read, and planner threads can share it without locking.
+Without a field for the current world, every node gets the neutral value 1.0.
 */
-double GraphFunctionContainer::coverInfluence(AStarNode n) {
-	if (coverValues[getHashBin(n)] == 0.0)
-		coverValues[getHashBin(n)] = calculateCover(n);
-	return coverValues[getHashBin(n)];
+double GraphFunctionContainer::coverInfluence(AStarNode& n) {
+	if (coverGeneration != worldGeneration)
+		return 1.0;
+	return coverField[getHashBin(n)];
 }
 
 /**
-Calculates the relative cover a position provides.
+Calculates the relative cover node (x, y) provides.
 Values can range from 0.5 for safe cover to 1.5 for wide open areas.
+Each of the 8 directions with a building (or the world's edge) close by gives cover.
+Buildings are the nodes of the occupancy grid that are not accessible; straight directions look
+3 nodes ahead and diagonal ones 4, the reach of the rays that were cast for this before.
 */
-double GraphFunctionContainer::calculateCover(AStarNode n) {
-	double multiplier = 1.5f;
-	float distanceChecked = SCALE * 3.0f;
-
-	const float sqrt2 = sqrt(2.0f);
-	float unitDirections[][3] = { {0.0f, 1.0f, 0.0f }, {sqrt2, sqrt2, 0.0f }, { 1.0f, 0.0f, 0.0f }, { sqrt2, -sqrt2, 0.0f }, { 0.0f, -1.0f, 0.0f }, { -sqrt2, -sqrt2, 0.0f }, { -1.0f, 0.0f, 0.0f }, { -sqrt2, sqrt2, 0.0f } };
-	for (float* direction : unitDirections) {
-		float coordinates[3] = { n.getScaledX(), n.getScaledY(), 0.0f };
-		Ray coverRay(coordinates, direction);
-		if (ShotStrategy::getFirstBuilding(coverRay, -0.5f, distanceChecked) != NULL) {
-			multiplier -= .125f;
+float GraphFunctionContainer::calculateCover(int x, int y) {
+	float multiplier = 1.5f;
+	for (int a = -1; a <= 1; a++)
+		for (int b = -1; b <= 1; b++) {
+			if (a == 0 && b == 0) continue;
+			int reach = (a != 0 && b != 0) ? 4 : 3;
+			for (int k = 1; k <= reach; k++)
+				if (!AStarNode::isAccessible(x + a * k, y + b * k)) {
+					multiplier -= .125f;
+					break;
+				}
 		}
-	}
-
 	return multiplier;
 }
 
+void GraphFunctionContainer::buildCoverField(void)
+{
+	coverField.assign(getHashTableSize(), 1.0f);
+	for (int y = Ymin; y <= Ymax; y++)
+		for (int x = Xmin; x <= Xmax; x++)
+			coverField[computeHashBin(x, y)] = calculateCover(x, y);
+	coverGeneration = worldGeneration;
+}
+
 /**
 Converts an original coordinate to a scaled down version for use in the graph.
 */
@@ -236,11 +220,19 @@ int GraphFunctionContainer::convertCoordinate(float c) {
 	return (c > 0.0) ? (int)floor(c / SCALE + 0.5f) : (int)ceil(c / SCALE - 0.5f);
 }
 
-// returns the Euclidean distance of the AStarNode to the goalNode
+// returns the Euclidean distance of the AStarNode to the goalNode, or the larger bound the landmarks
+// give around buildings (see Landmarks). The landmark bound is scaled by the smallest cost multiplier
+// of the profile, so it never exceeds the cost of a path. The Euclidean distance is not: with cover
+// (OFFENSE and RETURN, multipliers down to 0.5) it may overestimate up to 2 times, and those plans
+// trade optimality for fewer expansions. Both are distances on the grid, which any-angle paths may
+// undercut by up to 8%.
 double GraphFunctionContainer::getHeuristics(AStarNode& n1, AStarNode& n2)
 {
 	// Start with Euclidean distance
-	return hypot((double) n2.getX() - n1.getX(), (double) n2.getY() - n1.getY());
+	double distance = hypot((double) n2.getX() - n1.getX(), (double) n2.getY() - n1.getY());
+	if (useLandmarks)
+		distance = std::max(distance, landmarkScale * Landmarks::lowerBound(n1.getX(), n1.getY(), n2.getX(), n2.getY()));
+	return distance;
 }
 
 // -------------------------------
@@ -248,17 +240,108 @@ double GraphFunctionContainer::getHeuristics(AStarNode& n1, AStarNode& n2)
 GraphFunctionContainer::GraphFunctionContainer (float worldSize, int currentStatus, Player* player)
 { 
 	int size = (int)worldSize/SCALE/2;
-	Xmin = -size; Xmax = size; Ymin = -size; Ymax = size;
+	if (Xmax != size) // normally set already when the world was loaded
+		setWorldSize(worldSize);
 	this->currentStatus = currentStatus;
-	this->player = player;
+	useLandmarks = Landmarks::isBuilt();
+	avoidBadFlags = currentStatus == OFFENSE || currentStatus == PATROL || !(player->getFlag() != NULL && player->getFlag() != Flags::Null && (player->getFlag()->flagTeam != NoTeam || player->getFlag()->flagQuality == FlagGood));
+	avoidEnemies = currentStatus == RETURN; //only consider enemy influence if returning flag
+	seekCover =  currentStatus == RETURN || currentStatus == OFFENSE;
+	landmarkScale = seekCover ? 0.5 : 1.0; // flags and enemies only raise costs, cover lowers them to 0.5 (see calculateCover)
+
+	if (avoidBadFlags) {
+		std::vector<InfluenceMap::Source> flags;
+		badFlagGrid = InfluenceMap::getBadFlagGrid(flags);
+		for (int i = 0; i < (int)flags.size(); i++) {
+			badFlags.push_back(AStarNode(flags[i].x, flags[i].y));
+#ifdef BAD_FLAG_TRACE
+			char buffer[128];
+			sprintf(buffer, "Bad Flag Found at (%f, %f), avoiding it", badFlags.back().getScaledX(), badFlags.back().getScaledY());
+			controlPanel->addMessage(buffer);
+#endif
+		}
+	}
+
+	if (avoidEnemies)
+		enemyGrid = InfluenceMap::getEnemyGrid(player->getColor());
 
 	// Defining the fixed transition costs
 	double SQRT2 = sqrt(2.0);
-	ConstCostVector.push_back(SQRT2); ConstCostVector.push_back(1.0);
-	ConstCostVector.push_back(SQRT2); ConstCostVector.push_back(1.0);
-	ConstCostVector.push_back(1.0); ConstCostVector.push_back(SQRT2);
-	ConstCostVector.push_back(1.0); ConstCostVector.push_back(SQRT2);
+	ConstCostVector[0] = SQRT2; ConstCostVector[1] = 1.0;
+	ConstCostVector[2] = SQRT2; ConstCostVector[3] = 1.0;
+	ConstCostVector[4] = 1.0; ConstCostVector[5] = SQRT2;
+	ConstCostVector[6] = 1.0; ConstCostVector[7] = SQRT2;
+
+}
+
+void GraphFunctionContainer::setWorldSize(float worldSize)
+{
+	int size = (int)worldSize/SCALE/2;
+	Xmin = -size; Xmax = size; Ymin = -size; Ymax = size;
+}
+
+std::vector<float> GraphFunctionContainer::coverField;
+int GraphFunctionContainer::coverGeneration = -1;
+int GraphFunctionContainer::worldGeneration = 0;
+
+void GraphFunctionContainer::worldChanged(void)
+{
+	worldGeneration++;
+}
+
+// -------------------------------
+// fixed-point graph
+
+bool FixedCostGraphFunctionContainer::isAccessible(AStarNode& n)
+{
+	return AStarNode::isAccessible(n.getX(), n.getY());
+}
 
+// same neighbour order as GraphFunctionContainer::getSuccessorSpan
+void FixedCostGraphFunctionContainer::getSuccessorSpan(AStarNode& n, SuccessorSpan<AStarNode,int>* s)
+{
+	AStarNode tn;
+	int k = 0;
+	s->clear();
+	for (int a=-1; a<=1; a++)
+		for (int b=-1; b<=1; b++) {
+			if (a==0 && b==0) continue;
+			tn.setX(n.getX() + a);
+			tn.setY(n.getY() + b);
+			s->push_back(tn, ConstCostVector[k++]);
+		}
 }
 
-std::unordered_map <int, double> GraphFunctionContainer::coverValues;
+void FixedCostGraphFunctionContainer::getSuccessors(AStarNode& n, std::vector<AStarNode>* s, std::vector<int>* c)
+{
+	SuccessorSpan<AStarNode,int> span;
+	getSuccessorSpan(n, &span);
+	s->assign(span.nodes, span.nodes + span.size());
+	c->assign(span.costs, span.costs + span.size());
+}
+
+// Euclidean distance, rounded down
+int FixedCostGraphFunctionContainer::getHeuristics(AStarNode& n1, AStarNode& n2)
+{
+	return (int)floor(FIXED_COST_SCALE * hypot((double) n2.getX() - n1.getX(), (double) n2.getY() - n1.getY()));
+}
+
+FixedCostGraphFunctionContainer::FixedCostGraphFunctionContainer(void)
+{
+	// Defining the fixed transition costs, diagonals rounded up
+	int SQRT2 = (int)ceil(FIXED_COST_SCALE * sqrt(2.0));
+	ConstCostVector[0] = SQRT2; ConstCostVector[1] = FIXED_COST_SCALE;
+	ConstCostVector[2] = SQRT2; ConstCostVector[3] = FIXED_COST_SCALE;
+	ConstCostVector[4] = FIXED_COST_SCALE; ConstCostVector[5] = SQRT2;
+	ConstCostVector[6] = FIXED_COST_SCALE; ConstCostVector[7] = SQRT2;
+}
+
+JPS_jump_distances FixedCostGraphFunctionContainer::jumpDistances;
+int FixedCostGraphFunctionContainer::jumpGeneration = -1;
+
+void FixedCostGraphFunctionContainer::buildJumpDistances(void)
+{
+	jumpDistances.build(GraphFunctionContainer::Xmin, GraphFunctionContainer::Ymin,
+		GraphFunctionContainer::Xmax, GraphFunctionContainer::Ymax, AStarNode::isAccessible);
+	jumpGeneration = GraphFunctionContainer::getWorldGeneration();
+}
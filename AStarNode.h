@@ -6,9 +6,14 @@
 // YAGSBPL libraries
 #include "yagsbpl_base.h"
 #include "planners/A_star.h"
+#include "planners/JPS.h"
+#include "planners/D_star_lite.h"
+#include "planners/Lazy_theta_star.h"
 
 #include "BZDBCache.h"
-#include <unordered_map>
+#include "InfluenceMap.h"
+#include <vector>
+#include <memory>
 
 #define SCALE	BZDBCache::tankRadius
 #define UNDEFINED 0
@@ -49,38 +54,506 @@ class GraphFunctionContainer : public SearchGraphDescriptorFunctionContainer<ASt
 {
 public:
 
-	int getHashBin(AStarNode& n);
+	int getHashBin(AStarNode& n) { return computeHashBin(n.getX(), n.getY()); }
 
 	bool isAccessible(AStarNode& n);
 
 	void getSuccessors(AStarNode& n, std::vector<AStarNode>* s, std::vector<double>* c); // Define a 8-connected graph
+	void getSuccessorSpan(AStarNode& n, SuccessorSpan<AStarNode,double>* s); // same, allocation-free
 
 	double getHeuristics(AStarNode& n1, AStarNode& n2);
 
 	static int convertCoordinate(float c);
 
+	static int getHashTableSize(void); // number of bins used by getHashBin, including the one-node border outside the world
+	static int computeHashBin(int x, int y)
+		{ return ((y + abs(Ymin) + 1) * ((abs(Xmin) * 2) + 3)) + (x + abs(Xmin) + 1); }
+
+	bool hasConstantCosts(void) const { return !(avoidBadFlags || avoidEnemies || seekCover); } // true if no cost multipliers apply
+	double getCostMultiplier(AStarNode& n) { return hasConstantCosts() ? 1.0 : costMultiplier(n); } // of the steps leaving n
+
+	// For any-angle planners (LazyThetaStar_planner): true if a tank can drive straight from a to b, as
+	// RobotPlayer::pathIsClear decides on the occupancy grid (only neighbours are in sight before it is built)
+	bool lineOfSight(AStarNode& a, AStarNode& b);
+	// cost of driving straight from a to b: the line is cut into as many equal steps as it crosses rows or
+	// columns, each costing its length times the multiplier at the node nearest to where it starts.
+	// The step cost of getSuccessorSpan for neighbours.
+	double getSegmentCost(AStarNode& a, AStarNode& b);
+
+	// For incremental planners: as long as the cost profile stays the same, costs only change around the cost
+	// sources (bad flags), at nodes at most costSourceRadius away. Not trackable if enemies are avoided.
+	bool hasTrackableCosts(void) const { return !avoidEnemies; }
+	int getCostProfile(void) const { return (avoidBadFlags ? 1 : 0) | (seekCover ? 2 : 0); }
+	void getCostSources(std::vector<AStarNode>& sources);
+	static const int costSourceRadius = 2;
+
 	// -------------------------------
 	// constructors
+	// Takes the grids of the costs that flags and players raise from InfluenceMap (and the positions of the
+	// bad flags), so that planning afterwards only reads static world data and can run on a planner thread
+	// (see PlannerService). Call from the game thread.
 	GraphFunctionContainer (float worldSize, int currentStatus, Player* player);
 
-	static int Xmin, Xmax, Ymin, Ymax; // world size
+	// World size. Only written by setWorldSize when a world is loaded, while no plan runs.
+	static int Xmin, Xmax, Ymin, Ymax;
+	static void setWorldSize(float worldSize); // sets Xmin.. for a world of the given size
+
+	static void worldChanged(void); // call when a new world is loaded; drops everything cached for the old one
+	static int getWorldGeneration(void) { return worldGeneration; }
+	// Computes the cover of every node of the current world, after OccupancyGrid::build
+	static void buildCoverField(void);
 
 private:
 
-	double badFlagInfluence(std::vector<Flag*> flagList, AStarNode n);
-	double enemyInfluence(std::vector<Player*> enemyList, AStarNode n, float maxAOI, float minAOI);
-	double coverInfluence(AStarNode n);
-	float trueAngle(float angle);
-	double calculateCover(AStarNode n);
+	double costMultiplier(AStarNode& n);
+	double coverInfluence(AStarNode& n);
+	static float calculateCover(int x, int y);
 
 	int currentStatus;
-	Player* player;
-	static std::unordered_map <int, double> coverValues;
-	// fixed transition costs vector
-	std::vector<double> ConstCostVector;
+	bool avoidBadFlags, avoidEnemies, seekCover; // which cost multipliers apply for currentStatus
+	bool useLandmarks; // Landmarks were built for the current world when constructed
+	double landmarkScale; // smallest cost multiplier for currentStatus, applied to the landmark bound
+	std::vector<AStarNode> badFlags; // on badFlagGrid
+	std::shared_ptr<const InfluenceMap::Grid> badFlagGrid, enemyGrid; // taken by the constructor, if they apply
+	static std::vector<float> coverField; // by hash bin, written by buildCoverField only
+	static int coverGeneration; // world the cover field was built for
+	static int worldGeneration; // incremented by worldChanged()
+	// fixed transition costs, in getSuccessorSpan order
+	double ConstCostVector[8];
+
+
+
+};
+
+// ============================================================
+// Fixed-point version of the graph for plans where GraphFunctionContainer::hasConstantCosts().
+// Costs are integers in units of 1/FIXED_COST_SCALE, so A_star_planner<AStarNode,int> picks the radix heap.
+// Diagonal costs are rounded up and heuristics down, which keeps the heuristic consistent (the radix heap needs monotone keys).
+// Uses the world bounds set up by GraphFunctionContainer::setWorldSize.
+
+#define FIXED_COST_SCALE 1000
+
+class FixedCostGraphFunctionContainer : public SearchGraphDescriptorFunctionContainer<AStarNode,int>
+{
+public:
+
+	int getHashBin(AStarNode& n) { return GraphFunctionContainer::computeHashBin(n.getX(), n.getY()); }
+
+	bool isAccessible(AStarNode& n);
+
+	void getSuccessors(AStarNode& n, std::vector<AStarNode>* s, std::vector<int>* c); // Define a 8-connected graph
+	void getSuccessorSpan(AStarNode& n, SuccessorSpan<AStarNode,int>* s); // same, allocation-free
+
+	int getHeuristics(AStarNode& n1, AStarNode& n2);
+
+	int getStraightCost(void) const { return ConstCostVector[1]; }
+	int getDiagonalCost(void) const { return ConstCostVector[0]; }
+
+	// Jump distances of the accessible nodes for PersistentJPSPlanner, computed for the whole world when it is
+	// loaded (after OccupancyGrid::build), so that a jump does not scan the grid. NULL until built for the current world.
+	static void buildJumpDistances(void);
+	static const JPS_jump_distances* getJumpDistances(void) { return jumpGeneration == GraphFunctionContainer::getWorldGeneration() ? &jumpDistances : NULL; }
+
+	// -------------------------------
+	// constructors
+	FixedCostGraphFunctionContainer (void);
+
+private:
+
+	int ConstCostVector[8]; // in getSuccessorSpan order
+	static JPS_jump_distances jumpDistances; // written by buildJumpDistances only
+	static int jumpGeneration; // world the jump distances were built for
+};
+
+// ============================================================
+// An A* planner that lives as long as its owner (e.g. a robot) instead of one plan.
+// Between plans only the search state is reset, in O(1) (see HashTableContainer::newGeneration);
+// the node table and the successor links found by earlier plans are kept until the world changes.
+// GraphClass is bound at compile time (StaticSearchGraphDescriptor), so the planner calls its
+// functions directly instead of through the virtual SearchGraphDescriptorFunctionContainer interface.
+
+template <class CostType, class GraphClass>
+class PersistentAStarPlanner
+{
+public:
+	typedef StaticSearchGraphDescriptor<AStarNode,CostType,GraphClass> GraphDescriptor;
+	typedef A_star_planner<AStarNode,CostType,
+		typename DefaultOpenList< AStarNode, CostType, A_star_variables<CostType> >::type, GraphDescriptor> Planner;
+
+	PersistentAStarPlanner(void) : planner(NULL), worldGeneration(-1) {}
+	~PersistentAStarPlanner(void) { delete planner; }
+
+	// Plan from startNode to goalNode on graph. Set constantCosts if graph returns the same transition costs
+	// for every plan; otherwise cached successors get their costs re-queried.
+	std::vector< std::vector< AStarNode > > plan(GraphClass* graph,
+		AStarNode& startNode, AStarNode& goalNode, bool constantCosts);
+
+private:
+	PersistentAStarPlanner(const PersistentAStarPlanner&);
+	PersistentAStarPlanner& operator=(const PersistentAStarPlanner&);
+
+	Planner* planner;
+	int worldGeneration; // world the planner's node table was built for
+};
+
+template <class CostType, class GraphClass>
+std::vector< std::vector< AStarNode > > PersistentAStarPlanner<CostType,GraphClass>::plan(GraphClass* graph,
+	AStarNode& startNode, AStarNode& goalNode, bool constantCosts)
+{
+	GraphDescriptor AStarGraph;
+	AStarGraph.graph = graph;
+	// Set other variables
+	AStarGraph.hashTableSize = GraphFunctionContainer::getHashTableSize(); //amount of Nodes in graph plus the border around it
+	AStarGraph.hashBinSizeIncreaseStep = 1; //hash function guarantees unique values
+	AStarGraph.perfectHash = true; // so the planner uses a flat node table indexed by hash bin
+	AStarGraph.cacheSuccessorCosts = constantCosts;
+	AStarGraph.SeedNode = startNode; // Start node
+	AStarGraph.TargetNode = goalNode; // Goal node
+
+	if (!planner || worldGeneration != GraphFunctionContainer::getWorldGeneration()
+		|| planner->hash->hashTableSize != AStarGraph.hashTableSize) {
+		delete planner;
+		planner = new Planner;
+		planner->setParams(1.0, 10); // optional.
+		planner->setNodePooling(); // nodes and successor links are freed in one go with the planner
+		planner->init(&AStarGraph);
+		worldGeneration = GraphFunctionContainer::getWorldGeneration();
+	}
+	else {
+		planner->clearLastPlanAndInit(&AStarGraph);
+	}
+	planner->plan();
+	return planner->getPlannedPaths();
+}
+
+// ============================================================
+// Time-sliced, anytime counterpart of PersistentAStarPlanner, for plans too expensive to finish in one frame.
+// start() runs a first slice of an ARA* search (see A_star_planner::setAnytime) and every resume() one more,
+// each limited to expansionsPerSlice expansions. The first path found costs at most subopEps times the
+// optimum; later ones tighten the bound down to the optimal path. The planner keeps its own copy of the
+// graph, since a plan outlives the call that started it. Only used when the robots plan in the game
+// thread (PLANNER_THREADS 0): on a planner thread a plan runs to the end at once, off the frame.
+
+#define A_STAR_SLICE_EXPANSIONS 1500 // expansions per frame of a sliced plan
+#define A_STAR_ANYTIME_EPS 2.5 // heuristic inflation of the first search of a sliced plan
+#define A_STAR_ANYTIME_EPS_STEP 0.5 // inflation dropped by each following search
+
+template <class CostType, class GraphClass>
+class SlicedAStarPlanner
+{
+public:
+	typedef StaticSearchGraphDescriptor<AStarNode,CostType,GraphClass> GraphDescriptor;
+	typedef A_star_planner<AStarNode,CostType,DaryHeapContainer< AStarNode, CostType, A_star_variables<CostType> >,
+		GraphDescriptor> Planner; // anytime searches lower keys, so not the radix heap
+
+	SlicedAStarPlanner(void) : planner(NULL), worldGeneration(-1), planning(false), newPaths(false) {}
+	~SlicedAStarPlanner(void) { delete planner; }
+
+	// Starts a plan from startNode to goalNode on a copy of graph, dropping the one in progress
+	void start(const GraphClass& graph, AStarNode& startNode, AStarNode& goalNode,
+		int expansionsPerSlice, double subopEps);
+	void resume(void); // runs the next slice, if the plan is not complete
+	void cancel(void) { planning = false; newPaths = false; }
+
+	bool isPlanning(void) const { return planning; } // true until the optimal path is found or the search fails
+	const AStarNode& getGoal(void) const { return goalNode; }
+	// true if a slice found a better path than the last one taken
+	bool hasNewPaths(void) const { return newPaths; }
+	std::vector< std::vector< AStarNode > > takePaths(void);
+	double getSolutionEps(void) const { return planner ? planner->getSolutionEps() : 0.0; }
+
+private:
+	SlicedAStarPlanner(const SlicedAStarPlanner&);
+	SlicedAStarPlanner& operator=(const SlicedAStarPlanner&);
+
+	void runSlice(void);
 
+	Planner* planner;
+	std::unique_ptr<GraphClass> graph; // the planner's copy of the graph
+	int worldGeneration; // world the planner's node table was built for
+	AStarNode goalNode;
+	bool planning, newPaths;
+	double pathEps; // solution bound of the paths last found
+};
+
+template <class CostType, class GraphClass>
+void SlicedAStarPlanner<CostType,GraphClass>::start(const GraphClass& g,
+	AStarNode& startNode, AStarNode& goal, int expansionsPerSlice, double subopEps)
+{
+	graph.reset(new GraphClass(g));
+
+	GraphDescriptor AStarGraph;
+	AStarGraph.graph = graph.get();
+	AStarGraph.hashTableSize = GraphFunctionContainer::getHashTableSize(); //amount of Nodes in graph plus the border around it
+	AStarGraph.hashBinSizeIncreaseStep = 1; //hash function guarantees unique values
+	AStarGraph.perfectHash = true;
+	AStarGraph.cacheSuccessorCosts = false; // the node table outlives the graph of one plan
+	AStarGraph.SeedNode = startNode; // Start node
+	AStarGraph.TargetNode = goal; // Goal node
+
+	if (!planner || worldGeneration != GraphFunctionContainer::getWorldGeneration()
+		|| planner->hash->hashTableSize != AStarGraph.hashTableSize) {
+		delete planner;
+		planner = new Planner;
+		planner->setParams(subopEps, 10);
+		planner->setNodePooling();
+		planner->setAnytime(true, A_STAR_ANYTIME_EPS_STEP);
+		planner->setPlanningBudget(expansionsPerSlice);
+		planner->init(&AStarGraph);
+		worldGeneration = GraphFunctionContainer::getWorldGeneration();
+	}
+	else {
+		planner->setParams(subopEps, 10);
+		planner->setPlanningBudget(expansionsPerSlice);
+		planner->clearLastPlanAndInit(&AStarGraph);
+	}
+	goalNode = goal;
+	planning = true;
+	newPaths = false;
+	pathEps = 0.0;
+	runSlice();
+}
+
+template <class CostType, class GraphClass>
+void SlicedAStarPlanner<CostType,GraphClass>::resume(void)
+{
+	if (!planning)
+		return;
+	if (worldGeneration != GraphFunctionContainer::getWorldGeneration()) {
+		cancel(); // the node table belongs to a world that is gone
+		return;
+	}
+	runSlice();
+}
+
+template <class CostType, class GraphClass>
+void SlicedAStarPlanner<CostType,GraphClass>::runSlice(void)
+{
+	planner->plan();
+	if (planner->getSolutionEps() > 0.0 && planner->getSolutionEps() != pathEps) {
+		pathEps = planner->getSolutionEps();
+		newPaths = true;
+	}
+	if (planner->isPlanComplete())
+		planning = false;
+}
+
+template <class CostType, class GraphClass>
+std::vector< std::vector< AStarNode > > SlicedAStarPlanner<CostType,GraphClass>::takePaths(void)
+{
+	newPaths = false;
+	if (!planner || pathEps == 0.0)
+		return std::vector< std::vector< AStarNode > >();
+	return planner->getPlannedPaths();
+}
+
+// ============================================================
+// Jump point search counterpart of PersistentAStarPlanner, for graphs whose transition costs are only
+// a straight and a diagonal step cost (e.g. FixedCostGraphFunctionContainer). Paths have the same cost
+// as A* on that graph and list every node, so they can be smoothed the same way.
+// Jumps use the graph's precomputed jump distances (GraphClass::getJumpDistances) when there are any.
+
+template <class CostType, class GraphClass>
+class PersistentJPSPlanner
+{
+public:
+	typedef StaticSearchGraphDescriptor<AStarNode,CostType,GraphClass> GraphDescriptor;
+	typedef JPS_planner<AStarNode,CostType,GraphClass> Planner;
 
+	PersistentJPSPlanner(void) : planner(NULL), worldGeneration(-1) {}
+	~PersistentJPSPlanner(void) { delete planner; }
 
+	std::vector< std::vector< AStarNode > > plan(GraphClass* graph,
+		AStarNode& startNode, AStarNode& goalNode, CostType straightCost, CostType diagonalCost);
+	int getExpansionCount(void) const { return planner ? planner->expandcount : 0; } // by the last plan, in jump points
+
+private:
+	PersistentJPSPlanner(const PersistentJPSPlanner&);
+	PersistentJPSPlanner& operator=(const PersistentJPSPlanner&);
+
+	Planner* planner;
+	int worldGeneration; // world the planner's node table and accessibility cache were built for
 };
 
+template <class CostType, class GraphClass>
+std::vector< std::vector< AStarNode > > PersistentJPSPlanner<CostType,GraphClass>::plan(GraphClass* graph,
+	AStarNode& startNode, AStarNode& goalNode, CostType straightCost, CostType diagonalCost)
+{
+	GraphDescriptor JPSGraph;
+	JPSGraph.graph = graph;
+	JPSGraph.hashTableSize = GraphFunctionContainer::getHashTableSize(); //amount of Nodes in graph plus the border around it
+	JPSGraph.hashBinSizeIncreaseStep = 1; //hash function guarantees unique values
+	JPSGraph.perfectHash = true;
+	JPSGraph.SeedNode = startNode; // Start node
+	JPSGraph.TargetNode = goalNode; // Goal node
+
+	if (!planner || worldGeneration != GraphFunctionContainer::getWorldGeneration()
+		|| planner->hash->hashTableSize != JPSGraph.hashTableSize) {
+		delete planner;
+		planner = new Planner;
+		planner->setParams(straightCost, diagonalCost, 10);
+		planner->setNodePooling();
+		planner->init(&JPSGraph);
+		worldGeneration = GraphFunctionContainer::getWorldGeneration();
+	}
+	else {
+		planner->setParams(straightCost, diagonalCost, 10);
+		planner->clearLastPlanAndInit(&JPSGraph);
+	}
+	planner->setJumpDistances(GraphClass::getJumpDistances());
+	planner->plan();
+	return planner->getPlannedPaths();
+}
+
+// ============================================================
+// Any-angle counterpart of PersistentAStarPlanner, using Lazy Theta*. Paths go straight between the nodes
+// where they turn, wherever the graph's lineOfSight allows, so they need no smoothing afterwards; the
+// lines of sight are only checked for the nodes the search expands.
+// Only plannerbench uses it: the robots' grid paths are short and smoothed cheaply, so the lines of sight
+// cost more than they save (about 1.7x slower than A* with smoothing), and its paths cost up to 1.22
+// times the grid A* path with the RETURN profile. Lazy Theta* is not optimal: on maze maps a path
+// may cost more than the optimal grid path, by up to LAZY_THETA_COST_BOUND (plannerbench --check).
+
+#define LAZY_THETA_COST_BOUND 1.07 // most a path costs without cover, in times the optimal grid path
+
+template <class CostType, class GraphClass>
+class PersistentLazyThetaStarPlanner
+{
+public:
+	typedef StaticSearchGraphDescriptor<AStarNode,CostType,GraphClass> GraphDescriptor;
+	typedef LazyThetaStar_planner<AStarNode,CostType,GraphClass> Planner;
+
+	PersistentLazyThetaStarPlanner(void) : planner(NULL), worldGeneration(-1) {}
+	~PersistentLazyThetaStarPlanner(void) { delete planner; }
+
+	std::vector< std::vector< AStarNode > > plan(GraphClass* graph, AStarNode& startNode, AStarNode& goalNode);
+	int getExpansionCount(void) const { return planner ? planner->expandcount : 0; } // by the last plan
+
+private:
+	PersistentLazyThetaStarPlanner(const PersistentLazyThetaStarPlanner&);
+	PersistentLazyThetaStarPlanner& operator=(const PersistentLazyThetaStarPlanner&);
+
+	Planner* planner;
+	int worldGeneration; // world the planner's node table was built for
+};
+
+template <class CostType, class GraphClass>
+std::vector< std::vector< AStarNode > > PersistentLazyThetaStarPlanner<CostType,GraphClass>::plan(GraphClass* graph,
+	AStarNode& startNode, AStarNode& goalNode)
+{
+	GraphDescriptor ThetaGraph;
+	ThetaGraph.graph = graph;
+	ThetaGraph.hashTableSize = GraphFunctionContainer::getHashTableSize(); //amount of Nodes in graph plus the border around it
+	ThetaGraph.hashBinSizeIncreaseStep = 1; //hash function guarantees unique values
+	ThetaGraph.perfectHash = true;
+	ThetaGraph.SeedNode = startNode; // Start node
+	ThetaGraph.TargetNode = goalNode; // Goal node
+
+	if (!planner || worldGeneration != GraphFunctionContainer::getWorldGeneration()
+		|| planner->hash->hashTableSize != ThetaGraph.hashTableSize) {
+		delete planner;
+		planner = new Planner;
+		planner->setParams(1.0, 10);
+		planner->setNodePooling();
+		planner->init(&ThetaGraph);
+		worldGeneration = GraphFunctionContainer::getWorldGeneration();
+	}
+	else {
+		planner->clearLastPlanAndInit(&ThetaGraph);
+	}
+	planner->plan();
+	return planner->getPlannedPaths();
+}
+
+// ============================================================
+// Incremental counterpart of PersistentAStarPlanner for goals that move (a player or a flag), using
+// D* Lite. Each plan repairs the previous one: the start moving along the previous path, the goal moving
+// and costs changing around moved cost sources only re-search what changed. It starts over when the world,
+// the cost profile or the graph's size changes, or when the start left the previous search tree.
+// GraphClass must have trackable costs (see GraphFunctionContainer::hasTrackableCosts).
+// Moving the start re-roots the search at it, which drops the part of the tree that is not below the
+// new start, so a repair still expands 30 to 90 percent of the nodes A* expands. With moving queries
+// (plannerbench, sizes 800 to 1600) it makes 0.95 to 1.7 times the plans/sec of A* on city maps and 1.0 to 1.3 times
+// on maze maps, but only 0.85 to 1.0 times on open maps below size 1600, where A* hardly expands any
+// node off the path: RobotPlayer only uses it from D_STAR_LITE_MIN_BLOCKED.
+
+#define D_STAR_LITE_MIN_BLOCKED 0.05f // share of the world's nodes in buildings from which D* Lite repairs plans
+
+template <class CostType, class GraphClass>
+class PersistentDStarLitePlanner
+{
+public:
+	typedef StaticSearchGraphDescriptor<AStarNode,CostType,GraphClass> GraphDescriptor;
+	typedef D_star_lite_planner<AStarNode,CostType,GraphClass> Planner;
+
+	PersistentDStarLitePlanner(void) : planner(NULL), worldGeneration(-1), costProfile(-1) {}
+	~PersistentDStarLitePlanner(void) { delete planner; }
+
+	std::vector< std::vector< AStarNode > > plan(GraphClass* graph, AStarNode& startNode, AStarNode& goalNode);
+	int getExpansionCount(void) const { return planner ? planner->expandcount : 0; } // by the last plan
+
+private:
+	PersistentDStarLitePlanner(const PersistentDStarLitePlanner&);
+	PersistentDStarLitePlanner& operator=(const PersistentDStarLitePlanner&);
+
+	void updateCostsAround(const AStarNode& source);
+
+	Planner* planner;
+	int worldGeneration; // world the planner's search tree was built for
+	int costProfile; // cost profile of the graph the search tree was built with
+	std::vector<AStarNode> costSources; // cost sources when the search tree was last updated
+	std::vector<AStarNode> newCostSources;
+};
+
+template <class CostType, class GraphClass>
+std::vector< std::vector< AStarNode > > PersistentDStarLitePlanner<CostType,GraphClass>::plan(GraphClass* graph,
+	AStarNode& startNode, AStarNode& goalNode)
+{
+	GraphDescriptor DStarGraph;
+	DStarGraph.graph = graph;
+	DStarGraph.hashTableSize = GraphFunctionContainer::getHashTableSize(); //amount of Nodes in graph plus the border around it
+	DStarGraph.hashBinSizeIncreaseStep = 1; //hash function guarantees unique values
+	DStarGraph.perfectHash = true;
+	DStarGraph.SeedNode = startNode; // Start node
+	DStarGraph.TargetNode = goalNode; // Goal node
+
+	graph->getCostSources(newCostSources);
+	if (!planner || worldGeneration != GraphFunctionContainer::getWorldGeneration()
+		|| planner->hash->hashTableSize != DStarGraph.hashTableSize) {
+		delete planner;
+		planner = new Planner;
+		planner->setNodePooling();
+		planner->init(&DStarGraph);
+		worldGeneration = GraphFunctionContainer::getWorldGeneration();
+	}
+	else {
+		planner->GraphDescriptor->graph = graph; // the graph object only lives for this plan
+		if (costProfile != graph->getCostProfile() || !planner->moveSeed(startNode))
+			planner->clearLastPlanAndInit(&DStarGraph);
+		else {
+			planner->moveTarget(goalNode);
+			if (newCostSources != costSources) {
+				for (int i = 0; i < (int)costSources.size(); i++)
+					updateCostsAround(costSources[i]);
+				for (int i = 0; i < (int)newCostSources.size(); i++)
+					updateCostsAround(newCostSources[i]);
+			}
+		}
+	}
+	costProfile = graph->getCostProfile();
+	costSources.swap(newCostSources);
+	planner->plan();
+	return planner->getPlannedPaths();
+}
+
+template <class CostType, class GraphClass>
+void PersistentDStarLitePlanner<CostType,GraphClass>::updateCostsAround(const AStarNode& source)
+{
+	for (int y = source.getY() - GraphClass::costSourceRadius; y <= source.getY() + GraphClass::costSourceRadius; y++)
+		for (int x = source.getX() - GraphClass::costSourceRadius; x <= source.getX() + GraphClass::costSourceRadius; x++)
+			if (x >= GraphFunctionContainer::Xmin && x <= GraphFunctionContainer::Xmax
+				&& y >= GraphFunctionContainer::Ymin && y <= GraphFunctionContainer::Ymax)
+				planner->updateNodeCosts(AStarNode(x, y));
+}
+
 #endif // BZF_ASTARNODE_H
\ No newline at end of file
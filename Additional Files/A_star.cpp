@@ -27,13 +27,13 @@
 #include "playing.h"
 
 
-template <class NodeType, class CostType>
-void A_star_planner<NodeType,CostType>::init( GenericSearchGraphDescriptor<NodeType,CostType>* theEnv_p, bool createHashAndHeap )
+template <class NodeType, class CostType, class OpenListType, class GraphDescriptorType>
+void A_star_planner<NodeType,CostType,OpenListType,GraphDescriptorType>::init( GraphDescriptorType* theEnv_p, bool createHashAndHeap )
 {
 	GraphNode_p thisGraphNode;
 	
 	if (theEnv_p && createHashAndHeap)
-		GenericPlannerInstance.init(*theEnv_p, heapKeyCount);  // This initiates the graph, hash and heap of the generic planner
+		GenericPlannerInstance.init(*theEnv_p, heapKeyCount, useNodePool);  // This initiates the graph, hash and heap of the generic planner
 	else if (theEnv_p)
 	    *GenericPlannerInstance.GraphDescriptor = *theEnv_p;
 	
@@ -46,6 +46,9 @@ void A_star_planner<NodeType,CostType>::init( GenericSearchGraphDescriptor<NodeT
 	GraphDescriptor->init();
 	heap->clear();
 	bookmarkGraphNodes.clear();
+	searchEps = subopEps;
+	solutionEps = 0.0;
+	planComplete = false;
 
 	for (int a=0; a<GraphDescriptor->SeedNodes.size(); a++)
 	{
@@ -53,13 +56,14 @@ void A_star_planner<NodeType,CostType>::init( GenericSearchGraphDescriptor<NodeT
 		thisGraphNode = hash->getNodeInHash( GraphDescriptor->SeedNodes[a] );
 		
 		// If node was created, initialize it
-		if ( !thisGraphNode->initiated )
+		if ( !hash->nodeInitiated(thisGraphNode) )
 		{
 			thisGraphNode->f = _heapFun(thisGraphNode->n, (CostType)0.0, GraphDescriptor->_getHeuristicsToTarget( thisGraphNode->n ), a);
 			thisGraphNode->came_from = NULL;
 			thisGraphNode->plannerVars.seedLineage = a;
 			thisGraphNode->plannerVars.g = (CostType)0.0;
 			thisGraphNode->plannerVars.expanded = false;
+			thisGraphNode->plannerVars.inconsistent = false;
 			
 			if ( !GraphDescriptor->_isAccessible( thisGraphNode->n ) )
 			{
@@ -70,7 +74,7 @@ void A_star_planner<NodeType,CostType>::init( GenericSearchGraphDescriptor<NodeT
 			else
 				thisGraphNode->plannerVars.accessible = true;
 				
-			thisGraphNode->initiated = true; // Always set this when other variables have already been set
+			hash->markInitiated(thisGraphNode); // Always set this when other variables have already been set
 		}
 		
 		// Push in heap
@@ -80,18 +84,13 @@ void A_star_planner<NodeType,CostType>::init( GenericSearchGraphDescriptor<NodeT
 
 // -----------------------------
 
-template <class NodeType, class CostType>
-void A_star_planner<NodeType,CostType>::clearLastPlanAndInit( GenericSearchGraphDescriptor<NodeType,CostType>* theEnv_p )
+template <class NodeType, class CostType, class OpenListType, class GraphDescriptorType>
+void A_star_planner<NodeType,CostType,OpenListType,GraphDescriptorType>::clearLastPlanAndInit( GraphDescriptorType* theEnv_p )
 {
 	        
-	// Set every node in hash to not expanded  
-	if (hash && hash->HashTable) {
-		for (int a=0; a<hash->hashTableSize; a++)
-			for (int b=0; b<hash->HashTable[a].size(); b++)
-			{
-				hash->HashTable[a][b]->plannerVars.expanded = false;
-				hash->HashTable[a][b]->initiated = false;
-			}
+	// Set every node in hash to not initiated (and so not expanded) in O(1)
+	if (hash && (hash->HashTable || hash->isDense())) {
+		hash->newGeneration();
 	    // Clear the last plan, but not the hash table
 	    if (theEnv_p)
 		    init(theEnv_p, false);
@@ -108,25 +107,67 @@ void A_star_planner<NodeType,CostType>::clearLastPlanAndInit( GenericSearchGraph
 
 // ==================================================================================
 
-template <class NodeType, class CostType>
-CostType A_star_planner<NodeType,CostType>::_heapFun(NodeType& n, CostType g, CostType h, int s) 
+template <class NodeType, class CostType, class OpenListType, class GraphDescriptorType>
+CostType A_star_planner<NodeType,CostType,OpenListType,GraphDescriptorType>::_heapFun(NodeType& n, CostType g, CostType h, int s) 
 {
     if (heapFun_fp)
         return ( heapFun_fp(n, g, h, s) );
         
-    return ( g + subopEps*h );
+    return ( g + searchEps*h );
 }
 
 // ==================================================================================
 
-template <class NodeType, class CostType>
-void A_star_planner<NodeType,CostType>::plan(void)
+// Query the successors of a node and store them in its links. If the node has links from an earlier plan,
+//   only the costs are refreshed (the targets are kept as long as they still match).
+template <class NodeType, class CostType, class OpenListType, class GraphDescriptorType>
+void A_star_planner<NodeType,CostType,OpenListType,GraphDescriptorType>::_generateSuccessors(GraphNode_p thisGraphNode)
+{
+	NodeType* succNodes;
+	CostType* succCosts;
+	int succCount, a;
+	
+	if (GraphDescriptorType::hasSuccessorSpan)
+	{
+		successorSpan.clear();
+		GraphDescriptor->_getSuccessorSpan( thisGraphNode->n , &successorSpan );
+		succNodes = successorSpan.nodes;
+		succCosts = successorSpan.costs;
+		succCount = successorSpan.size();
+	}
+	else
+	{
+		thisNeighbours.clear();
+		thisTransitionCosts.clear();
+		GraphDescriptor->_getSuccessors( thisGraphNode->n , &thisNeighbours , &thisTransitionCosts );
+		succNodes = thisNeighbours.empty() ? NULL : &thisNeighbours[0];
+		succCosts = thisTransitionCosts.empty() ? NULL : &thisTransitionCosts[0];
+		succCount = thisNeighbours.size();
+	}
+	
+	if ( thisGraphNode->successors.empty() || succCount != thisGraphNode->successors.size() )
+	{
+		thisGraphNode->successors.init( succCount, hash->nodePool );
+		for (a=0; a<succCount; a++)
+			thisGraphNode->successors.set(a, hash->getNodeInHash(succNodes[a]), succCosts[a]);
+	}
+	else // Successors generated by an earlier plan: refresh the costs only
+		for (a=0; a<succCount; a++)
+			thisGraphNode->successors.set(a, ( succNodes[a] == thisGraphNode->successors.getLinkSearchGraphNode(a)->n ) ?
+					thisGraphNode->successors.getLinkSearchGraphNode(a) : hash->getNodeInHash(succNodes[a]), succCosts[a]);
+}
+
+// ==================================================================================
+
+template <class NodeType, class CostType, class OpenListType, class GraphDescriptorType>
+void A_star_planner<NodeType,CostType,OpenListType,GraphDescriptorType>::plan(void)
 {
 	GraphNode_p thisGraphNode, thisNeighbourGraphNode;
 	CostType this_g_val, thisTransitionCost, test_g_val;
-	std::vector< NodeType > thisNeighbours;
-	std::vector< CostType > thisTransitionCosts;
 	int a;
+	int sliceExpansions = 0;
+	// Wall time: clock() would add up the processor time of every thread of the process
+	std::chrono::steady_clock::time_point sliceStart = std::chrono::steady_clock::now();
 	
 	#if _YAGSBPL_A_STAR__VIEW_PROGRESS
 		float timediff = 0.0;
@@ -136,6 +177,14 @@ void A_star_planner<NodeType,CostType>::plan(void)
 	#endif
 	while ( !heap->empty() )
 	{
+		// Out of budget for this call: the next call continues from the open list as it is
+		if ( expansionBudget > 0 && sliceExpansions >= expansionBudget )
+			return;
+		if ( timeBudget > 0.0 && sliceExpansions % 64 == 63
+				&& std::chrono::duration<double>(std::chrono::steady_clock::now() - sliceStart).count() > timeBudget )
+			return;
+		sliceExpansions++;
+		
 		#if _YAGSBPL_A_STAR__VIEW_PROGRESS
 		    if(ProgressShowInterval>0) {
 			    if (expandcount % ProgressShowInterval == 0)
@@ -168,7 +217,12 @@ void A_star_planner<NodeType,CostType>::plan(void)
 		// Check if we need to stop furthur expansion
 		if ( GraphDescriptor->_stopSearch( thisGraphNode->n ) )
 		{
-			bookmarkGraphNodes.push_back(thisGraphNode);
+			// An anytime search finds the same target again, which keeps its single bookmark
+			size_t bm;
+			for (bm=0; bm<bookmarkGraphNodes.size() && bookmarkGraphNodes[bm]!=thisGraphNode; bm++) ;
+			if ( bm == bookmarkGraphNodes.size() )
+				bookmarkGraphNodes.push_back(thisGraphNode);
+			solutionEps = searchEps;
 			#if _YAGSBPL_A_STAR__VIEW_PROGRESS
 			    if (ProgressShowInterval>0) {
 				    if (timediff>=0.0)
@@ -177,6 +231,12 @@ void A_star_planner<NodeType,CostType>::plan(void)
 						    expandcount, heap->size(), ((timediff>=0.0) ? timediff : difftime(time(NULL),startsecond)) );
 			    }
 			#endif
+			if ( anytime && searchEps > 1.0 )
+			{
+				_startNextAnytimeSearch();
+				continue;
+			}
+			planComplete = true;
 			return;
 		}
 		// Check if we need to store the path leading to this node
@@ -192,15 +252,8 @@ void A_star_planner<NodeType,CostType>::plan(void)
 		}
 		
 		// Generate the neighbours if they are already not generated
-		thisNeighbours.clear();
-		thisTransitionCosts.clear();
-		if ( thisGraphNode->successors.empty() ) // Successors were not generated previously
-		{
-			GraphDescriptor->_getSuccessors( thisGraphNode->n , &thisNeighbours , &thisTransitionCosts );
-			thisGraphNode->successors.init( thisNeighbours.size() );
-			for (a=0; a<thisNeighbours.size(); a++)
-				thisGraphNode->successors.set(a, hash->getNodeInHash(thisNeighbours[a]), thisTransitionCosts[a]);
-		}
+		if ( thisGraphNode->successors.empty() || !GraphDescriptor->cacheSuccessorCosts )
+			_generateSuccessors( thisGraphNode );
 		#if _YAGSBPL_A_STAR__PRINT_VERBOSE
 		    printf("\tNumber of childeren: %d\n", thisGraphNode->successors.size());
 		#endif
@@ -216,7 +269,7 @@ void A_star_planner<NodeType,CostType>::plan(void)
 		    #endif
 			
 			// An uninitiated neighbour node - definitely g & f values not set either.
-			if ( !thisNeighbourGraphNode->initiated )
+			if ( !hash->nodeInitiated(thisNeighbourGraphNode) )
 			{
 				thisNeighbourGraphNode->plannerVars.accessible = GraphDescriptor->_isAccessible( thisNeighbourGraphNode->n );
 				if ( thisNeighbourGraphNode->plannerVars.accessible )
@@ -230,11 +283,12 @@ void A_star_planner<NodeType,CostType>::plan(void)
 					                            //thisNeighbourGraphNode->plannerVars.g + 
 													//subopEps * GraphDescriptor->_getHeuristicsToTarget( thisNeighbourGraphNode->n );
 					thisNeighbourGraphNode->plannerVars.expanded = false;
+					thisNeighbourGraphNode->plannerVars.inconsistent = false;
 					
 					// Put in open list and continue to next neighbour
 					heap->push( thisNeighbourGraphNode );
 				}
-				thisNeighbourGraphNode->initiated = true; // Always set this when other variables have already been set
+				hash->markInitiated(thisNeighbourGraphNode); // Always set this when other variables have already been set
 				#if _YAGSBPL_A_STAR__HANDLE_EVENTS
 					if (event_SuccUpdated_g)
 						event_SuccUpdated_g(thisGraphNode->n, thisNeighbourGraphNode->n, thisTransitionCost, 
@@ -248,8 +302,8 @@ void A_star_planner<NodeType,CostType>::plan(void)
 				continue;
 			}
 			
-			// Neighbour that are not accessible or in closed list are to be skipped
-			if ( !thisNeighbourGraphNode->plannerVars.accessible || thisNeighbourGraphNode->plannerVars.expanded )
+			// Neighbour that are not accessible or in closed list are to be skipped (closed ones only outside anytime mode)
+			if ( !thisNeighbourGraphNode->plannerVars.accessible || ( thisNeighbourGraphNode->plannerVars.expanded && !anytime ) )
 				continue;
 			
 			// Update came_from, g and f values if better
@@ -265,8 +319,15 @@ void A_star_planner<NodeType,CostType>::plan(void)
 				thisNeighbourGraphNode->came_from = thisGraphNode;
 				thisNeighbourGraphNode->plannerVars.seedLineage = thisGraphNode->plannerVars.seedLineage;
 				
-				// Since thisNeighbourGraphNode->f is changed, re-arrange it in heap
-				heap->update( thisNeighbourGraphNode );
+				// Since thisNeighbourGraphNode->f is changed, re-arrange it in heap.
+				// In anytime mode an expanded node is reopened by the next search, and a node left out of
+				//   the open list by the last restart goes back into it.
+				if ( thisNeighbourGraphNode->plannerVars.expanded )
+					thisNeighbourGraphNode->plannerVars.inconsistent = true;
+				else if ( thisNeighbourGraphNode->inHeap )
+					heap->update( thisNeighbourGraphNode );
+				else
+					heap->push( thisNeighbourGraphNode );
 				#if _YAGSBPL_A_STAR__HANDLE_EVENTS
 					if (event_SuccUpdated_g)
 						event_SuccUpdated_g(thisGraphNode->n, thisNeighbourGraphNode->n, thisTransitionCost, 
@@ -280,6 +341,7 @@ void A_star_planner<NodeType,CostType>::plan(void)
 			}
 		}
 	}
+	planComplete = true;
 	#if _YAGSBPL_A_STAR__VIEW_PROGRESS
 	    if (ProgressShowInterval>0 && heap->empty())
 	        printf("Stopping search!! Heap is empty. Number of states expanded: %d. Heap size: %d. Time elapsed: %f s.\n", 
@@ -287,17 +349,51 @@ void A_star_planner<NodeType,CostType>::plan(void)
 	#endif
 }
 
+// Start the next search of the anytime mode (ARA*): lower the inflation, move the inconsistent nodes to the
+//   open list, recompute the keys of the open list and empty the closed list. The target goes back to the open
+//   list too, so the search stops as soon as no node can improve the path to it any more.
+template <class NodeType, class CostType, class OpenListType, class GraphDescriptorType>
+void A_star_planner<NodeType,CostType,OpenListType,GraphDescriptorType>::_startNextAnytimeSearch(void)
+{
+	GraphNode_p thisGraphNode;
+	std::vector< GraphNode_p > openGraphNodes;
+	
+	searchEps = (searchEps - epsDecrement > 1.0) ? (searchEps - epsDecrement) : 1.0;
+	for (size_t a=0; a<bookmarkGraphNodes.size(); a++)
+		bookmarkGraphNodes[a]->plannerVars.inconsistent = true;
+	for (unsigned int a=0; a<hash->nodeCount(); a++)
+	{
+		thisGraphNode = hash->getNodeByIndex(a);
+		if ( !hash->nodeInitiated(thisGraphNode) || !thisGraphNode->plannerVars.accessible )
+			continue;
+		if ( thisGraphNode->inHeap || thisGraphNode->plannerVars.inconsistent )
+			openGraphNodes.push_back(thisGraphNode);
+		thisGraphNode->plannerVars.expanded = false;
+		thisGraphNode->plannerVars.inconsistent = false;
+	}
+	
+	heap->clear();
+	for (size_t a=0; a<openGraphNodes.size(); a++)
+	{
+		thisGraphNode = openGraphNodes[a];
+		thisGraphNode->f = _heapFun(thisGraphNode->n, thisGraphNode->plannerVars.g, 
+		                            GraphDescriptor->_getHeuristicsToTarget( thisGraphNode->n ), 
+		                            thisGraphNode->plannerVars.seedLineage);
+		heap->push( thisGraphNode );
+	}
+}
+
 // ==================================================================================
 
-template <class NodeType, class CostType>
+template <class NodeType, class CostType, class OpenListType, class GraphDescriptorType>
 std::vector< SearchGraphNode< NodeType, CostType, A_star_variables<CostType> >* > 
-											A_star_planner<NodeType,CostType>::getGoalGraphNodePointers(void)
+											A_star_planner<NodeType,CostType,OpenListType,GraphDescriptorType>::getGoalGraphNodePointers(void)
 {
 	return (bookmarkGraphNodes);
 }
 
-template <class NodeType, class CostType>
-std::vector<NodeType> A_star_planner<NodeType,CostType>::getGoalNodes(void)
+template <class NodeType, class CostType, class OpenListType, class GraphDescriptorType>
+std::vector<NodeType> A_star_planner<NodeType,CostType,OpenListType,GraphDescriptorType>::getGoalNodes(void)
 {
 	std::vector<NodeType> ret;
 	for (int a=0; a<bookmarkGraphNodes.size(); a++)
@@ -305,8 +401,8 @@ std::vector<NodeType> A_star_planner<NodeType,CostType>::getGoalNodes(void)
 	return (ret);
 }
 
-template <class NodeType, class CostType>
-std::vector<CostType> A_star_planner<NodeType,CostType>::getPlannedPathCosts(void)
+template <class NodeType, class CostType, class OpenListType, class GraphDescriptorType>
+std::vector<CostType> A_star_planner<NodeType,CostType,OpenListType,GraphDescriptorType>::getPlannedPathCosts(void)
 {
 	std::vector<CostType> costs;
 	for (int a=0; a<bookmarkGraphNodes.size(); a++)
@@ -314,8 +410,8 @@ std::vector<CostType> A_star_planner<NodeType,CostType>::getPlannedPathCosts(voi
 	return (costs);
 }
 
-template <class NodeType, class CostType>
-std::vector< std::vector< NodeType > > A_star_planner<NodeType,CostType>::getPlannedPaths(void)
+template <class NodeType, class CostType, class OpenListType, class GraphDescriptorType>
+std::vector< std::vector< NodeType > > A_star_planner<NodeType,CostType,OpenListType,GraphDescriptorType>::getPlannedPaths(void)
 {
 	std::vector< std::vector< NodeType > > paths;
 	std::vector< NodeType > thisPath;
@@ -335,8 +431,8 @@ std::vector< std::vector< NodeType > > A_star_planner<NodeType,CostType>::getPla
 	return (paths);
 }
 
-template <class NodeType, class CostType>
-A_star_variables<CostType> A_star_planner<NodeType,CostType>::getNodeInfo(NodeType n)
+template <class NodeType, class CostType, class OpenListType, class GraphDescriptorType>
+A_star_variables<CostType> A_star_planner<NodeType,CostType,OpenListType,GraphDescriptorType>::getNodeInfo(NodeType n)
 {
 	GraphNode_p thisGraphNode = hash->getNodeInHash(n);
 	return thisGraphNode->plannerVars;
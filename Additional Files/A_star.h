@@ -0,0 +1,163 @@
+/******************************************************************************************
+*                                                                                        *
+*    Yet Another Graph-Search Based Planning Library (YAGSBPL)                           *
+*    A template-based C++ library for graph search and planning                          *
+*    Version 2.1                                                                         *
+*    ----------------------------------------------------------                          *
+*    Copyright (C) 2013  Subhrajit Bhattacharya                                          *
+*                                                                                        *
+*    This program is free software: you can redistribute it and/or modify                *
+*    it under the terms of the GNU General Public License as published by                *
+*    the Free Software Foundation, either version 3 of the License, or                   *
+*    (at your option) any later version.                                                 *
+*                                                                                        *
+*    This program is distributed in the hope that it will be useful,                     *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                      *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       *
+*    GNU General Public License for more details <http://www.gnu.org/licenses/>.         *
+*                                                                                        *
+*                                                                                        *
+*    Contact: subhrajit@gmail.com, http://subhrajit.net/                                 *
+*                                                                                        *
+*                                                                                        *
+******************************************************************************************/
+//    For a detailed tutorial and download, visit 
+//    http://subhrajit.net/index.php?WPage=yagsbpl
+
+
+#ifndef __A_STAR_2F585H2B321R_H_
+#define __A_STAR_2F585H2B321R_H_
+
+#include <stdio.h>
+#include <vector>
+#include <time.h>
+#include <chrono>
+#include "../yagsbpl_base.h"
+
+#define _YAGSBPL_A_STAR__VIEW_PROGRESS 1
+#define _YAGSBPL_A_STAR__PRINT_VERBOSE 0
+#define _YAGSBPL_A_STAR__HANDLE_EVENTS 1
+
+template <class CostType>
+class A_star_variables
+{
+public:
+	CostType g;
+	bool expanded; // Whether in closed list or not
+	bool accessible; // Since the environment is assumed to to change, each node has fixed accessibility
+	bool inconsistent; // Anytime mode: improved after it was expanded, so it waits for the next search
+	int seedLineage; // stores which seed the node came from
+	
+	A_star_variables() { expanded=false; inconsistent=false; }
+};
+
+// 'OpenListType' is the priority queue used as open list. The default is the radix heap for integral
+//   cost types and the 4-ary heap otherwise (see 'DefaultOpenList');
+//   'HeapContainer< NodeType, CostType, A_star_variables<CostType> >' gives the original binary heap.
+// 'GraphDescriptorType' is 'GenericSearchGraphDescriptor' by default; 'StaticSearchGraphDescriptor' binds the
+//   graph functions at compile time.
+template <class NodeType, class CostType,
+			class OpenListType = typename DefaultOpenList< NodeType, CostType, A_star_variables<CostType> >::type,
+			class GraphDescriptorType = GenericSearchGraphDescriptor<NodeType,CostType> >
+class A_star_planner
+{
+public:
+	typedef  SearchGraphNode< NodeType, CostType, A_star_variables<CostType> >*  GraphNode_p;
+	
+	// Instance of generac planner
+	GenericPlanner< NodeType, CostType, A_star_variables<CostType>, OpenListType, GraphDescriptorType > GenericPlannerInstance;
+	// Re-mapping of generic planner variables for ease of use (coding convenience)
+	GraphDescriptorType* GraphDescriptor;
+	HashTableContainer<NodeType,CostType,A_star_variables<CostType>,GraphDescriptorType>* hash;
+	OpenListType* heap;
+	
+	// Member variables
+	double subopEps;
+	int heapKeyCount;
+	int ProgressShowInterval;
+	bool useNodePool;
+	int expansionBudget; // Time slicing: expansions per call to 'plan', 0 for no limit
+	double timeBudget; // Time slicing: wall-clock time per call to 'plan' in seconds, 0 for no limit
+	bool anytime;
+	double epsDecrement;
+	double searchEps; // Heuristic inflation of the current search: 'subopEps', lowered by later anytime searches
+	double solutionEps; // Inflation of the search that found the stored paths, 0 if none yet
+	bool planComplete;
+	std::vector< GraphNode_p > bookmarkGraphNodes;
+	// Successors of the node being expanded. Reused by every expansion, so they only allocate while
+	//   growing to the largest successor count ('successorSpan' never does).
+	typename GraphDescriptorType::SuccessorSpanType successorSpan;
+	std::vector< NodeType > thisNeighbours;
+	std::vector< CostType > thisTransitionCosts;
+	
+	CostType (*heapFun_fp)(NodeType& n, CostType g, CostType h, int s);
+	
+	// Optional event handlers - Pointers to function that get called when an event take place
+	#if _YAGSBPL_A_STAR__HANDLE_EVENTS
+		// Node 'n' is expanded. This can also be handled by 'stopSearch'.
+		void (*event_NodeExpanded_g)(NodeType n, CostType gVal, CostType fVal, int seedLineage);
+		void (NodeType::*event_NodeExpanded_nm)(CostType gVal, CostType fVal, int seedLineage);
+		// Successor 'nn' is in open list and has just been initiated or updated
+		void (*event_SuccUpdated_g)(NodeType n, NodeType nn, CostType edgeCost, CostType gVal, CostType fVal, int seedLineage);
+		void (NodeType::*event_SuccUpdated_nm)(NodeType nn, CostType edgeCost, CostType gVal, CostType fVal, int seedLineage);
+	#endif
+	
+	// Initiator (called before "plan")
+	A_star_planner()
+	{
+		heapKeyCount = 20; subopEps = 1.0; ProgressShowInterval = 10000; useNodePool = false;
+		expansionBudget = 0; timeBudget = 0.0; anytime = false; epsDecrement = 0.5;
+		searchEps = 1.0; solutionEps = 0.0; planComplete = false;
+		heapFun_fp = NULL;
+		#if _YAGSBPL_A_STAR__HANDLE_EVENTS
+			event_NodeExpanded_g = NULL; event_NodeExpanded_nm = NULL;
+			event_SuccUpdated_g = NULL; event_SuccUpdated_nm = NULL;
+		#endif
+	}
+	void setParams( double eps=1.0 , int heapKeyCt=20 , int progressDispInterval=10000 ) // call to this is optional.
+		{ subopEps = eps; heapKeyCount = heapKeyCt; ProgressShowInterval = progressDispInterval; }
+	// Allocate all nodes and successor links from a slab pool that is released in one go with the planner.
+	// Must be called before the first "init".
+	void setNodePooling(bool pool=true) { useNodePool = pool; }
+	// Time slicing: "plan" returns after 'expansions' expansions or 'seconds' of wall-clock time (0 for no limit),
+	//   and the next call to "plan" resumes the search where it stopped. Call it until "isPlanComplete".
+	void setPlanningBudget( int expansions=0 , double seconds=0.0 ) { expansionBudget = expansions; timeBudget = seconds; }
+	// Anytime mode (ARA*): the first search inflates the heuristics by 'subopEps', so its path costs at most
+	//   'subopEps' times the optimum. Each following search lowers the inflation by 'decrement', down to 1, and reuses
+	//   the previous one. The stored paths are replaced after every search; "getSolutionEps" gives their bound.
+	//   Needs the default 'stopSearch' and an open list that accepts decreasing keys (not the radix heap).
+	void setAnytime( bool any=true , double decrement=0.5 ) { anytime = any; epsDecrement = decrement; }
+	void init( GraphDescriptorType* theEnv_p=NULL , bool createHashAndHeap=true );
+	void init( GraphDescriptorType theEnv ) { init(&theEnv); }
+	void clearLastPlanAndInit( GraphDescriptorType* theEnv_p=NULL );
+	void clearLastPlanAndInit( GraphDescriptorType theEnv ) { clearLastPlanAndInit(&theEnv); }
+	// Main planner function
+	void plan(void);
+	bool isPlanComplete(void) { return (planComplete); }
+	double getSolutionEps(void) { return (solutionEps); }
+	
+	// Planner output access: ( to be called after plan(), and before destruction of planner )
+	std::vector< NodeType > getGoalNodes(void);
+	std::vector< GraphNode_p > getGoalGraphNodePointers(void);
+	std::vector< CostType > getPlannedPathCosts(void);
+	std::vector< std::vector< NodeType > > getPlannedPaths(void);
+	A_star_variables<CostType> getNodeInfo(NodeType n);
+	
+	// Other variables for getting timing info
+	#if _YAGSBPL_A_STAR__VIEW_PROGRESS
+		clock_t startclock;
+		time_t startsecond;
+		int expandcount;
+	#endif
+	
+	CostType _heapFun(NodeType& n, CostType g, CostType h, int s);
+	void _generateSuccessors(GraphNode_p thisGraphNode);
+	void _startNextAnytimeSearch(void);
+};
+
+// =====================================================================================
+
+#include "A_star.cpp"
+
+#endif
+
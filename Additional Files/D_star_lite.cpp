@@ -0,0 +1,435 @@
+/******************************************************************************************
+*                                                                                        *
+*    Yet Another Graph-Search Based Planning Library (YAGSBPL)                           *
+*    A template-based C++ library for graph search and planning                          *
+*    Version 2.1                                                                         *
+*    ----------------------------------------------------------                          *
+*    Copyright (C) 2013  Subhrajit Bhattacharya                                          *
+*                                                                                        *
+*    This program is free software: you can redistribute it and/or modify                *
+*    it under the terms of the GNU General Public License as published by                *
+*    the Free Software Foundation, either version 3 of the License, or                   *
+*    (at your option) any later version.                                                 *
+*                                                                                        *
+*    This program is distributed in the hope that it will be useful,                     *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                      *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       *
+*    GNU General Public License for more details <http://www.gnu.org/licenses/>.         *
+*                                                                                        *
+*                                                                                        *
+*    Contact: subhrajit@gmail.com, http://subhrajit.net/                                 *
+*                                                                                        *
+*                                                                                        *
+******************************************************************************************/
+//    For a detailed tutorial and download, visit
+//    http://subhrajit.net/index.php?WPage=yagsbpl
+
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::init( GraphDescriptorType* theEnv_p, bool createHashAndHeap )
+{
+	if (theEnv_p && createHashAndHeap)
+		GenericPlannerInstance.init(*theEnv_p, heapKeyCount, useNodePool);  // This initiates the graph, hash and heap of the generic planner
+	else if (theEnv_p)
+	    *GenericPlannerInstance.GraphDescriptor = *theEnv_p;
+	
+	// Remapping for coding convenience
+	GraphDescriptor = GenericPlannerInstance.GraphDescriptor;
+	hash = GenericPlannerInstance.hash;
+	heap = GenericPlannerInstance.heap;
+	
+	// Init graph and clear the heap
+	GraphDescriptor->init();
+	heap->clear();
+	touchedGraphNodes.clear(); // A new hash or a new generation: no node is initiated yet
+	km = (CostType)0;
+	targetStamp++;
+	
+	// The seed is the root of the search tree
+	seedGraphNode = _touch( hash->getNodeInHash( GraphDescriptor->SeedNodes[0] ) );
+	seedGraphNode->plannerVars.rhs = (CostType)0;
+	_updateState(seedGraphNode);
+}
+
+// -----------------------------
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::clearLastPlanAndInit( GraphDescriptorType* theEnv_p )
+{
+	// Set every node in hash to not initiated in O(1), which drops the whole search tree
+	if (hash) {
+		hash->newGeneration();
+		init(theEnv_p ? theEnv_p : GraphDescriptor, false);
+	}
+	else
+		init(theEnv_p ? theEnv_p : GraphDescriptor);
+}
+
+// ==================================================================================
+
+// Initiate a node the first time it is seen in the current generation
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+typename D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::GraphNode_p D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::_touch(GraphNode_p thisGraphNode)
+{
+	if ( !hash->nodeInitiated(thisGraphNode) )
+	{
+		thisGraphNode->came_from = NULL;
+		thisGraphNode->plannerVars.g = _infinity();
+		thisGraphNode->plannerVars.rhs = _infinity();
+		thisGraphNode->plannerVars.accessible = GraphDescriptor->_isAccessible( thisGraphNode->n );
+		thisGraphNode->plannerVars.linked = false;
+		hash->markInitiated(thisGraphNode); // Always set this when other variables have already been set
+		touchedGraphNodes.push_back(thisGraphNode);
+	}
+	return (thisGraphNode);
+}
+
+// Query the successors of a node and store them as its successor links (see 'A_star_planner::_generateSuccessors')
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::_generateSuccessors(GraphNode_p thisGraphNode)
+{
+	NodeType* succNodes;
+	CostType* succCosts;
+	int succCount, a;
+	
+	if (GraphDescriptorType::hasSuccessorSpan)
+	{
+		successorSpan.clear();
+		GraphDescriptor->_getSuccessorSpan( thisGraphNode->n , &successorSpan );
+		succNodes = successorSpan.nodes;
+		succCosts = successorSpan.costs;
+		succCount = successorSpan.size();
+	}
+	else
+	{
+		thisNeighbours.clear();
+		thisTransitionCosts.clear();
+		GraphDescriptor->_getSuccessors( thisGraphNode->n , &thisNeighbours , &thisTransitionCosts );
+		succNodes = thisNeighbours.empty() ? NULL : &thisNeighbours[0];
+		succCosts = thisTransitionCosts.empty() ? NULL : &thisTransitionCosts[0];
+		succCount = thisNeighbours.size();
+	}
+	
+	if ( thisGraphNode->successors.empty() || succCount != thisGraphNode->successors.size() )
+	{
+		thisGraphNode->successors.init( succCount, hash->nodePool );
+		for (a=0; a<succCount; a++)
+			thisGraphNode->successors.set(a, hash->getNodeInHash(succNodes[a]), succCosts[a]);
+	}
+	else // Successors generated by an earlier generation: refresh the costs only
+		for (a=0; a<succCount; a++)
+			thisGraphNode->successors.set(a, ( succNodes[a] == thisGraphNode->successors.getLinkSearchGraphNode(a)->n ) ?
+					thisGraphNode->successors.getLinkSearchGraphNode(a) : hash->getNodeInHash(succNodes[a]), succCosts[a]);
+	
+	thisGraphNode->plannerVars.linked = true;
+}
+
+// Transition cost from one node to another, infinite if 'toGraphNode' is not a successor
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+CostType D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::_linkCost(GraphNode_p fromGraphNode, GraphNode_p toGraphNode)
+{
+	if ( !fromGraphNode->plannerVars.linked )
+		_generateSuccessors(fromGraphNode);
+	for (int a=0; a<fromGraphNode->successors.size(); a++)
+		if ( fromGraphNode->successors.getLinkSearchGraphNode(a) == toGraphNode )
+			return ( fromGraphNode->successors.getLinkCost(a) );
+	return ( _infinity() );
+}
+
+// rhs = min over predecessors p of g(p) + c(p, node), and came_from = the minimizing p.
+//   The predecessors are the successors, as connectivity is symmetric.
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::_computeRhs(GraphNode_p thisGraphNode)
+{
+	GraphNode_p predGraphNode;
+	CostType thisCost;
+	
+	thisGraphNode->plannerVars.rhs = _infinity();
+	thisGraphNode->came_from = NULL;
+	if ( !thisGraphNode->plannerVars.linked )
+		_generateSuccessors(thisGraphNode);
+	for (int a=0; a<thisGraphNode->successors.size(); a++)
+	{
+		predGraphNode = _touch( thisGraphNode->successors.getLinkSearchGraphNode(a) );
+		if ( !predGraphNode->plannerVars.accessible || predGraphNode->plannerVars.g == _infinity() )
+			continue;
+		thisCost = _linkCost(predGraphNode, thisGraphNode);
+		if ( thisCost != _infinity() && predGraphNode->plannerVars.g + thisCost < thisGraphNode->plannerVars.rhs )
+		{
+			thisGraphNode->plannerVars.rhs = predGraphNode->plannerVars.g + thisCost;
+			thisGraphNode->came_from = predGraphNode;
+		}
+	}
+}
+
+// First component of the D* Lite key. Ties are not broken on the second one (min(g,rhs)): with positive
+//   transition costs and consistent heuristics an overconsistent node with the least first component
+//   already has its final g-value.
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+CostType D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::_key(GraphNode_p thisGraphNode)
+{
+	CostType m = (thisGraphNode->plannerVars.g < thisGraphNode->plannerVars.rhs) ?
+						thisGraphNode->plannerVars.g : thisGraphNode->plannerVars.rhs;
+	if (m == _infinity())
+		return (m);
+	return ( m + _heuristics(thisGraphNode) + km );
+}
+
+// Heuristics to the target, computed once per node and target: keys are taken many times per expansion
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+CostType D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::_heuristics(GraphNode_p thisGraphNode)
+{
+	if ( thisGraphNode->plannerVars.hTarget != targetStamp )
+	{
+		thisGraphNode->plannerVars.h = GraphDescriptor->_getHeuristicsToTarget( thisGraphNode->n );
+		thisGraphNode->plannerVars.hTarget = targetStamp;
+	}
+	return ( thisGraphNode->plannerVars.h );
+}
+
+// Keep a node in the open list exactly while it is locally inconsistent (g != rhs)
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::_updateState(GraphNode_p thisGraphNode)
+{
+	if ( thisGraphNode->plannerVars.g != thisGraphNode->plannerVars.rhs )
+	{
+		thisGraphNode->f = _key(thisGraphNode);
+		if (thisGraphNode->inHeap)
+			heap->update( thisGraphNode );
+		else
+			heap->push( thisGraphNode );
+	}
+	else if (thisGraphNode->inHeap)
+		heap->remove( thisGraphNode );
+}
+
+// ==================================================================================
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::plan(void)
+{
+	GraphNode_p thisGraphNode, thisNeighbourGraphNode;
+	CostType newKey, thisTransitionCost;
+	int a;
+	
+	expandcount = 0;
+	GraphNode_p targetGraphNode = _touch( hash->getNodeInHash( GraphDescriptor->TargetNode ) );
+	
+	while ( !heap->empty() )
+	{
+		thisGraphNode = heap->pop();
+		
+		// Stop once the target is consistent and no node in the open list can lower its key
+		if ( !(thisGraphNode->f < _key(targetGraphNode)) &&
+				!(targetGraphNode->plannerVars.rhs > targetGraphNode->plannerVars.g) )
+		{
+			heap->push( thisGraphNode );
+			break;
+		}
+		
+		// Key is outdated (the target moved since it was computed)
+		newKey = _key(thisGraphNode);
+		if ( thisGraphNode->f < newKey )
+		{
+			thisGraphNode->f = newKey;
+			heap->push( thisGraphNode );
+			continue;
+		}
+		
+		expandcount++;
+		if ( !thisGraphNode->plannerVars.linked )
+			_generateSuccessors( thisGraphNode );
+		
+		if ( thisGraphNode->plannerVars.g > thisGraphNode->plannerVars.rhs )
+		{
+			// Overconsistent: settle g and try to improve the successors through this node
+			thisGraphNode->plannerVars.g = thisGraphNode->plannerVars.rhs;
+			for (a=0; a<thisGraphNode->successors.size(); a++)
+			{
+				thisNeighbourGraphNode = _touch( thisGraphNode->successors.getLinkSearchGraphNode(a) );
+				thisTransitionCost = thisGraphNode->successors.getLinkCost(a);
+				if ( !thisNeighbourGraphNode->plannerVars.accessible || thisNeighbourGraphNode == seedGraphNode )
+					continue;
+				if ( thisGraphNode->plannerVars.g + thisTransitionCost < thisNeighbourGraphNode->plannerVars.rhs )
+				{
+					thisNeighbourGraphNode->plannerVars.rhs = thisGraphNode->plannerVars.g + thisTransitionCost;
+					thisNeighbourGraphNode->came_from = thisGraphNode;
+					_updateState( thisNeighbourGraphNode );
+				}
+			}
+		}
+		else
+		{
+			// Underconsistent: invalidate g and re-derive the successors that were reached through this node
+			thisGraphNode->plannerVars.g = _infinity();
+			for (a=0; a<thisGraphNode->successors.size(); a++)
+			{
+				thisNeighbourGraphNode = _touch( thisGraphNode->successors.getLinkSearchGraphNode(a) );
+				if ( !thisNeighbourGraphNode->plannerVars.accessible || thisNeighbourGraphNode == seedGraphNode )
+					continue;
+				if ( thisNeighbourGraphNode->came_from == thisGraphNode )
+				{
+					_computeRhs( thisNeighbourGraphNode );
+					_updateState( thisNeighbourGraphNode );
+				}
+			}
+			_updateState( thisGraphNode );
+		}
+	}
+}
+
+// ==================================================================================
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::moveTarget(NodeType n)
+{
+	if ( n == GraphDescriptor->TargetNode )
+		return;
+	km += GraphDescriptor->_getHeuristics( GraphDescriptor->TargetNode , n );
+	GraphDescriptor->TargetNode = n;
+	targetStamp++;
+}
+
+// Re-root the search tree at 'n'. Nodes below 'n' keep their g-values, which are all larger by rhs(n) than the
+//   cost from 'n'; rhs(n) stays as it is, so the keys stay comparable. Every other node is reset and
+//   then gets an rhs-value from the kept nodes around it, which puts the fringe of the kept subtree back in the open list.
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+bool D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::moveSeed(NodeType n)
+{
+	GraphNode_p newSeedGraphNode, thisGraphNode;
+	unsigned int a, b;
+	unsigned char mark;
+	
+	if ( n == seedGraphNode->n )
+		return (true);
+	newSeedGraphNode = hash->getNodeInHash(n);
+	if ( !hash->nodeInitiated(newSeedGraphNode) || newSeedGraphNode->plannerVars.rhs == _infinity() )
+		return (false);
+	
+	// Mark nodes in the subtree of the new seed (1) and outside it (2), following 'came_from' from every node
+	//   of this generation (only those can be marked). Nodes on the chain being followed are marked 3, so a
+	//   (stale) cycle ends up outside.
+	if ( subtreeMark.size() < hash->nodeCount() )
+		subtreeMark.resize( hash->nodeCount(), 0 );
+	subtreeMark[newSeedGraphNode->id] = 1;
+	for (a=0; a<touchedGraphNodes.size(); a++)
+	{
+		if (subtreeMark[touchedGraphNodes[a]->id])
+			continue;
+		chainGraphNodes.clear();
+		thisGraphNode = touchedGraphNodes[a];
+		while ( thisGraphNode && hash->nodeInitiated(thisGraphNode) && !subtreeMark[thisGraphNode->id] )
+		{
+			subtreeMark[thisGraphNode->id] = 3;
+			chainGraphNodes.push_back(thisGraphNode);
+			thisGraphNode = thisGraphNode->came_from;
+		}
+		mark = ( thisGraphNode && hash->nodeInitiated(thisGraphNode) && subtreeMark[thisGraphNode->id] == 1 ) ? 1 : 2;
+		for (b=0; b<chainGraphNodes.size(); b++)
+			subtreeMark[chainGraphNodes[b]->id] = mark;
+	}
+	
+	// Reset everything outside the subtree, and clear the marks for the next call
+	deletedGraphNodes.clear();
+	for (a=0; a<touchedGraphNodes.size(); a++)
+	{
+		thisGraphNode = touchedGraphNodes[a];
+		mark = subtreeMark[thisGraphNode->id];
+		subtreeMark[thisGraphNode->id] = 0;
+		if ( mark != 2 )
+			continue;
+		if ( thisGraphNode->plannerVars.g == _infinity() && thisGraphNode->plannerVars.rhs == _infinity() )
+			continue;
+		thisGraphNode->plannerVars.g = _infinity();
+		thisGraphNode->plannerVars.rhs = _infinity();
+		thisGraphNode->came_from = NULL;
+		if (thisGraphNode->inHeap)
+			heap->remove( thisGraphNode );
+		deletedGraphNodes.push_back(thisGraphNode);
+	}
+	
+	newSeedGraphNode->came_from = NULL;
+	seedGraphNode = newSeedGraphNode;
+	GraphDescriptor->SeedNode = n;
+	GraphDescriptor->SeedNodes[0] = n;
+	
+	for (a=0; a<deletedGraphNodes.size(); a++)
+	{
+		_computeRhs( deletedGraphNodes[a] );
+		_updateState( deletedGraphNodes[a] );
+	}
+	return (true);
+}
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::updateNodeCosts(NodeType n)
+{
+	GraphNode_p thisGraphNode = hash->getNodeInHash(n), thisNeighbourGraphNode;
+	CostType thisTransitionCost;
+	
+	// Costs that were never queried in this generation cannot have been used
+	if ( !hash->nodeInitiated(thisGraphNode) || !thisGraphNode->plannerVars.linked )
+		return;
+	_generateSuccessors(thisGraphNode);
+	
+	for (int a=0; a<thisGraphNode->successors.size(); a++)
+	{
+		thisNeighbourGraphNode = _touch( thisGraphNode->successors.getLinkSearchGraphNode(a) );
+		thisTransitionCost = thisGraphNode->successors.getLinkCost(a);
+		if ( !thisNeighbourGraphNode->plannerVars.accessible || thisNeighbourGraphNode == seedGraphNode )
+			continue;
+		if ( thisNeighbourGraphNode->came_from == thisGraphNode || ( thisGraphNode->plannerVars.g != _infinity() &&
+				thisGraphNode->plannerVars.g + thisTransitionCost < thisNeighbourGraphNode->plannerVars.rhs ) )
+		{
+			_computeRhs( thisNeighbourGraphNode );
+			_updateState( thisNeighbourGraphNode );
+		}
+	}
+}
+
+// ==================================================================================
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+std::vector<NodeType> D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::getGoalNodes(void)
+{
+	std::vector<NodeType> ret;
+	GraphNode_p targetGraphNode = _touch( hash->getNodeInHash( GraphDescriptor->TargetNode ) );
+	if ( targetGraphNode->plannerVars.rhs != _infinity() )
+		ret.push_back(targetGraphNode->n);
+	return (ret);
+}
+
+// The search stops once rhs(target) is final, possibly before g(target) is set, so results come from rhs.
+// Path costs are measured from the current seed, so the seed's rhs (the offset left by 'moveSeed') is subtracted.
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+std::vector<CostType> D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::getPlannedPathCosts(void)
+{
+	std::vector<CostType> costs;
+	GraphNode_p targetGraphNode = _touch( hash->getNodeInHash( GraphDescriptor->TargetNode ) );
+	if ( targetGraphNode->plannerVars.rhs != _infinity() )
+		costs.push_back(targetGraphNode->plannerVars.rhs - seedGraphNode->plannerVars.rhs);
+	return (costs);
+}
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+std::vector< std::vector< NodeType > > D_star_lite_planner<NodeType,CostType,GraphClass,OpenListType>::getPlannedPaths(void)
+{
+	std::vector< std::vector< NodeType > > paths;
+	std::vector< NodeType > thisPath;
+	GraphNode_p thisGraphNode = _touch( hash->getNodeInHash( GraphDescriptor->TargetNode ) );
+	if ( thisGraphNode->plannerVars.rhs == _infinity() )
+		return (paths);
+	
+	// Reconstruct path backwards. A path can never be longer than the number of nodes.
+	while (thisGraphNode && thisPath.size() <= hash->nodeCount())
+	{
+		thisPath.push_back(thisGraphNode->n);
+		if (thisGraphNode == seedGraphNode)
+		{
+			paths.push_back(thisPath);
+			break;
+		}
+		thisGraphNode = thisGraphNode->came_from;
+	}
+	return (paths);
+}
@@ -0,0 +1,137 @@
+/******************************************************************************************
+*                                                                                        *
+*    Yet Another Graph-Search Based Planning Library (YAGSBPL)                           *
+*    A template-based C++ library for graph search and planning                          *
+*    Version 2.1                                                                         *
+*    ----------------------------------------------------------                          *
+*    Copyright (C) 2013  Subhrajit Bhattacharya                                          *
+*                                                                                        *
+*    This program is free software: you can redistribute it and/or modify                *
+*    it under the terms of the GNU General Public License as published by                *
+*    the Free Software Foundation, either version 3 of the License, or                   *
+*    (at your option) any later version.                                                 *
+*                                                                                        *
+*    This program is distributed in the hope that it will be useful,                     *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                      *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       *
+*    GNU General Public License for more details <http://www.gnu.org/licenses/>.         *
+*                                                                                        *
+*                                                                                        *
+*    Contact: subhrajit@gmail.com, http://subhrajit.net/                                 *
+*                                                                                        *
+*                                                                                        *
+******************************************************************************************/
+//    For a detailed tutorial and download, visit
+//    http://subhrajit.net/index.php?WPage=yagsbpl
+
+
+
+#ifndef __D_STAR_LITE_2F585H2B321R_H_
+#define __D_STAR_LITE_2F585H2B321R_H_
+
+#include <stdio.h>
+#include <vector>
+#include <limits>
+#include "../yagsbpl_base.h"
+
+// Incremental planner: Moving Target D* Lite (Sun, Yeoh & Koenig, 2010), the LPA* family of searches.
+//   It keeps its search tree between calls to 'plan' and only repairs the part that changed when
+//   - the target moves ('moveTarget'): the heuristics shift, which 'km' absorbs, so nothing is re-searched up front;
+//   - the seed moves within the search tree ('moveSeed'): the subtree below the new seed stays valid (its g-values
+//     are off by the same constant) and only the rest of the tree is dropped and re-derived from its fringe;
+//   - transition costs change ('updateNodeCosts').
+//   The search runs forward from 'SeedNode' (only one seed) to 'TargetNode' and keys are (min(g,rhs) + h + km).
+// Requirements on the graph:
+//   - Connectivity is symmetric: if 'm' is a successor of 'n', 'n' is a successor of 'm' (costs may differ).
+//   - 'getHeuristics' is consistent and satisfies the triangle inequality (e.g. a distance), since the
+//     heuristics of a moved target are bounded using h(old target, new target).
+//   - Accessibility does not change between calls.
+//   Keys are not monotone, so the open list must support arbitrary key changes (the radix heap does not).
+
+template <class CostType>
+class D_star_lite_variables
+{
+public:
+	CostType g;
+	CostType rhs; // One-step lookahead: best g of a predecessor plus the transition cost from it
+	CostType h; // Heuristics to the target, valid while hTarget is the planner's targetStamp
+	unsigned int hTarget;
+	bool accessible;
+	bool linked; // Successors generated in this generation
+	
+	D_star_lite_variables() { linked=false; hTarget=0; }
+};
+
+template <class NodeType, class CostType, class GraphClass,
+			class OpenListType = DaryHeapContainer< NodeType, CostType, D_star_lite_variables<CostType> > >
+class D_star_lite_planner
+{
+public:
+	typedef  SearchGraphNode< NodeType, CostType, D_star_lite_variables<CostType> >*  GraphNode_p;
+	typedef  StaticSearchGraphDescriptor< NodeType, CostType, GraphClass >  GraphDescriptorType;
+	
+	// Instance of generac planner
+	GenericPlanner< NodeType, CostType, D_star_lite_variables<CostType>, OpenListType, GraphDescriptorType > GenericPlannerInstance;
+	// Re-mapping of generic planner variables for ease of use (coding convenience)
+	GraphDescriptorType* GraphDescriptor;
+	HashTableContainer<NodeType,CostType,D_star_lite_variables<CostType>,GraphDescriptorType>* hash;
+	OpenListType* heap;
+	
+	// Member variables
+	int heapKeyCount;
+	bool useNodePool;
+	CostType km; // Sum of the heuristic distances the target moved, added to every key
+	unsigned int targetStamp; // Changes with the target, so heuristics computed for an earlier one are not used
+	GraphNode_p seedGraphNode;
+	int expandcount; // Number of nodes expanded by the last plan
+	// Successors of the node being expanded (see 'A_star_planner')
+	typename GraphDescriptorType::SuccessorSpanType successorSpan;
+	std::vector< NodeType > thisNeighbours;
+	std::vector< CostType > thisTransitionCosts;
+	
+	// Initiator (called before "plan")
+	D_star_lite_planner() { heapKeyCount = 20; useNodePool = false; expandcount = 0; seedGraphNode = NULL; targetStamp = 0; }
+	void setParams( int heapKeyCt=20 ) // call to this is optional.
+		{ heapKeyCount = heapKeyCt; }
+	// Allocate all nodes from a slab pool that is released in one go with the planner.
+	// Must be called before the first "init".
+	void setNodePooling(bool pool=true) { useNodePool = pool; }
+	void init( GraphDescriptorType* theEnv_p=NULL , bool createHashAndHeap=true );
+	void init( GraphDescriptorType theEnv ) { init(&theEnv); }
+	void clearLastPlanAndInit( GraphDescriptorType* theEnv_p=NULL );
+	void clearLastPlanAndInit( GraphDescriptorType theEnv ) { clearLastPlanAndInit(&theEnv); }
+	// Main planner function. Can be called again after any of the changes below.
+	void plan(void);
+	
+	// Changes between plans
+	void moveTarget(NodeType n);
+	bool moveSeed(NodeType n); // Returns false if 'n' is not in the search tree; then call 'clearLastPlanAndInit'.
+	void updateNodeCosts(NodeType n); // The transition costs from 'n' to its successors changed
+	
+	// Planner output access: ( to be called after plan(), and before destruction of planner )
+	// Paths go from the target (first) to the seed (last), like 'A_star_planner'.
+	std::vector< NodeType > getGoalNodes(void);
+	std::vector< CostType > getPlannedPathCosts(void);
+	std::vector< std::vector< NodeType > > getPlannedPaths(void);
+	
+private:
+	std::vector< unsigned char > subtreeMark; // Used by 'moveSeed', by node id; all 0 between calls
+	std::vector< GraphNode_p > chainGraphNodes, deletedGraphNodes;
+	std::vector< GraphNode_p > touchedGraphNodes; // Nodes initiated in the current generation, so 'moveSeed' only visits those
+	
+	static CostType _infinity(void) { return ( std::numeric_limits<CostType>::max() ); }
+	GraphNode_p _touch(GraphNode_p thisGraphNode);
+	void _generateSuccessors(GraphNode_p thisGraphNode);
+	CostType _linkCost(GraphNode_p fromGraphNode, GraphNode_p toGraphNode);
+	void _computeRhs(GraphNode_p thisGraphNode);
+	CostType _key(GraphNode_p thisGraphNode);
+	CostType _heuristics(GraphNode_p thisGraphNode);
+	void _updateState(GraphNode_p thisGraphNode);
+};
+
+// =====================================================================================
+
+#include "D_star_lite.cpp"
+
+#endif
+
@@ -0,0 +1,388 @@
+/******************************************************************************************
+*                                                                                        *
+*    Yet Another Graph-Search Based Planning Library (YAGSBPL)                           *
+*    A template-based C++ library for graph search and planning                          *
+*    Version 2.1                                                                         *
+*    ----------------------------------------------------------                          *
+*    Copyright (C) 2013  Subhrajit Bhattacharya                                          *
+*                                                                                        *
+*    This program is free software: you can redistribute it and/or modify                *
+*    it under the terms of the GNU General Public License as published by                *
+*    the Free Software Foundation, either version 3 of the License, or                   *
+*    (at your option) any later version.                                                 *
+*                                                                                        *
+*    This program is distributed in the hope that it will be useful,                     *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                      *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       *
+*    GNU General Public License for more details <http://www.gnu.org/licenses/>.         *
+*                                                                                        *
+*                                                                                        *
+*    Contact: subhrajit@gmail.com, http://subhrajit.net/                                 *
+*                                                                                        *
+*                                                                                        *
+******************************************************************************************/
+//    For a detailed tutorial and download, visit
+//    http://subhrajit.net/index.php?WPage=yagsbpl
+
+#include "playing.h"
+
+#define _yagsbpl_sign(x) (((x)>0) - ((x)<0))
+
+template <class AccessibleFunction>
+void JPS_jump_distances::build(int x0, int y0, int x1, int y1, AccessibleFunction accessible)
+{
+	xmin = x0; ymin = y0;
+	width = x1 - x0 + 3; height = y1 - y0 + 3;
+	access.assign(width * height, 0);
+	dist.assign(width * height * 8, 0);
+	for (int y=y0; y<=y1; y++)
+		for (int x=x0; x<=x1; x++)
+			access[ _cell(x, y) ] = accessible(x, y) ? 1 : 0;
+
+	// Straight directions first: a diagonal jump stops where a straight jump from the cell finds a jump point
+	static const int directions[8][2] = { {1,0}, {-1,0}, {0,1}, {0,-1}, {1,1}, {-1,1}, {1,-1}, {-1,-1} };
+	for (int d=0; d<8; d++)
+	{
+		int dx = directions[d][0], dy = directions[d][1];
+		// Against the direction, so that the cell a step leads to is done before the cell it starts from
+		int xFirst = (dx > 0) ? x1+1 : x0-1, xEnd = (dx > 0) ? x0-2 : x1+2, xStep = (dx > 0) ? -1 : 1;
+		int yFirst = (dy > 0) ? y1+1 : y0-1, yEnd = (dy > 0) ? y0-2 : y1+2, yStep = (dy > 0) ? -1 : 1;
+		for (int y=yFirst; y!=yEnd; y+=yStep)
+			for (int x=xFirst; x!=xEnd; x+=xStep)
+			{
+				int nx = x + dx, ny = y + dy, next;
+				short& v = dist[ _cell(x, y) * 8 + _direction(dx, dy) ];
+				if ( !isAccessible(nx, ny) )
+					v = 0;
+				else if ( _forced(nx, ny, dx, dy) || ( dx && dy && ( distance(nx, ny, dx, 0) > 0 || distance(nx, ny, 0, dy) > 0 ) ) )
+					v = 1;
+				else
+				{
+					next = distance(nx, ny, dx, dy);
+					v = (short)( (next > 0) ? next + 1 : next - 1 );
+				}
+			}
+	}
+}
+
+// Whether cell (x, y), entered in direction (dx, dy), has a forced neighbour (the tests of 'JPS_planner::_jump')
+inline bool JPS_jump_distances::_forced(int x, int y, int dx, int dy) const
+{
+	if (dx && dy)
+		return ( ( !isAccessible(x-dx, y) && isAccessible(x-dx, y+dy) ) || ( !isAccessible(x, y-dy) && isAccessible(x+dx, y-dy) ) );
+	if (dx)
+		return ( ( !isAccessible(x, y+1) && isAccessible(x+dx, y+1) ) || ( !isAccessible(x, y-1) && isAccessible(x+dx, y-1) ) );
+	return ( ( !isAccessible(x+1, y) && isAccessible(x+1, y+dy) ) || ( !isAccessible(x-1, y) && isAccessible(x-1, y+dy) ) );
+}
+
+// ==================================================================================
+
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void JPS_planner<NodeType,CostType,GraphClass,OpenListType>::init( GraphDescriptorType* theEnv_p, bool createHashAndHeap )
+{
+	GraphNode_p thisGraphNode;
+
+	if (theEnv_p && createHashAndHeap)
+	{
+		GenericPlannerInstance.init(*theEnv_p, heapKeyCount, useNodePool);  // This initiates the graph, hash and heap of the generic planner
+		accessCache.assign(theEnv_p->hashTableSize, 0);
+	}
+	else if (theEnv_p)
+	    *GenericPlannerInstance.GraphDescriptor = *theEnv_p;
+
+	// Remapping for coding convenience
+	GraphDescriptor = GenericPlannerInstance.GraphDescriptor;
+	hash = GenericPlannerInstance.hash;
+	heap = GenericPlannerInstance.heap;
+
+	// Init graph, clear the heap and clear stored paths just in case they not empty due to a previous planning
+	GraphDescriptor->init();
+	heap->clear();
+	bookmarkGraphNodes.clear();
+
+	for (size_t a=0; a<GraphDescriptor->SeedNodes.size(); a++)
+	{
+		thisGraphNode = hash->getNodeInHash( GraphDescriptor->SeedNodes[a] );
+
+		if ( !hash->nodeInitiated(thisGraphNode) )
+		{
+			thisGraphNode->came_from = NULL;
+			thisGraphNode->plannerVars.seedLineage = a;
+			thisGraphNode->plannerVars.g = (CostType)0;
+			thisGraphNode->plannerVars.expanded = false;
+			thisGraphNode->f = _heuristics( thisGraphNode->n.getX(), thisGraphNode->n.getY() );
+
+			if ( !_accessible( thisGraphNode->n.getX(), thisGraphNode->n.getY() ) )
+				controlPanel->addMessage("ERROR (JPS): At least one of the seed nodes is not accessible!");
+
+			hash->markInitiated(thisGraphNode); // Always set this when other variables have already been set
+		}
+
+		heap->push( thisGraphNode );
+	}
+}
+
+// -----------------------------
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void JPS_planner<NodeType,CostType,GraphClass,OpenListType>::clearLastPlanAndInit( GraphDescriptorType* theEnv_p )
+{
+	// Set every node in hash to not initiated in O(1). Cached accessibility is kept.
+	if (hash) {
+		hash->newGeneration();
+		init(theEnv_p ? theEnv_p : GraphDescriptor, false);
+	}
+	else
+		init(theEnv_p ? theEnv_p : GraphDescriptor);
+}
+
+// ==================================================================================
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+bool JPS_planner<NodeType,CostType,GraphClass,OpenListType>::_accessible(int x, int y)
+{
+	if (jumpDistances)
+		return ( jumpDistances->isAccessible(x, y) );
+	NodeType n(x, y);
+	unsigned char& cached = accessCache[ GraphDescriptor->_getHashBin(n) ];
+	if (!cached)
+		cached = GraphDescriptor->_isAccessible(n) ? 1 : 2;
+	return (cached == 1);
+}
+
+// Octile distance to the target, which is the exact cost on an empty grid
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+CostType JPS_planner<NodeType,CostType,GraphClass,OpenListType>::_heuristics(int x, int y)
+{
+	int dx = abs(GraphDescriptor->TargetNode.getX() - x);
+	int dy = abs(GraphDescriptor->TargetNode.getY() - y);
+	return ( (dx < dy) ? ( dx*diagonalCost + (dy-dx)*straightCost ) : ( dy*diagonalCost + (dx-dy)*straightCost ) );
+}
+
+// Step from (x, y) in direction (dx, dy) until a jump point is found (returned in (jx, jy)) or the way is blocked.
+//   A cell is a jump point if it is the target, has a forced neighbour, or (moving diagonally) a straight jump
+//   from it finds a jump point.
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+bool JPS_planner<NodeType,CostType,GraphClass,OpenListType>::_jump(int x, int y, int dx, int dy, int& jx, int& jy)
+{
+	if (jumpDistances)
+		return ( _jumpByDistances(x, y, dx, dy, jx, jy) );
+
+	int tx = GraphDescriptor->TargetNode.getX(), ty = GraphDescriptor->TargetNode.getY();
+	int sx, sy;
+
+	while (true)
+	{
+		x += dx;
+		y += dy;
+		if ( !_accessible(x, y) )
+			return false;
+		jx = x;
+		jy = y;
+		if ( x == tx && y == ty )
+			return true;
+
+		if (dx && dy)
+		{
+			if ( ( !_accessible(x-dx, y) && _accessible(x-dx, y+dy) ) || ( !_accessible(x, y-dy) && _accessible(x+dx, y-dy) ) )
+				return true;
+			if ( _jump(x, y, dx, 0, sx, sy) || _jump(x, y, 0, dy, sx, sy) )
+				return true;
+		}
+		else if (dx)
+		{
+			if ( ( !_accessible(x, y+1) && _accessible(x+dx, y+1) ) || ( !_accessible(x, y-1) && _accessible(x+dx, y-1) ) )
+				return true;
+		}
+		else
+		{
+			if ( ( !_accessible(x+1, y) && _accessible(x+1, y+dy) ) || ( !_accessible(x-1, y) && _accessible(x-1, y+dy) ) )
+				return true;
+		}
+	}
+}
+
+// Same as '_jump', in constant time: the precomputed distance gives the jump point that does not depend on the
+//   target, which is only closer if the target is on the way, or (moving diagonally) a straight jump from where
+//   the way crosses the target's row or column reaches it.
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+bool JPS_planner<NodeType,CostType,GraphClass,OpenListType>::_jumpByDistances(int x, int y, int dx, int dy, int& jx, int& jy)
+{
+	int tx = GraphDescriptor->TargetNode.getX(), ty = GraphDescriptor->TargetNode.getY();
+	int d = jumpDistances->distance(x, y, dx, dy);
+	int reach = (d > 0) ? d : -d; // steps that stay accessible
+	int stop = (d > 0) ? d : reach + 1; // steps to the jump point, more than reach for none
+	int k, off;
+
+	if (dx && dy)
+	{
+		k = (ty - y) * dy; // steps to the target's row, then along it
+		off = (tx - x - k*dx) * dx;
+		if ( k >= 1 && k < stop && ( off == 0 || ( off > 0 && off <= abs(jumpDistances->distance(x + k*dx, ty, dx, 0)) ) ) )
+			stop = k;
+		k = (tx - x) * dx; // steps to the target's column, then along it
+		off = (ty - y - k*dy) * dy;
+		if ( k >= 1 && k < stop && ( off == 0 || ( off > 0 && off <= abs(jumpDistances->distance(tx, y + k*dy, 0, dy)) ) ) )
+			stop = k;
+	}
+	else
+	{
+		k = dx ? (tx - x) * dx : (ty - y) * dy;
+		if ( (dx ? ty == y : tx == x) && k >= 1 && k < stop )
+			stop = k;
+	}
+	if (stop > reach)
+		return false;
+	jx = x + stop*dx;
+	jy = y + stop*dy;
+	return true;
+}
+
+// Jump from a node in one direction and relax the jump point found, if any
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void JPS_planner<NodeType,CostType,GraphClass,OpenListType>::_jumpAndUpdate(GraphNode_p thisGraphNode, int dx, int dy)
+{
+	int x = thisGraphNode->n.getX(), y = thisGraphNode->n.getY();
+	int jx, jy;
+	if ( !_jump(x, y, dx, dy, jx, jy) )
+		return;
+
+	int steps = (jx != x) ? abs(jx - x) : abs(jy - y);
+	CostType test_g_val = thisGraphNode->plannerVars.g + steps * ( (dx && dy) ? diagonalCost : straightCost );
+	GraphNode_p thisJumpGraphNode = hash->getNodeInHash( NodeType(jx, jy) );
+
+	if ( !hash->nodeInitiated(thisJumpGraphNode) )
+	{
+		thisJumpGraphNode->came_from = thisGraphNode;
+		thisJumpGraphNode->plannerVars.seedLineage = thisGraphNode->plannerVars.seedLineage;
+		thisJumpGraphNode->plannerVars.g = test_g_val;
+		thisJumpGraphNode->plannerVars.expanded = false;
+		thisJumpGraphNode->f = test_g_val + _heuristics(jx, jy);
+		hash->markInitiated(thisJumpGraphNode); // Always set this when other variables have already been set
+		heap->push( thisJumpGraphNode );
+	}
+	else if ( !thisJumpGraphNode->plannerVars.expanded && test_g_val < thisJumpGraphNode->plannerVars.g )
+	{
+		thisJumpGraphNode->came_from = thisGraphNode;
+		thisJumpGraphNode->plannerVars.seedLineage = thisGraphNode->plannerVars.seedLineage;
+		thisJumpGraphNode->plannerVars.g = test_g_val;
+		thisJumpGraphNode->f = test_g_val + _heuristics(jx, jy);
+		heap->update( thisJumpGraphNode );
+	}
+}
+
+// ==================================================================================
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void JPS_planner<NodeType,CostType,GraphClass,OpenListType>::plan(void)
+{
+	GraphNode_p thisGraphNode;
+	int x, y, dx, dy;
+
+	expandcount = 0;
+	while ( !heap->empty() )
+	{
+		// Get the node with least f-value
+		thisGraphNode = heap->pop();
+		thisGraphNode->plannerVars.expanded = true; // Put in closed list
+		expandcount++;
+
+		if ( thisGraphNode->n == GraphDescriptor->TargetNode )
+		{
+			bookmarkGraphNodes.push_back(thisGraphNode);
+			return;
+		}
+
+		x = thisGraphNode->n.getX();
+		y = thisGraphNode->n.getY();
+		if ( !thisGraphNode->came_from ) // Seed: search all 8 directions
+		{
+			for (dx=-1; dx<=1; dx++)
+				for (dy=-1; dy<=1; dy++)
+					if (dx || dy)
+						_jumpAndUpdate(thisGraphNode, dx, dy);
+			continue;
+		}
+
+		// Direction of travel into this node, and the natural and forced neighbours for it
+		dx = _yagsbpl_sign( x - thisGraphNode->came_from->n.getX() );
+		dy = _yagsbpl_sign( y - thisGraphNode->came_from->n.getY() );
+		if (dx && dy)
+		{
+			_jumpAndUpdate(thisGraphNode, dx, dy);
+			_jumpAndUpdate(thisGraphNode, dx, 0);
+			_jumpAndUpdate(thisGraphNode, 0, dy);
+			if ( !_accessible(x-dx, y) )
+				_jumpAndUpdate(thisGraphNode, -dx, dy);
+			if ( !_accessible(x, y-dy) )
+				_jumpAndUpdate(thisGraphNode, dx, -dy);
+		}
+		else if (dx)
+		{
+			_jumpAndUpdate(thisGraphNode, dx, 0);
+			if ( !_accessible(x, y+1) )
+				_jumpAndUpdate(thisGraphNode, dx, 1);
+			if ( !_accessible(x, y-1) )
+				_jumpAndUpdate(thisGraphNode, dx, -1);
+		}
+		else
+		{
+			_jumpAndUpdate(thisGraphNode, 0, dy);
+			if ( !_accessible(x+1, y) )
+				_jumpAndUpdate(thisGraphNode, 1, dy);
+			if ( !_accessible(x-1, y) )
+				_jumpAndUpdate(thisGraphNode, -1, dy);
+		}
+	}
+}
+
+// ==================================================================================
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+std::vector<NodeType> JPS_planner<NodeType,CostType,GraphClass,OpenListType>::getGoalNodes(void)
+{
+	std::vector<NodeType> ret;
+	for (size_t a=0; a<bookmarkGraphNodes.size(); a++)
+		ret.push_back(bookmarkGraphNodes[a]->n);
+	return (ret);
+}
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+std::vector<CostType> JPS_planner<NodeType,CostType,GraphClass,OpenListType>::getPlannedPathCosts(void)
+{
+	std::vector<CostType> costs;
+	for (size_t a=0; a<bookmarkGraphNodes.size(); a++)
+		costs.push_back(bookmarkGraphNodes[a]->plannerVars.g);
+	return (costs);
+}
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+std::vector< std::vector< NodeType > > JPS_planner<NodeType,CostType,GraphClass,OpenListType>::getPlannedPaths(void)
+{
+	std::vector< std::vector< NodeType > > paths;
+	std::vector< NodeType > thisPath;
+	for (size_t a=0; a<bookmarkGraphNodes.size(); a++)
+	{
+		thisPath.clear();
+		// Reconstruct path, filling in the cells between consecutive jump points
+		GraphNode_p thisGraphNode = bookmarkGraphNodes[a];
+		thisPath.push_back(thisGraphNode->n);
+		while (thisGraphNode->came_from)
+		{
+			int x = thisGraphNode->n.getX(), y = thisGraphNode->n.getY();
+			int px = thisGraphNode->came_from->n.getX(), py = thisGraphNode->came_from->n.getY();
+			int dx = _yagsbpl_sign(px - x), dy = _yagsbpl_sign(py - y);
+			while (x != px || y != py)
+			{
+				x += dx;
+				y += dy;
+				thisPath.push_back( NodeType(x, y) );
+			}
+			thisGraphNode = thisGraphNode->came_from;
+		}
+
+		paths.push_back(thisPath);
+	}
+	return (paths);
+}
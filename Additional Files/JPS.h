@@ -0,0 +1,158 @@
+/******************************************************************************************
+*                                                                                        *
+*    Yet Another Graph-Search Based Planning Library (YAGSBPL)                           *
+*    A template-based C++ library for graph search and planning                          *
+*    Version 2.1                                                                         *
+*    ----------------------------------------------------------                          *
+*    Copyright (C) 2013  Subhrajit Bhattacharya                                          *
+*                                                                                        *
+*    This program is free software: you can redistribute it and/or modify                *
+*    it under the terms of the GNU General Public License as published by                *
+*    the Free Software Foundation, either version 3 of the License, or                   *
+*    (at your option) any later version.                                                 *
+*                                                                                        *
+*    This program is distributed in the hope that it will be useful,                     *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                      *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       *
+*    GNU General Public License for more details <http://www.gnu.org/licenses/>.         *
+*                                                                                        *
+*                                                                                        *
+*    Contact: subhrajit@gmail.com, http://subhrajit.net/                                 *
+*                                                                                        *
+*                                                                                        *
+******************************************************************************************/
+//    For a detailed tutorial and download, visit
+//    http://subhrajit.net/index.php?WPage=yagsbpl
+
+
+#ifndef __JPS_2F585H2B321R_H_
+#define __JPS_2F585H2B321R_H_
+
+#include <stdio.h>
+#include <vector>
+#include <cmath>
+#include "../yagsbpl_base.h"
+
+// Jump Point Search (Harabor & Grastien, 2011) on an 8-connected grid with uniform costs: 'straightCost' for
+//   horizontal/vertical steps and 'diagonalCost' for diagonal steps, diagonals allowed past blocked corners.
+//   This is the graph 'getSuccessors' describes when every transition cost is one of these two values, and
+//   the planner finds paths of the same cost as 'A_star_planner' on it while expanding only jump points.
+// Requirements on the graph:
+//   - NodeType has 'getX()', 'getY()' and a constructor 'NodeType(int x, int y)'.
+//   - GraphClass provides 'getHashBin' and 'isAccessible' (see 'StaticSearchGraphDescriptor'). 'getHashBin' must be
+//     a perfect hash that also covers the ring of cells around the accessible area.
+//   - Accessibility does not change between plans of the same planner (it is cached per hash bin).
+//   'getSuccessors', 'getHeuristics' and 'stopSearch' are not used: the search stops at 'TargetNode' and uses
+//   the octile distance as heuristics.
+// Without jump distances (see 'JPS_jump_distances') every jump scans the grid cell by cell, so on open ground a
+//   plan costs in the order of the grid's area rather than the path's length.
+
+// Jump distances of a grid for 'JPS_planner' (JPS+, Harabor & Grastien, 2012): for every cell and each of the 8
+//   directions, the steps to the next jump point that does not depend on the target, or, where the way gets
+//   blocked first, the steps to the last accessible cell (stored as 0 or less). A jump then only has to look
+//   where the target's row and column cross it. Built once per grid, read by any number of planners.
+class JPS_jump_distances
+{
+public:
+	JPS_jump_distances() { xmin = ymin = 0; width = height = 0; }
+	// Cells (x, y) with xmin <= x <= xmax, ymin <= y <= ymax; 'accessible(x, y)' tells which can be entered.
+	//   Cells outside are not accessible.
+	template <class AccessibleFunction>
+	void build(int xmin, int ymin, int xmax, int ymax, AccessibleFunction accessible);
+	void clear(void) { width = height = 0; access.clear(); dist.clear(); }
+	bool isBuilt(void) const { return (width > 0); }
+
+	bool isAccessible(int x, int y) const { return (access[ _cell(x, y) ] != 0); }
+	// Steps from (x, y) in direction (dx, dy) to the next jump point (> 0), or minus the accessible steps (<= 0)
+	int distance(int x, int y, int dx, int dy) const { return dist[ _cell(x, y) * 8 + _direction(dx, dy) ]; }
+
+private:
+	// Cells are padded by a ring that is not accessible, so every jump ends inside
+	int _cell(int x, int y) const
+		{ return ( (x < xmin-1 || x > xmin+width-2 || y < ymin-1 || y > ymin+height-2) ? 0 : (y - ymin + 1) * width + (x - xmin + 1) ); }
+	static int _direction(int dx, int dy) { int d = (dy + 1) * 3 + (dx + 1); return (d < 4 ? d : d - 1); }
+	bool _forced(int x, int y, int dx, int dy) const;
+
+	int xmin, ymin, width, height; // of the padded grid
+	std::vector< unsigned char > access;
+	std::vector< short > dist; // 8 per cell
+};
+
+template <class CostType>
+class JPS_variables
+{
+public:
+	CostType g;
+	bool expanded; // Whether in closed list or not
+	int seedLineage; // stores which seed the node came from
+
+	JPS_variables() { expanded=false; }
+};
+
+template <class NodeType, class CostType, class GraphClass,
+			class OpenListType = typename DefaultOpenList< NodeType, CostType, JPS_variables<CostType> >::type >
+class JPS_planner
+{
+public:
+	typedef  SearchGraphNode< NodeType, CostType, JPS_variables<CostType> >*  GraphNode_p;
+	typedef  StaticSearchGraphDescriptor< NodeType, CostType, GraphClass >  GraphDescriptorType;
+
+	// Instance of generac planner
+	GenericPlanner< NodeType, CostType, JPS_variables<CostType>, OpenListType, GraphDescriptorType > GenericPlannerInstance;
+	// Re-mapping of generic planner variables for ease of use (coding convenience)
+	GraphDescriptorType* GraphDescriptor;
+	HashTableContainer<NodeType,CostType,JPS_variables<CostType>,GraphDescriptorType>* hash;
+	OpenListType* heap;
+
+	// Member variables
+	CostType straightCost, diagonalCost;
+	int heapKeyCount;
+	bool useNodePool;
+	std::vector< GraphNode_p > bookmarkGraphNodes;
+	int expandcount; // Number of jump points expanded by the last plan
+
+	// Initiator (called before "plan")
+	JPS_planner()
+	{
+		straightCost = (CostType)1; diagonalCost = (CostType)sqrt(2.0);
+		heapKeyCount = 20; useNodePool = false; expandcount = 0; jumpDistances = NULL;
+	}
+	void setParams( CostType straight=(CostType)1 , CostType diagonal=(CostType)sqrt(2.0) , int heapKeyCt=20 ) // call to this is optional.
+		{ straightCost = straight; diagonalCost = diagonal; heapKeyCount = heapKeyCt; }
+	// Allocate all nodes from a slab pool that is released in one go with the planner.
+	// Must be called before the first "init".
+	void setNodePooling(bool pool=true) { useNodePool = pool; }
+	// Jump with precomputed distances of the graph's accessible nodes instead of scanning, or NULL to scan.
+	//   Must describe the same accessibility as the graph; may change between plans.
+	void setJumpDistances(const JPS_jump_distances* distances) { jumpDistances = distances; }
+	void init( GraphDescriptorType* theEnv_p=NULL , bool createHashAndHeap=true );
+	void init( GraphDescriptorType theEnv ) { init(&theEnv); }
+	void clearLastPlanAndInit( GraphDescriptorType* theEnv_p=NULL );
+	void clearLastPlanAndInit( GraphDescriptorType theEnv ) { clearLastPlanAndInit(&theEnv); }
+	// Main planner function
+	void plan(void);
+
+	// Planner output access: ( to be called after plan(), and before destruction of planner )
+	// Paths list every grid cell from the goal (first) to the seed (last), like 'A_star_planner', not just the jump points.
+	std::vector< NodeType > getGoalNodes(void);
+	std::vector< CostType > getPlannedPathCosts(void);
+	std::vector< std::vector< NodeType > > getPlannedPaths(void);
+
+private:
+	// Accessibility by hash bin: 0 = not queried yet, 1 = accessible, 2 = not accessible
+	std::vector< unsigned char > accessCache;
+	const JPS_jump_distances* jumpDistances;
+
+	bool _accessible(int x, int y);
+	bool _jump(int x, int y, int dx, int dy, int& jx, int& jy);
+	bool _jumpByDistances(int x, int y, int dx, int dy, int& jx, int& jy);
+	void _jumpAndUpdate(GraphNode_p thisGraphNode, int dx, int dy);
+	CostType _heuristics(int x, int y);
+};
+
+// =====================================================================================
+
+#include "JPS.cpp"
+
+#endif
+
@@ -0,0 +1,249 @@
+/******************************************************************************************
+*                                                                                        *
+*    Yet Another Graph-Search Based Planning Library (YAGSBPL)                           *
+*    A template-based C++ library for graph search and planning                          *
+*    Version 2.1                                                                         *
+*    ----------------------------------------------------------                          *
+*    Copyright (C) 2013  Subhrajit Bhattacharya                                          *
+*                                                                                        *
+*    This program is free software: you can redistribute it and/or modify                *
+*    it under the terms of the GNU General Public License as published by                *
+*    the Free Software Foundation, either version 3 of the License, or                   *
+*    (at your option) any later version.                                                 *
+*                                                                                        *
+*    This program is distributed in the hope that it will be useful,                     *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                      *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       *
+*    GNU General Public License for more details <http://www.gnu.org/licenses/>.         *
+*                                                                                        *
+*                                                                                        *
+*    Contact: subhrajit@gmail.com, http://subhrajit.net/                                 *
+*                                                                                        *
+*                                                                                        *
+******************************************************************************************/
+//    For a detailed tutorial and download, visit
+//    http://subhrajit.net/index.php?WPage=yagsbpl
+
+#include "playing.h"
+
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void LazyThetaStar_planner<NodeType,CostType,GraphClass,OpenListType>::init( GraphDescriptorType* theEnv_p, bool createHashAndHeap )
+{
+	GraphNode_p thisGraphNode;
+
+	if (theEnv_p && createHashAndHeap)
+		GenericPlannerInstance.init(*theEnv_p, heapKeyCount, useNodePool);  // This initiates the graph, hash and heap of the generic planner
+	else if (theEnv_p)
+	    *GenericPlannerInstance.GraphDescriptor = *theEnv_p;
+
+	// Remapping for coding convenience
+	GraphDescriptor = GenericPlannerInstance.GraphDescriptor;
+	hash = GenericPlannerInstance.hash;
+	heap = GenericPlannerInstance.heap;
+
+	// Init graph, clear the heap and clear stored paths just in case they not empty due to a previous planning
+	GraphDescriptor->init();
+	heap->clear();
+	bookmarkGraphNodes.clear();
+
+	for (size_t a=0; a<GraphDescriptor->SeedNodes.size(); a++)
+	{
+		thisGraphNode = hash->getNodeInHash( GraphDescriptor->SeedNodes[a] );
+
+		if ( !hash->nodeInitiated(thisGraphNode) )
+		{
+			thisGraphNode->came_from = NULL;
+			thisGraphNode->plannerVars.seedLineage = a;
+			thisGraphNode->plannerVars.g = (CostType)0;
+			thisGraphNode->plannerVars.expanded = false;
+			thisGraphNode->plannerVars.accessible = true;
+			thisGraphNode->f = subopt_eps * GraphDescriptor->_getHeuristicsToTarget( thisGraphNode->n );
+
+			if ( !GraphDescriptor->_isAccessible( thisGraphNode->n ) )
+				controlPanel->addMessage("ERROR (Lazy_theta_star): At least one of the seed nodes is not accessible!");
+
+			hash->markInitiated(thisGraphNode); // Always set this when other variables have already been set
+		}
+
+		heap->push( thisGraphNode );
+	}
+}
+
+// -----------------------------
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void LazyThetaStar_planner<NodeType,CostType,GraphClass,OpenListType>::clearLastPlanAndInit( GraphDescriptorType* theEnv_p )
+{
+	// Set every node in hash to not initiated in O(1)
+	if (hash) {
+		hash->newGeneration();
+		init(theEnv_p ? theEnv_p : GraphDescriptor, false);
+	}
+	else
+		init(theEnv_p ? theEnv_p : GraphDescriptor);
+}
+
+// ==================================================================================
+
+// Node of the hash for n, initiated (as not reached yet) if it was not
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+typename LazyThetaStar_planner<NodeType,CostType,GraphClass,OpenListType>::GraphNode_p
+	LazyThetaStar_planner<NodeType,CostType,GraphClass,OpenListType>::_getNode(NodeType& n)
+{
+	GraphNode_p thisGraphNode = hash->getNodeInHash(n);
+	if ( !hash->nodeInitiated(thisGraphNode) )
+	{
+		thisGraphNode->came_from = NULL;
+		thisGraphNode->plannerVars.accessible = GraphDescriptor->_isAccessible( thisGraphNode->n );
+		thisGraphNode->plannerVars.expanded = false;
+		thisGraphNode->plannerVars.g = (CostType)0;
+		thisGraphNode->plannerVars.seedLineage = -1; // not reached yet
+		hash->markInitiated(thisGraphNode); // Always set this when other variables have already been set
+	}
+	return (thisGraphNode);
+}
+
+// The check deferred from '_updateVertex': if the parent of a node about to be expanded is not in line of sight
+//   after all, the node takes the expanded neighbour through which it is cheapest to reach (there is always one:
+//   the node that reached it).
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void LazyThetaStar_planner<NodeType,CostType,GraphClass,OpenListType>::_setVertex(GraphNode_p thisGraphNode)
+{
+	GraphNode_p parent = thisGraphNode->came_from, thisNeighbourGraphNode;
+	CostType test_g_val;
+	bool found = false;
+
+	if ( !parent )
+		return;
+	sightcount++;
+	if ( GraphDescriptor->graph->lineOfSight( parent->n , thisGraphNode->n ) )
+		return;
+
+	for (int a=0; a<succCount; a++)
+	{
+		thisNeighbourGraphNode = hash->getNodeInHash( succNodes[a] );
+		if ( !hash->nodeInitiated(thisNeighbourGraphNode) || !thisNeighbourGraphNode->plannerVars.expanded )
+			continue;
+		test_g_val = thisNeighbourGraphNode->plannerVars.g +
+						GraphDescriptor->graph->getSegmentCost( thisNeighbourGraphNode->n , thisGraphNode->n );
+		if ( !found || test_g_val < thisGraphNode->plannerVars.g )
+		{
+			thisGraphNode->came_from = thisNeighbourGraphNode;
+			thisGraphNode->plannerVars.seedLineage = thisNeighbourGraphNode->plannerVars.seedLineage;
+			thisGraphNode->plannerVars.g = test_g_val;
+			found = true;
+		}
+	}
+}
+
+// Relax a neighbour of the node being expanded, through the parent of that node (or the node itself if it is a seed),
+//   assuming line of sight from the parent
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void LazyThetaStar_planner<NodeType,CostType,GraphClass,OpenListType>::_updateVertex(GraphNode_p thisGraphNode, GraphNode_p thisNeighbourGraphNode)
+{
+	GraphNode_p parent = thisGraphNode->came_from ? thisGraphNode->came_from : thisGraphNode;
+	bool reached = thisNeighbourGraphNode->plannerVars.seedLineage >= 0;
+
+	// Already reached from the same parent: the segment (usually the longest part of the cost) is the same
+	if ( reached && thisNeighbourGraphNode->came_from == parent )
+		return;
+	CostType test_g_val = parent->plannerVars.g + GraphDescriptor->graph->getSegmentCost( parent->n , thisNeighbourGraphNode->n );
+	if ( reached && test_g_val >= thisNeighbourGraphNode->plannerVars.g )
+		return;
+	thisNeighbourGraphNode->came_from = parent;
+	thisNeighbourGraphNode->plannerVars.seedLineage = parent->plannerVars.seedLineage;
+	thisNeighbourGraphNode->plannerVars.g = test_g_val;
+	thisNeighbourGraphNode->f = test_g_val + subopt_eps * GraphDescriptor->_getHeuristicsToTarget( thisNeighbourGraphNode->n );
+	if ( thisNeighbourGraphNode->inHeap )
+		heap->update( thisNeighbourGraphNode );
+	else
+		heap->push( thisNeighbourGraphNode );
+}
+
+// ==================================================================================
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+void LazyThetaStar_planner<NodeType,CostType,GraphClass,OpenListType>::plan(void)
+{
+	GraphNode_p thisGraphNode, thisNeighbourGraphNode;
+	int a;
+
+	expandcount = 0;
+	sightcount = 0;
+	while ( !heap->empty() )
+	{
+		// Get the node with least f-value
+		thisGraphNode = heap->pop();
+		expandcount++;
+
+		// Its neighbours, needed both to fix its parent and to expand it
+		if (GraphDescriptorType::hasSuccessorSpan)
+		{
+			successorSpan.clear();
+			GraphDescriptor->_getSuccessorSpan( thisGraphNode->n , &successorSpan );
+			succNodes = successorSpan.nodes;
+			succCount = successorSpan.size();
+		}
+		else
+		{
+			successors.clear();
+			successorCosts.clear();
+			GraphDescriptor->_getSuccessors( thisGraphNode->n , &successors , &successorCosts );
+			succNodes = successors.empty() ? NULL : &successors[0];
+			succCount = successors.size();
+		}
+
+		_setVertex( thisGraphNode );
+		thisGraphNode->plannerVars.expanded = true; // Put in closed list
+
+		// Check if we need to stop furthur expansion
+		if ( GraphDescriptor->_stopSearch( thisGraphNode->n ) )
+		{
+			bookmarkGraphNodes.push_back(thisGraphNode);
+			return;
+		}
+
+		for (a=0; a<succCount; a++)
+		{
+			thisNeighbourGraphNode = _getNode( succNodes[a] );
+			if ( thisNeighbourGraphNode->plannerVars.accessible && !thisNeighbourGraphNode->plannerVars.expanded )
+				_updateVertex( thisGraphNode, thisNeighbourGraphNode );
+		}
+	}
+}
+
+// ==================================================================================
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+std::vector<NodeType> LazyThetaStar_planner<NodeType,CostType,GraphClass,OpenListType>::getGoalNodes(void)
+{
+	std::vector<NodeType> ret;
+	for (size_t a=0; a<bookmarkGraphNodes.size(); a++)
+		ret.push_back(bookmarkGraphNodes[a]->n);
+	return (ret);
+}
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+std::vector<CostType> LazyThetaStar_planner<NodeType,CostType,GraphClass,OpenListType>::getPlannedPathCosts(void)
+{
+	std::vector<CostType> costs;
+	for (size_t a=0; a<bookmarkGraphNodes.size(); a++)
+		costs.push_back(bookmarkGraphNodes[a]->plannerVars.g);
+	return (costs);
+}
+
+template <class NodeType, class CostType, class GraphClass, class OpenListType>
+std::vector< std::vector< NodeType > > LazyThetaStar_planner<NodeType,CostType,GraphClass,OpenListType>::getPlannedPaths(void)
+{
+	std::vector< std::vector< NodeType > > paths;
+	std::vector< NodeType > thisPath;
+	for (size_t a=0; a<bookmarkGraphNodes.size(); a++)
+	{
+		thisPath.clear();
+		for (GraphNode_p thisGraphNode = bookmarkGraphNodes[a]; thisGraphNode; thisGraphNode = thisGraphNode->came_from)
+			thisPath.push_back(thisGraphNode->n);
+		paths.push_back(thisPath);
+	}
+	return (paths);
+}
@@ -0,0 +1,118 @@
+/******************************************************************************************
+*                                                                                        *
+*    Yet Another Graph-Search Based Planning Library (YAGSBPL)                           *
+*    A template-based C++ library for graph search and planning                          *
+*    Version 2.1                                                                         *
+*    ----------------------------------------------------------                          *
+*    Copyright (C) 2013  Subhrajit Bhattacharya                                          *
+*                                                                                        *
+*    This program is free software: you can redistribute it and/or modify                *
+*    it under the terms of the GNU General Public License as published by                *
+*    the Free Software Foundation, either version 3 of the License, or                   *
+*    (at your option) any later version.                                                 *
+*                                                                                        *
+*    This program is distributed in the hope that it will be useful,                     *
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of                      *
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       *
+*    GNU General Public License for more details <http://www.gnu.org/licenses/>.         *
+*                                                                                        *
+*                                                                                        *
+*    Contact: subhrajit@gmail.com, http://subhrajit.net/                                 *
+*                                                                                        *
+*                                                                                        *
+******************************************************************************************/
+//    For a detailed tutorial and download, visit
+//    http://subhrajit.net/index.php?WPage=yagsbpl
+
+
+#ifndef __LAZY_THETA_STAR_7A2E90C4D1F3_H_
+#define __LAZY_THETA_STAR_7A2E90C4D1F3_H_
+
+#include <stdio.h>
+#include <vector>
+#include "../yagsbpl_base.h"
+
+// Lazy Theta* (Nash, Koenig & Tovey, 2010): any-angle paths on an 8-connected grid. A node's parent need
+//   not be its neighbour: a node reached from s gets s's parent, assuming line of sight, and the assumption is
+//   only checked when the node is expanded. If the line of sight is blocked then, the parent falls back to the
+//   best expanded neighbour, as in 'A_star_planner'. Paths list only the nodes where they turn.
+// Requirements on the graph:
+//   - GraphClass provides 'getHashBin', 'isAccessible' and 'getSuccessors' or 'getSuccessorSpan' (see
+//     'StaticSearchGraphDescriptor'); only the nodes of the successors are used.
+//   - GraphClass also provides 'bool lineOfSight(NodeType& a, NodeType& b)' and
+//     'CostType getSegmentCost(NodeType& a, NodeType& b)', the cost of the straight line from a to b. For neighbours,
+//     the segment cost must be the transition cost from a to b.
+//   The search stops at the nodes for which 'stopSearch' is true and uses 'getHeuristics'.
+
+template <class CostType>
+class LazyThetaStar_variables
+{
+public:
+	CostType g;
+	bool accessible; // Since the 'accessible' function is called for each node only once, we store the result
+	bool expanded; // Whether in closed list or not
+	int seedLineage; // stores which seed the node came from, -1 until the node is reached
+
+	LazyThetaStar_variables() { expanded=false; seedLineage=-1; }
+};
+
+template <class NodeType, class CostType, class GraphClass,
+			class OpenListType = typename DefaultOpenList< NodeType, CostType, LazyThetaStar_variables<CostType> >::type >
+class LazyThetaStar_planner
+{
+public:
+	typedef  SearchGraphNode< NodeType, CostType, LazyThetaStar_variables<CostType> >*  GraphNode_p;
+	typedef  StaticSearchGraphDescriptor< NodeType, CostType, GraphClass >  GraphDescriptorType;
+
+	// Instance of generac planner
+	GenericPlanner< NodeType, CostType, LazyThetaStar_variables<CostType>, OpenListType, GraphDescriptorType > GenericPlannerInstance;
+	// Re-mapping of generic planner variables for ease of use (coding convenience)
+	GraphDescriptorType* GraphDescriptor;
+	HashTableContainer<NodeType,CostType,LazyThetaStar_variables<CostType>,GraphDescriptorType>* hash;
+	OpenListType* heap;
+
+	// Member variables
+	double subopt_eps;
+	int heapKeyCount;
+	bool useNodePool;
+	std::vector< GraphNode_p > bookmarkGraphNodes;
+	int expandcount; // Number of nodes expanded by the last plan
+	int sightcount; // Number of line of sight checks made by the last plan
+
+	// Initiator (called before "plan")
+	LazyThetaStar_planner() { subopt_eps = 1.0; heapKeyCount = 20; useNodePool = false; expandcount = sightcount = 0; }
+	void setParams( double eps=1.0 , int heapKeyCt=20 ) // call to this is optional.
+		{ subopt_eps = eps; heapKeyCount = heapKeyCt; }
+	// Allocate all nodes from a slab pool that is released in one go with the planner.
+	// Must be called before the first "init".
+	void setNodePooling(bool pool=true) { useNodePool = pool; }
+	void init( GraphDescriptorType* theEnv_p=NULL , bool createHashAndHeap=true );
+	void init( GraphDescriptorType theEnv ) { init(&theEnv); }
+	void clearLastPlanAndInit( GraphDescriptorType* theEnv_p=NULL );
+	void clearLastPlanAndInit( GraphDescriptorType theEnv ) { clearLastPlanAndInit(&theEnv); }
+	// Main planner function
+	void plan(void);
+
+	// Planner output access: ( to be called after plan(), and before destruction of planner )
+	// Paths go from the goal (first) to the seed (last) and list the nodes where they turn.
+	std::vector< NodeType > getGoalNodes(void);
+	std::vector< CostType > getPlannedPathCosts(void);
+	std::vector< std::vector< NodeType > > getPlannedPaths(void);
+
+private:
+	GraphNode_p _getNode(NodeType& n); // node in hash, initiated if it was not
+	void _setVertex(GraphNode_p thisGraphNode);
+	void _updateVertex(GraphNode_p thisGraphNode, GraphNode_p thisNeighbourGraphNode);
+
+	typename GraphDescriptorType::SuccessorSpanType successorSpan; // reused for every expansion
+	std::vector< NodeType > successors; // same, for graphs without 'getSuccessorSpan'
+	std::vector< CostType > successorCosts;
+	NodeType* succNodes; // successors of the node being expanded, in one of the above
+	int succCount;
+};
+
+// =====================================================================================
+
+#include "Lazy_theta_star.cpp"
+
+#endif
@@ -81,6 +81,8 @@
 #include "Roaming.h"
 #include "RobotPlayer.h"
 #include "Roster.h"
+#include "AIScheduler.h"
+#include "WorldView.h"
 #include "SceneBuilder.h"
 #include "ScoreboardRenderer.h"
 #include "sound.h"
@@ -2094,7 +2096,7 @@ static void		handleServerMessage(bool human, uint16_t code,
 	  for (int r = 0; r < numRobots; r++) {
 	    if (robots[r] && robots[r]->getId() == playerIndex) {
 	      robots[r]->restart(pos,forward);
-	      setRobotTarget(robots[r]);
+	      AIScheduler::makeUrgent(r); // retargeted in the next update
 	      break;
 	    }
 	  }
@@ -4289,36 +4291,30 @@ static void		setRobotTarget(RobotPlayer* robot)
 
 static void		updateRobots(float dt)
 {
-  static float newTargetTimeout = 1.0f;
-  static float clock = 0.0f;
-  bool pickTarget = false;
   int i;
 
-  // see if we should look for new targets
-  clock += dt;
-  if (clock > newTargetTimeout) {
-    while (clock > newTargetTimeout) {
-      clock -= newTargetTimeout;
-    }
-    pickTarget = true;
+  // paths planned since the last update
+  RobotPlayer::deliverPlans();
+  // the players, flags and shots the robots see this tick, and the costs around the flags and enemies
+  {
+    AI_PROFILE_SCOPE(AIProfile::PERCEPTION);
+    WorldView::update();
+    InfluenceMap::update();
   }
 
-  // start dead robots
-  for (i = 0; i < numRobots; i++) {
-    if (!gameOver && robots[i]
-	&& !robots[i]->isAlive() && !robots[i]->isExploding() && pickTarget) {
+  // retarget live robots and start dead ones on their turns, spread over the frames
+  AIScheduler::beginFrame(dt);
+  for (i = AIScheduler::nextRobot(); i >= 0; i = AIScheduler::nextRobot()) {
+    if (robots[i]->isAlive()) {
+      setRobotTarget(robots[i]);
+    }
+    else if (!gameOver) { // not while exploding (see AIScheduler)
       robotServer[i]->sendAlive();
     }
   }
 
-  // retarget robots
-  for (i = 0; i < numRobots; i++) {
-    if (robots[i] && robots[i]->isAlive()
-	&& (pickTarget || !robots[i]->getTarget()
-	    || !robots[i]->getTarget()->isAlive())) {
-      setRobotTarget(robots[i]);
-    }
-  }
+  // all robots decide on the world as it is now, on several threads, then act one at a time
+  RobotPlayer::decideAll(dt);
 
   // do updates
   for (i = 0; i < numRobots; i++)
@@ -27,6 +27,98 @@
 
 #define f_val(ptr) ( (ptr)->f ) 
 
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+void NodeLinks<NodeType,CostType,PlannerSpecificVariables>::init
+						(int count, SearchGraphNodePool<NodeType,CostType,PlannerSpecificVariables>* pool)
+{
+	if (targets && !pooled) { // Re-initiated links (e.g. successor count changed between plans)
+		delete[] targets;
+		delete[] costs;
+	}
+	this->count = count;
+	capacity = count;
+	pooled = (pool != NULL);
+	if (pooled) {
+		targets = pool->template newArray< SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* >(count);
+		costs = pool->template newArray<CostType>(count);
+	}
+	else {
+		targets = new SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* [count];
+		costs = new CostType [count];
+	}
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+void NodeLinks<NodeType,CostType,PlannerSpecificVariables>::push_back
+						( SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* node_p , CostType cost )
+{
+	if (count == capacity) {
+		// Grow the arrays. Pooled arrays are simply abandoned in the pool.
+		int newCapacity = (capacity > 0) ? 2*capacity : 8;
+		SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>** newTargets = 
+											new SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* [newCapacity];
+		CostType* newCosts = new CostType [newCapacity];
+		for (int a=0; a<count; a++) {
+			newTargets[a] = targets[a];
+			newCosts[a] = costs[a];
+		}
+		if (!pooled) { delete[] targets; delete[] costs; }
+		targets = newTargets; costs = newCosts;
+		capacity = newCapacity;
+		pooled = false;
+	}
+	targets[count] = node_p;
+	costs[count] = cost;
+	count++;
+}
+
+// =================================================================================
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+SearchGraphNodePool<NodeType,CostType,PlannerSpecificVariables>::SearchGraphNodePool(int nodesPerSlab)
+{
+	slabBytes = nodesPerSlab * sizeof(GraphNode);
+	currentSlab = 0;
+	slabUsed = 0;
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+void* SearchGraphNodePool<NodeType,CostType,PlannerSpecificVariables>::allocate(size_t bytes)
+{
+	const size_t align = sizeof(void*) > sizeof(CostType) ? sizeof(void*) : sizeof(CostType);
+	bytes = (bytes + align - 1) & ~(align - 1);
+	if (bytes > slabBytes) // Larger than any slab: give it a slab of its own, placed before the current one
+	{
+		char* bigSlab = (char*)malloc(bytes);
+		if (!bigSlab)
+			throw std::bad_alloc();
+		slabs.insert(slabs.begin() + currentSlab, bigSlab);
+		currentSlab++;
+		return (bigSlab);
+	}
+	if (slabs.empty() || slabUsed + bytes > slabBytes)
+	{
+		if (!slabs.empty()) currentSlab++;
+		if (currentSlab >= slabs.size())
+		{
+			char* slab = (char*)malloc(slabBytes);
+			if (!slab)
+				throw std::bad_alloc();
+			slabs.push_back(slab);
+		}
+		slabUsed = 0;
+	}
+	void* ret = slabs[currentSlab] + slabUsed;
+	slabUsed += bytes;
+	return (ret);
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* SearchGraphNodePool<NodeType,CostType,PlannerSpecificVariables>::newNode(void)
+{
+	return ( new (allocate(sizeof(GraphNode))) GraphNode );
+}
+
 template <class NodeType, class CostType, class PlannerSpecificVariables>
 void HeapContainer<NodeType,CostType,PlannerSpecificVariables>::update (heapItem_p np, BubbleDirection bubdir)
 {
@@ -117,6 +209,237 @@ void HeapContainer<NodeType,CostType,PlannerSpecificVariables>::remove (SearchGr
 	np->h = tmp_h;
 }
 
+// D_ARY_HEAP -------------------------------------------------------
+
+template <class NodeType, class CostType, class PlannerSpecificVariables, int Arity>
+void DaryHeapContainer<NodeType,CostType,PlannerSpecificVariables,Arity>::siftUp(int pos, HeapEntry e)
+{
+	// Move the hole up until 'e' fits
+	while (pos > 0)
+	{
+		int parentPos = (pos - 1) / Arity;
+		if ( !(e.f < heapArray[parentPos].f) )
+			break;
+		heapArray[pos] = heapArray[parentPos];
+		heapPos[heapArray[pos].node] = pos;
+		pos = parentPos;
+	}
+	heapArray[pos] = e;
+	heapPos[e.node] = pos;
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables, int Arity>
+void DaryHeapContainer<NodeType,CostType,PlannerSpecificVariables,Arity>::siftDown(int pos, HeapEntry e)
+{
+	// Move the hole down until 'e' fits
+	int n = heapArray.size();
+	while (true)
+	{
+		int firstChildPos = Arity*pos + 1;
+		if (firstChildPos >= n)
+			break;
+		int lastChildPos = (firstChildPos + Arity < n) ? firstChildPos + Arity : n;
+		int bestChildPos = firstChildPos;
+		for (int c=firstChildPos+1; c<lastChildPos; c++)
+			if ( heapArray[c].f < heapArray[bestChildPos].f )
+				bestChildPos = c;
+		if ( !(heapArray[bestChildPos].f < e.f) )
+			break;
+		heapArray[pos] = heapArray[bestChildPos];
+		heapPos[heapArray[pos].node] = pos;
+		pos = bestChildPos;
+	}
+	heapArray[pos] = e;
+	heapPos[e.node] = pos;
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables, int Arity>
+void DaryHeapContainer<NodeType,CostType,PlannerSpecificVariables,Arity>::push
+									( SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* np )
+{
+	// Assumes np is not in heap. No check is done for that.
+	if (np->id >= heapPos.size())
+		heapPos.resize( (np->id + 1 > 2*heapPos.size()) ? np->id + 1 : 2*heapPos.size() , -1 );
+	HeapEntry e;
+	e.f = np->f;
+	e.node = np->id;
+	np->inHeap = true;
+	heapArray.push_back(e);
+	siftUp(heapArray.size() - 1, e);
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables, int Arity>
+SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* DaryHeapContainer<NodeType,CostType,PlannerSpecificVariables,Arity>::pop(void)
+{
+	unsigned int top = heapArray[0].node;
+	heapPos[top] = -1;
+	HeapEntry last = heapArray.back();
+	heapArray.pop_back();
+	if (!heapArray.empty())
+		siftDown(0, last);
+	
+	heapItem_p ret = nodeTable->getNodeByIndex(top);
+	ret->inHeap = false;
+	return (ret);
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables, int Arity>
+void DaryHeapContainer<NodeType,CostType,PlannerSpecificVariables,Arity>::update (heapItem_p np, BubbleDirection bubdir)
+{
+	if (np->id >= heapPos.size() || heapPos[np->id] < 0) return;
+	int pos = heapPos[np->id];
+	HeapEntry e = heapArray[pos];
+	bool decreased = (np->f < e.f);
+	e.f = np->f;
+	if (decreased && bubdir != DOWNONLY_BUBDIR)
+		siftUp(pos, e);
+	else if (!decreased && bubdir != UPONLY_BUBDIR)
+		siftDown(pos, e);
+	else
+		heapArray[pos] = e;
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables, int Arity>
+void DaryHeapContainer<NodeType,CostType,PlannerSpecificVariables,Arity>::remove (heapItem_p np)
+{
+	if (np->id >= heapPos.size() || heapPos[np->id] < 0) return;
+	int pos = heapPos[np->id];
+	heapPos[np->id] = -1;
+	np->inHeap = false;
+	HeapEntry last = heapArray.back();
+	heapArray.pop_back();
+	if (pos == (int)heapArray.size())
+		return;
+	// The last entry fills the hole. It may have to go either way.
+	if (pos > 0 && last.f < heapArray[(pos - 1) / Arity].f)
+		siftUp(pos, last);
+	else
+		siftDown(pos, last);
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables, int Arity>
+void DaryHeapContainer<NodeType,CostType,PlannerSpecificVariables,Arity>::clear(void)
+{
+	for (size_t a=0; a<heapArray.size(); a++) {
+		heapPos[heapArray[a].node] = -1;
+		nodeTable->getNodeByIndex(heapArray[a].node)->inHeap = false;
+	}
+	heapArray.clear();
+}
+
+// RADIX_HEAP -------------------------------------------------------
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+int RadixHeapContainer<NodeType,CostType,PlannerSpecificVariables>::bucketIndex(unsigned long long key)
+{
+	// 0 if key == lastKey, otherwise 1 + position of the highest bit in which they differ
+	unsigned long long diff = key ^ lastKey;
+	int b = 0;
+	while (diff) { diff >>= 1; b++; }
+	return (b);
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+void RadixHeapContainer<NodeType,CostType,PlannerSpecificVariables>::insert(unsigned long long key, unsigned int node)
+{
+	if (key < lastKey) key = lastKey; // Keep monotone
+	int b = bucketIndex(key);
+	HeapEntry e;
+	e.key = key;
+	e.node = node;
+	bucketOf[node] = b;
+	slotOf[node] = buckets[b].size();
+	buckets[b].push_back(e);
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+void RadixHeapContainer<NodeType,CostType,PlannerSpecificVariables>::erase(unsigned int node)
+{
+	// Swap with the last entry of the bucket
+	std::vector<HeapEntry>& bucket = buckets[bucketOf[node]];
+	int slot = slotOf[node];
+	bucket[slot] = bucket.back();
+	slotOf[bucket[slot].node] = slot;
+	bucket.pop_back();
+	bucketOf[node] = -1;
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+void RadixHeapContainer<NodeType,CostType,PlannerSpecificVariables>::push
+									( SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* np )
+{
+	// Assumes np is not in heap. No check is done for that.
+	if (np->id >= bucketOf.size()) {
+		int newSize = (np->id + 1 > 2*bucketOf.size()) ? np->id + 1 : 2*bucketOf.size();
+		bucketOf.resize(newSize, -1);
+		slotOf.resize(newSize);
+	}
+	insert( (unsigned long long)(np->f < 0 ? 0 : np->f), np->id );
+	np->inHeap = true;
+	heap_size++;
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* RadixHeapContainer<NodeType,CostType,PlannerSpecificVariables>::pop(void)
+{
+	if (buckets[0].empty())
+	{
+		// Move the smallest key of the first non-empty bucket to 'lastKey' and redistribute that bucket.
+		// Every entry lands in a lower bucket, which is what makes pops cheap on average.
+		int b = 1;
+		while (buckets[b].empty()) b++;
+		unsigned long long minKey = buckets[b][0].key;
+		for (size_t a=1; a<buckets[b].size(); a++)
+			if (buckets[b][a].key < minKey)
+				minKey = buckets[b][a].key;
+		lastKey = minKey;
+		std::vector<HeapEntry> moving;
+		moving.swap(buckets[b]);
+		for (size_t a=0; a<moving.size(); a++)
+			insert(moving[a].key, moving[a].node);
+	}
+	
+	unsigned int top = buckets[0].back().node;
+	buckets[0].pop_back();
+	bucketOf[top] = -1;
+	heap_size--;
+	
+	heapItem_p ret = nodeTable->getNodeByIndex(top);
+	ret->inHeap = false;
+	return (ret);
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+void RadixHeapContainer<NodeType,CostType,PlannerSpecificVariables>::update (heapItem_p np, BubbleDirection)
+{
+	if (np->id >= bucketOf.size() || bucketOf[np->id] < 0) return;
+	erase(np->id);
+	insert( (unsigned long long)(np->f < 0 ? 0 : np->f), np->id );
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+void RadixHeapContainer<NodeType,CostType,PlannerSpecificVariables>::remove (heapItem_p np)
+{
+	if (np->id >= bucketOf.size() || bucketOf[np->id] < 0) return;
+	erase(np->id);
+	np->inHeap = false;
+	heap_size--;
+}
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+void RadixHeapContainer<NodeType,CostType,PlannerSpecificVariables>::clear(void)
+{
+	for (int b=0; b<NUM_BUCKETS; b++) {
+		for (size_t a=0; a<buckets[b].size(); a++) {
+			bucketOf[buckets[b][a].node] = -1;
+			nodeTable->getNodeByIndex(buckets[b][a].node)->inHeap = false;
+		}
+		buckets[b].clear();
+	}
+	heap_size = 0;
+	lastKey = 0;
+}
+
 // =================================================================================
 
 
@@ -124,6 +447,8 @@ template <class NodeType, class CostType>
 GenericSearchGraphDescriptor<NodeType,CostType>::GenericSearchGraphDescriptor()
 {
 	hashBinSizeIncreaseStep = 128;
+	perfectHash = false;
+	cacheSuccessorCosts = true;
 	// Initiating pointers to all functions as NULL - makes easy to check if a function was defined
 	getHashBin_fp = NULL;
 	isAccessible_fp = NULL;
@@ -262,30 +587,77 @@ bool GenericSearchGraphDescriptor<NodeType,CostType>::_stopSearch(NodeType& n)
 
 
 template <class NodeType, class CostType, class PlannerSpecificVariables>
-void HashTableContainer<NodeType,CostType,PlannerSpecificVariables>::init_HastTable(int hash_table_size)
+void NodeTableContainer<NodeType,CostType,PlannerSpecificVariables>::newGeneration(void)
+{
+	if (++generation == 0)
+	{
+		// Counter wrapped around: old stamps could look current again, so clear them once
+		for (size_t a=0; a<nodeCount(); a++)
+			getNodeByIndex(a)->generation = 0;
+		generation = 1;
+	}
+}
+
+// ---------------------------------
+
+template <class NodeType, class CostType, class PlannerSpecificVariables, class GraphDescriptorType>
+void HashTableContainer<NodeType,CostType,PlannerSpecificVariables,GraphDescriptorType>::init_HastTable(int hash_table_size)
 {
 	hashTableSize = hash_table_size;
+	if (friendGraphDescriptor_p->perfectHash)
+	{
+		// One zeroed word per bin. No per-bin allocations.
+		this->DenseTable = (unsigned int*)calloc(hashTableSize, sizeof(unsigned int));
+		if (!this->DenseTable)
+			throw std::bad_alloc();
+		return;
+	}
 	HashTable = new std::vector< SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* > [ hashTableSize ];
 	for (int a=0; a<hashTableSize; a++)
 		if ( HashTable[a].capacity() >= HashTable[a].size()-1 )
 			HashTable[a].reserve( HashTable[a].capacity() + friendGraphDescriptor_p->hashBinSizeIncreaseStep );
 }
 
-template <class NodeType, class CostType, class PlannerSpecificVariables>
+template <class NodeType, class CostType, class PlannerSpecificVariables, class GraphDescriptorType>
 SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* 
-	HashTableContainer<NodeType,CostType,PlannerSpecificVariables>::getNodeInHash(NodeType n)
+	HashTableContainer<NodeType,CostType,PlannerSpecificVariables,GraphDescriptorType>::getNodeInHash(NodeType n)
 {
 	// Search in bin
 	int hashBin = friendGraphDescriptor_p->_getHashBin(n);
+	
+	if (this->DenseTable)
+	{
+		// A SIGSEGV signal generated from here most likely 'getHashBin' returned a bin index larger than (hashTableSize-1).
+		unsigned int slot = this->DenseTable[hashBin];
+		if (slot)
+			return ( this->getNodeByIndex(slot-1) );
+		
+		// If new node, create it in the current chunk
+		if ( (this->denseNodeCount >> _YAGSBPL_DENSE_CHUNK_SHIFT) >= this->denseChunks.size() )
+		{
+			GraphNode* chunk = (GraphNode*)malloc(_YAGSBPL_DENSE_CHUNK_SIZE * sizeof(GraphNode));
+			if (!chunk)
+				throw std::bad_alloc();
+			this->denseChunks.push_back(chunk);
+		}
+		GraphNode* newSearchGraphNode = new (this->getNodeByIndex(this->denseNodeCount)) GraphNode;
+		newSearchGraphNode->n = n; // WARNING: Nothing else is set yet!
+		newSearchGraphNode->id = this->denseNodeCount;
+		this->DenseTable[hashBin] = ++this->denseNodeCount;
+		return ( newSearchGraphNode );
+	}
+	
 	// A SIGSEGV signal generated from here most likely 'getHashBin' returned a bin index larger than (hashTableSize-1).
 	for (int a=0; a<HashTable[hashBin].size(); a++)
 		if ( HashTable[hashBin][a]->n == n )
 			return (HashTable[hashBin][a]);
 	
 	// If new node, create it!
-	SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* newSearchGraphNode = 
+	SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* newSearchGraphNode = this->nodePool ? this->nodePool->newNode() :
 															new SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>;
 	newSearchGraphNode->n = n; // WARNING: Nothing else is set yet!
+	newSearchGraphNode->id = this->nodeById.size();
+	this->nodeById.push_back(newSearchGraphNode);
 	if ( HashTable[hashBin].capacity() <= HashTable[hashBin].size()+1 )
 		HashTable[hashBin].reserve( HashTable[hashBin].capacity() + friendGraphDescriptor_p->hashBinSizeIncreaseStep );
 	HashTable[hashBin].push_back(newSearchGraphNode);
@@ -295,20 +667,25 @@ SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>*
 // =================================================================================
 
 
-template <class NodeType, class CostType, class PlannerSpecificVariables>
-void GenericPlanner<NodeType,CostType,PlannerSpecificVariables>::init
-						( GenericSearchGraphDescriptor<NodeType,CostType> theEnv , int heapKeyNum )
+template <class NodeType, class CostType, class PlannerSpecificVariables, class HeapType, class GraphDescriptorType>
+void GenericPlanner<NodeType,CostType,PlannerSpecificVariables,HeapType,GraphDescriptorType>::init
+						( GraphDescriptorType theEnv , int heapKeyNum , bool useNodePool )
 {
     //_yagsbpl_display_version;
     
-	GraphDescriptor = new GenericSearchGraphDescriptor<NodeType,CostType>;
+	GraphDescriptor = new GraphDescriptorType;
 	*GraphDescriptor = theEnv;
 	
-	hash = new HashTableContainer<NodeType,CostType,PlannerSpecificVariables>;
+	if (useNodePool)
+		nodePool = new SearchGraphNodePool<NodeType,CostType,PlannerSpecificVariables>;
+	
+	hash = new HashTableContainer<NodeType,CostType,PlannerSpecificVariables,GraphDescriptorType>;
 	hash->friendGraphDescriptor_p = GraphDescriptor;
+	hash->nodePool = nodePool;
 	hash->init_HastTable( GraphDescriptor->hashTableSize );
 	
-	heap = new HeapContainer<NodeType,CostType,PlannerSpecificVariables>(heapKeyNum);
+	heap = new HeapType(heapKeyNum);
+	heap->setNodeTable(hash);
 }
 
 
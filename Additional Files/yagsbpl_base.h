@@ -32,6 +32,8 @@
 #include <vector>
 #include <cstdlib>
 #include <limits>
+#include <new>
+#include <type_traits>
 
 #define _yagsbpl_abs(x) ((x)>0?(x):(-x))
 //#define _yagsbpl_display_version { if (!YAGSBPL_vDisplay_done) { printf("\n*** You are using YAGSBPL v 2.1. ***\n"); YAGSBPL_vDisplay_done = true; } }
@@ -42,34 +44,50 @@
 template <class NodeType, class CostType, class PlannerSpecificVariables>
 class SearchGraphNode;
 
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+class SearchGraphNodePool;
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+class NodeTableContainer;
+
+template <class NodeType, class CostType>
+class GenericSearchGraphDescriptor;
+
+template <class NodeType, class CostType, class PlannerSpecificVariables,
+			class GraphDescriptorType = GenericSearchGraphDescriptor<NodeType,CostType> >
+class HashTableContainer;
+
 // ---
 
 // This class stores information about edges emanating from or incident to a node
+// Link arrays are either owned by the NodeLinks (heap allocated) or, if a pool was passed to "init",
+//   carved out of that pool and released together with it.
 template <class NodeType, class CostType, class PlannerSpecificVariables>
 class NodeLinks
 {
 public:
-	std::vector< SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* >* targets;
-	std::vector<CostType>* costs;
+	SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>** targets;
+	CostType* costs;
+	int count;
+	int capacity;
+	bool pooled;
 	
 	// -------------------
-	NodeLinks() { targets = NULL; costs = NULL; }
+	NodeLinks() { targets = NULL; costs = NULL; count = 0; capacity = 0; pooled = false; }
 	bool empty(void) { return (!targets); }
-	int size(void) { if (targets) return targets->size(); else return -1; }
-	void init(int count=0) { targets = new std::vector< SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* >(count); 
-						costs = new std::vector<CostType>(count); }
+	int size(void) { if (targets) return count; else return -1; }
+	void init(int count=0, SearchGraphNodePool<NodeType,CostType,PlannerSpecificVariables>* pool=NULL);
 	
-	void push_back( SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* node_p , CostType cost )
-		{ targets->push_back(node_p) ; costs->push_back(cost); }
+	void push_back( SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* node_p , CostType cost );
 	void set(int a, SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* node_p , CostType cost )
-		{ targets->operator[](a) = node_p ; costs->operator[](a) = cost; }
+		{ targets[a] = node_p ; costs[a] = cost; }
 	
 	SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* getLinkSearchGraphNode (int a) 
-		{ return (targets->operator[](a)); }
+		{ return (targets[a]); }
 	CostType getLinkCost (int a) 
-		{ return (costs->operator[](a)); }
+		{ return (costs[a]); }
 	
-	~NodeLinks() {  if(targets) delete targets;  if(costs) delete costs;  }
+	~NodeLinks() {  if(!pooled) { delete[] targets;  delete[] costs; }  }
 };
 
 // Extension of NodeType for search problem
@@ -82,18 +100,49 @@ public:
 	// ---------------------------------------------------------------
 	// TODO for planner: Planner must set each of the following every time a "non-initiated" node is encountered.
 	bool initiated; // Used for tracking newly-create nodes by hash table. To be set to "true" by planner.
+	unsigned int generation; // Hash table generation in which 'initiated' was set. Older generations count as not initiated.
 	NodeLinks<NodeType,CostType,PlannerSpecificVariables> successors;
 	NodeLinks<NodeType,CostType,PlannerSpecificVariables> predecessors; // Planner may or may not use this
 	SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* came_from;
 	PlannerSpecificVariables plannerVars; // Other variables, if required by planner
 	CostType f; // f-value: Used for maintaining the heap
+	unsigned int id; // Set by the hash table when the node is created: 0, 1, 2, ... in order of creation
 	
 	// ---------------------------------------------------------------
 	// These variables are used by heap container
 	bool inHeap;
 	int heapArrayPos;
 	
-	SearchGraphNode() { initiated=false; came_from=NULL; inHeap=false; }
+	SearchGraphNode() { initiated=false; generation=0; came_from=NULL; inHeap=false; }
+};
+
+// ---------------------------------------------------------------------
+
+// Slab allocator for the nodes and link arrays of one planner.
+// Memory is handed out by bumping a pointer through large slabs and is never returned piecewise:
+//   "clear" rewinds to the first slab in O(1) and the destructor frees the slabs in one go.
+// The pool does not run destructors: the node table that handed out a pooled node destroys it before the
+//   pool goes, which frees link arrays that outgrew the pool (and whatever NodeType owns). "clear" is
+//   therefore only for a pool whose nodes have all been destroyed.
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+class SearchGraphNodePool
+{
+public:
+	typedef  SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>  GraphNode;
+	
+	SearchGraphNodePool(int nodesPerSlab=4096);
+	GraphNode* newNode(void);
+	template <class T> T* newArray(int count) { return ( (T*)allocate( count * sizeof(T) ) ); }
+	void clear(void) { currentSlab = 0; slabUsed = 0; }
+	size_t bytesReserved(void) { return (slabs.size() * slabBytes); }
+	~SearchGraphNodePool() { for (size_t a=0; a<slabs.size(); a++) free(slabs[a]); }
+	
+private:
+	void* allocate(size_t bytes); // throws std::bad_alloc when out of memory
+	std::vector<char*> slabs;
+	size_t slabBytes;
+	size_t currentSlab;
+	size_t slabUsed;
 };
 
 // ---------------------------------------------------------------------
@@ -112,6 +161,7 @@ public:
 	
 	typedef enum {UNKNOWN_BUBDIR, UPONLY_BUBDIR, DOWNONLY_BUBDIR} BubbleDirection;
 	
+	void setNodeTable(NodeTableContainer<NodeType,CostType,PlannerSpecificVariables>* table) { } // Not needed by this heap
 	void push(heapItem_p np);
 	heapItem_p pop(void);
 	void update (heapItem_p np, BubbleDirection bubdir=UNKNOWN_BUBDIR);
@@ -121,6 +171,121 @@ public:
 	int size(void) { return (heap_size); };
 };
 
+// Iterative d-ary heap with decrease-key. Drop-in replacement for 'HeapContainer'.
+// The heap array holds (f, node id) pairs contiguously and the heap positions are kept in a separate array
+//   indexed by node id, so sifting never touches the nodes themselves. Node ids are resolved through the
+//   hash table (see 'setNodeTable').
+template <class NodeType, class CostType, class PlannerSpecificVariables, int Arity=4>
+class DaryHeapContainer
+{
+public:
+	typedef  SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>*  heapItem_p;
+	
+	struct HeapEntry {
+		CostType f;
+		unsigned int node;
+	};
+	std::vector <HeapEntry> heapArray;
+	std::vector <int> heapPos; // Position of node id in 'heapArray', -1 if not in heap
+	NodeTableContainer<NodeType,CostType,PlannerSpecificVariables>* nodeTable;
+	
+	DaryHeapContainer(int=20) { nodeTable = NULL; }
+	
+	typedef enum {UNKNOWN_BUBDIR, UPONLY_BUBDIR, DOWNONLY_BUBDIR} BubbleDirection;
+	
+	void setNodeTable(NodeTableContainer<NodeType,CostType,PlannerSpecificVariables>* table) { nodeTable = table; }
+	void push(heapItem_p np);
+	heapItem_p pop(void);
+	void update (heapItem_p np, BubbleDirection bubdir=UNKNOWN_BUBDIR); // Also does decrease-key
+	void remove(heapItem_p np);
+	void clear(void);
+	bool empty(void) { return (heapArray.empty()); };
+	int size(void) { return (heapArray.size()); };
+	
+private:
+	void siftUp(int pos, HeapEntry e);
+	void siftDown(int pos, HeapEntry e);
+};
+
+// Radix heap for monotone integral keys (e.g. fixed-point costs). Drop-in replacement for 'HeapContainer'.
+// Keys popped must never decrease, which holds for A* with a consistent heuristic. A key smaller than the
+//   last popped one is treated as equal to it. Push is O(1) and pop is amortized O(log C), where C is the
+//   largest difference between keys in the heap at the same time (bounded by the edge costs, not the graph size).
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+class RadixHeapContainer
+{
+public:
+	typedef  SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>*  heapItem_p;
+	
+	struct HeapEntry {
+		unsigned long long key;
+		unsigned int node;
+	};
+	static const int NUM_BUCKETS = 65;
+	std::vector <HeapEntry> buckets[NUM_BUCKETS]; // Bucket b>0 holds keys whose highest bit differing from 'lastKey' is b-1
+	std::vector <int> bucketOf; // Bucket of node id, -1 if not in heap
+	std::vector <int> slotOf; // Position of node id inside its bucket
+	unsigned long long lastKey;
+	int heap_size;
+	NodeTableContainer<NodeType,CostType,PlannerSpecificVariables>* nodeTable;
+	
+	RadixHeapContainer(int=20) { lastKey = 0; heap_size = 0; nodeTable = NULL; }
+	
+	typedef enum {UNKNOWN_BUBDIR, UPONLY_BUBDIR, DOWNONLY_BUBDIR} BubbleDirection;
+	
+	void setNodeTable(NodeTableContainer<NodeType,CostType,PlannerSpecificVariables>* table) { nodeTable = table; }
+	void push(heapItem_p np);
+	heapItem_p pop(void);
+	void update (heapItem_p np, BubbleDirection bubdir=UNKNOWN_BUBDIR);
+	void remove(heapItem_p np);
+	void clear(void);
+	bool empty(void) { return (heap_size==0); };
+	int size(void) { return (heap_size); };
+	
+private:
+	void insert(unsigned long long key, unsigned int node);
+	void erase(unsigned int node);
+	int bucketIndex(unsigned long long key);
+};
+
+// Default open list for a cost type: the radix heap for integral costs, the 4-ary heap otherwise.
+template <class NodeType, class CostType, class PlannerSpecificVariables,
+			bool integral = std::numeric_limits<CostType>::is_integer>
+struct DefaultOpenList
+{
+	typedef  DaryHeapContainer<NodeType,CostType,PlannerSpecificVariables>  type;
+};
+
+template <class NodeType, class CostType, class PlannerSpecificVariables>
+struct DefaultOpenList<NodeType,CostType,PlannerSpecificVariables,true>
+{
+	typedef  RadixHeapContainer<NodeType,CostType,PlannerSpecificVariables>  type;
+};
+
+// ---------------------------------------------------------------------
+
+// Fixed-capacity list of successors and transition costs, filled by a graph's optional 'getSuccessorSpan'
+//   (see 'StaticSearchGraphDescriptor'). Storage is inline, so a planner can own one and reuse it for every
+//   expansion without touching the heap. The graph must not generate more than 'Capacity' successors per node.
+
+#ifndef _YAGSBPL_MAX_SUCCESSORS
+#define _YAGSBPL_MAX_SUCCESSORS 8
+#endif
+
+template <class NodeType, class CostType, int Capacity=_YAGSBPL_MAX_SUCCESSORS>
+class SuccessorSpan
+{
+public:
+	NodeType nodes[Capacity];
+	CostType costs[Capacity];
+	int count;
+	
+	SuccessorSpan() { count = 0; }
+	void clear(void) { count = 0; }
+	int size(void) { return (count); }
+	void push_back(const NodeType& n, CostType c) { nodes[count] = n; costs[count] = c; count++; }
+};
+
 // =============================================================================
 // Helper classes for 'GenericSearchGraphDescriptor'
 
@@ -191,6 +356,12 @@ public:
 	
 	// Primary variables
 	int hashTableSize; // Number of hash bins. "getHashBin" must return a value between 0 and hashTableSize
+	// Optional. Planners keep the successors of a node once generated. If the transition costs can differ between
+	//   plans made with the same planner, set this to false: the cached targets are kept but costs are re-queried.
+	bool cacheSuccessorCosts;
+	// Optional. Set to true if "getHashBin" is a perfect hash (never maps two different nodes to the same bin).
+	//   The hash table then becomes a flat index-addressed node store instead of one vector per bin.
+	bool perfectHash;
 	// An initial set of "start" nodes to be put in heap. At least one of the following two need to be set.
 	std::vector<NodeType> SeedNodes;
 	NodeType SeedNode;
@@ -200,6 +371,10 @@ public:
 	// Other variables and functions - constructor chooses a default
 	int hashBinSizeIncreaseStep; // optional
 	
+	// Successor spans need a compile-time bound graph (see 'StaticSearchGraphDescriptor'), so this descriptor has none
+	typedef  SuccessorSpan<NodeType,CostType>  SuccessorSpanType;
+	static const bool hasSuccessorSpan = false;
+	
 	// ---------------------------------------------------------------
 	// Constructor and other functions
 	GenericSearchGraphDescriptor();
@@ -208,6 +383,7 @@ public:
 	int _getHashBin(NodeType& n);
 	bool _isAccessible(NodeType& n);
 	void _getSuccessors(NodeType& n, std::vector<NodeType>* s, std::vector<CostType>* c);
+	void _getSuccessorSpan(NodeType& n, SuccessorSpanType* s) { } // Never called, since 'hasSuccessorSpan' is false
 	void _getPredecessors(NodeType& n, std::vector<NodeType>* s, std::vector<CostType>* c);
 	CostType _getHeuristics(NodeType& n1, NodeType& n2);
 	CostType _getHeuristicsToTarget(NodeType& n);
@@ -218,13 +394,165 @@ public:
 
 // =============================================================================
 
+// ----
+// Compile-time alternative to 'GenericSearchGraphDescriptor', for planners whose graph is known when they are compiled.
+//   'GraphClass' defines the primary functions under the same names and signatures as 'SearchGraphDescriptorFunctionContainer'.
+//   They are called as 'GraphClass::function', i.e. without virtual dispatch or 'func_redefined' checks, so the compiler
+//   can inline them into the planner loop. A class derived from 'SearchGraphDescriptorFunctionContainer' can be used as is.
+//   'isAccessible', 'getHeuristics', 'storePath' and 'stopSearch' stay optional: a function counts as defined unless it is
+//   missing or only inherited from 'SearchGraphDescriptorFunctionContainer', and the defaults of 'GenericSearchGraphDescriptor'
+//   apply otherwise.
+//   If 'GraphClass' also declares 'void getSuccessorSpan(NodeType& n, SuccessorSpan<NodeType,CostType>* s)', planners
+//   use it instead of 'getSuccessors' and generate successors without any heap allocation.
+//   Use as the 'GraphDescriptorType' of the planner, e.g. 'A_star_planner<NodeType, CostType, OpenListType, StaticSearchGraphDescriptor<...> >'.
+
+// 'value' is true if 'GraphClass' has the member function 'FuncName' with the given return type and arguments,
+//   other than the placeholder inherited from 'SearchGraphDescriptorFunctionContainer'
+#define _YAGSBPL_DECLARES_FUNCTION(TraitName, FuncName, ReturnType, ...) \
+	template <class GraphClass, class NodeType, class CostType, class Enable=void> \
+	struct TraitName : std::false_type { }; \
+	template <class GraphClass, class NodeType, class CostType> \
+	struct TraitName<GraphClass, NodeType, CostType, typename std::enable_if< \
+			std::is_convertible< decltype(&GraphClass::FuncName), ReturnType (GraphClass::*)(__VA_ARGS__) >::value && \
+			!std::is_same< decltype(&GraphClass::FuncName), \
+				ReturnType (SearchGraphDescriptorFunctionContainer<NodeType,CostType>::*)(__VA_ARGS__) >::value >::type> \
+		: std::true_type { };
+
+_YAGSBPL_DECLARES_FUNCTION(_yagsbpl_declares_isAccessible, isAccessible, bool, NodeType&)
+_YAGSBPL_DECLARES_FUNCTION(_yagsbpl_declares_getHeuristics, getHeuristics, CostType, NodeType&, NodeType&)
+_YAGSBPL_DECLARES_FUNCTION(_yagsbpl_declares_storePath, storePath, bool, NodeType&)
+_YAGSBPL_DECLARES_FUNCTION(_yagsbpl_declares_stopSearch, stopSearch, bool, NodeType&)
+_YAGSBPL_DECLARES_FUNCTION(_yagsbpl_declares_getSuccessorSpan, getSuccessorSpan, void, NodeType&, SuccessorSpan<NodeType,CostType>*)
+
+template <class NodeType, class CostType, class GraphClass>
+class StaticSearchGraphDescriptor
+{
+public:
+	typedef  std::integral_constant<bool, true>  Defined;
+	typedef  std::integral_constant<bool, false>  NotDefined;
+	typedef  SuccessorSpan<NodeType,CostType>  SuccessorSpanType;
+	// If true, planners generate successors with '_getSuccessorSpan' instead of '_getSuccessors'
+	static const bool hasSuccessorSpan = _yagsbpl_declares_getSuccessorSpan<GraphClass,NodeType,CostType>::value;
+	
+	// Primary functions are taken from here. Not owned by the descriptor.
+	GraphClass* graph;
+	
+	// Primary and other variables - same meaning as in 'GenericSearchGraphDescriptor'
+	int hashTableSize;
+	bool cacheSuccessorCosts;
+	bool perfectHash;
+	std::vector<NodeType> SeedNodes;
+	NodeType SeedNode;
+	NodeType TargetNode;
+	int hashBinSizeIncreaseStep;
+	
+	// ---------------------------------------------------------------
+	// Constructor and other functions
+	StaticSearchGraphDescriptor()
+		{ graph = NULL; hashBinSizeIncreaseStep = 128; perfectHash = false; cacheSuccessorCosts = true; }
+	void init(void) { if (SeedNodes.size() == 0) SeedNodes.push_back(SeedNode); }
+	// Derived functions - planner should use these
+	int _getHashBin(NodeType& n) { return ( graph->GraphClass::getHashBin(n) ); }
+	bool _isAccessible(NodeType& n)
+		{ return ( _isAccessible(n, std::integral_constant<bool, _yagsbpl_declares_isAccessible<GraphClass,NodeType,CostType>::value>()) ); }
+	void _getSuccessors(NodeType& n, std::vector<NodeType>* s, std::vector<CostType>* c)
+		{ _getSuccessors(n, s, c, std::integral_constant<bool, hasSuccessorSpan>()); }
+	void _getSuccessorSpan(NodeType& n, SuccessorSpanType* s) { _getSuccessorSpan(n, s, std::integral_constant<bool, hasSuccessorSpan>()); }
+	void _getPredecessors(NodeType& n, std::vector<NodeType>* s, std::vector<CostType>* c) { graph->GraphClass::getPredecessors(n, s, c); }
+	CostType _getHeuristics(NodeType& n1, NodeType& n2)
+		{ return ( _getHeuristics(n1, n2, std::integral_constant<bool, _yagsbpl_declares_getHeuristics<GraphClass,NodeType,CostType>::value>()) ); }
+	CostType _getHeuristicsToTarget(NodeType& n) { return ( _getHeuristics(n, TargetNode) ); }
+	bool _storePath(NodeType& n)
+		{ return ( _storePath(n, std::integral_constant<bool, _yagsbpl_declares_storePath<GraphClass,NodeType,CostType>::value>()) ); }
+	bool _stopSearch(NodeType& n)
+		{ return ( _stopSearch(n, std::integral_constant<bool, _yagsbpl_declares_stopSearch<GraphClass,NodeType,CostType>::value>()) ); }
+	
+private:
+	bool _isAccessible(NodeType& n, Defined) { return ( graph->GraphClass::isAccessible(n) ); }
+	bool _isAccessible(NodeType&, NotDefined) { return true; }
+	void _getSuccessorSpan(NodeType& n, SuccessorSpanType* s, Defined) { graph->GraphClass::getSuccessorSpan(n, s); }
+	void _getSuccessorSpan(NodeType&, SuccessorSpanType*, NotDefined) { }
+	void _getSuccessors(NodeType& n, std::vector<NodeType>* s, std::vector<CostType>* c, Defined) // A graph may define only the span version
+	{
+		SuccessorSpanType span;
+		graph->GraphClass::getSuccessorSpan(n, &span);
+		s->insert(s->end(), span.nodes, span.nodes + span.size());
+		c->insert(c->end(), span.costs, span.costs + span.size());
+	}
+	void _getSuccessors(NodeType& n, std::vector<NodeType>* s, std::vector<CostType>* c, NotDefined) { graph->GraphClass::getSuccessors(n, s, c); }
+	CostType _getHeuristics(NodeType& n1, NodeType& n2, Defined) { return ( graph->GraphClass::getHeuristics(n1, n2) ); }
+	CostType _getHeuristics(NodeType&, NodeType&, NotDefined) { return ((CostType)0); }
+	bool _storePath(NodeType& n, Defined) { return ( graph->GraphClass::storePath(n) ); }
+	bool _storePath(NodeType&, NotDefined) { return false; }
+	bool _stopSearch(NodeType& n, Defined) { return ( graph->GraphClass::stopSearch(n) ); }
+	bool _stopSearch(NodeType& n, NotDefined) { return ( n == TargetNode ); }
+};
+
+// =============================================================================
+
+#define _YAGSBPL_DENSE_CHUNK_SHIFT 12
+#define _YAGSBPL_DENSE_CHUNK_SIZE (1 << _YAGSBPL_DENSE_CHUNK_SHIFT)
+
+// Storage of the nodes of one planner, addressable by node id. Independent of how nodes are looked up,
+//   so the open lists can resolve node ids without knowing the graph descriptor.
 template <class NodeType, class CostType, class PlannerSpecificVariables>
-class HashTableContainer
+class NodeTableContainer
+{
+public:
+	typedef  SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>  GraphNode;
+	
+	SearchGraphNodePool<NodeType,CostType,PlannerSpecificVariables>* nodePool; // If set, nodes are created in (and owned by) the pool
+	
+	// Dense mode (graph declares 'perfectHash'): bin 'b' stores 1 + the 32-bit index of its only node, 0 if empty.
+	//   Nodes live in fixed-size chunks, so indices and pointers stay valid as the table grows.
+	unsigned int* DenseTable;
+	std::vector<GraphNode*> denseChunks;
+	unsigned int denseNodeCount;
+	
+	// Bin mode: node pointers by id
+	std::vector<GraphNode*> nodeById;
+	
+	// A node is initiated only if it was marked so in the current generation. Starting a new generation
+	//   therefore un-initiates every node at once, without walking the table.
+	unsigned int generation;
+	bool nodeInitiated(GraphNode* np) { return (np->initiated && np->generation == generation); }
+	void markInitiated(GraphNode* np) { np->generation = generation; np->initiated = true; }
+	void newGeneration(void);
+	
+	NodeTableContainer() { nodePool = NULL; DenseTable = NULL; denseNodeCount = 0; generation = 1; }
+	bool isDense(void) { return (DenseTable != NULL); }
+	size_t nodeCount(void) { return (DenseTable ? denseNodeCount : nodeById.size()); }
+	GraphNode* getNodeByIndex(unsigned int i) // 'i' is a node id
+		{ return ( DenseTable ? denseChunks[i >> _YAGSBPL_DENSE_CHUNK_SHIFT] + (i & (_YAGSBPL_DENSE_CHUNK_SIZE-1)) : nodeById[i] ); }
+	~NodeTableContainer()
+	{
+		if (DenseTable)
+		{
+			for (unsigned int a=0; a<denseNodeCount; a++) // Links that outgrew the pool live on the heap
+				getNodeByIndex(a)->~GraphNode();
+			for (size_t a=0; a<denseChunks.size(); a++)
+				free(denseChunks[a]);
+			free(DenseTable);
+		}
+	};
+	
+private:
+	NodeTableContainer(const NodeTableContainer&);
+	NodeTableContainer& operator=(const NodeTableContainer&);
+};
+
+// Node lookup by 'NodeType' through the hash function of the graph descriptor
+template <class NodeType, class CostType, class PlannerSpecificVariables, class GraphDescriptorType>
+class HashTableContainer : public NodeTableContainer<NodeType,CostType,PlannerSpecificVariables>
 {
 public:
-	GenericSearchGraphDescriptor<NodeType,CostType>* friendGraphDescriptor_p;
+	typedef  SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>  GraphNode;
+	
+	GraphDescriptorType* friendGraphDescriptor_p;
 	int hashTableSize;
 	std::vector< SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* >* HashTable;
+	
+	HashTableContainer() { HashTable = NULL; }
 	void init_HastTable(int hash_table_size);
 	SearchGraphNode<NodeType,CostType,PlannerSpecificVariables>* getNodeInHash(NodeType n); // Returns pointer to already-existing
 	~HashTableContainer()
@@ -232,8 +560,11 @@ public:
 		if (HashTable)
 		{
 			for (int a=0; a<hashTableSize; a++)
-				for (int b=0; b<HashTable[a].size(); b++)
-					delete HashTable[a][b];
+				for (size_t b=0; b<HashTable[a].size(); b++)
+					if (this->nodePool) // Pooled memory goes with the pool; only destroy the node
+						HashTable[a][b]->~GraphNode();
+					else
+						delete HashTable[a][b];
 			delete[] HashTable;
 		}
 	};
@@ -243,16 +574,22 @@ public:
 // TODO for planner: A planner needs to maintain an instance of this.
 //   	Inheritance is also possible, but not recommended because of templates.
 
-template <class NodeType, class CostType, class PlannerSpecificVariables>
+template <class NodeType, class CostType, class PlannerSpecificVariables,
+			class HeapType = typename DefaultOpenList<NodeType,CostType,PlannerSpecificVariables>::type,
+			class GraphDescriptorType = GenericSearchGraphDescriptor<NodeType,CostType> >
 class GenericPlanner
 {
 public:
-	GenericSearchGraphDescriptor<NodeType,CostType>* GraphDescriptor;
-	HashTableContainer<NodeType,CostType,PlannerSpecificVariables>* hash;
-	HeapContainer<NodeType,CostType,PlannerSpecificVariables>* heap;
+	GraphDescriptorType* GraphDescriptor;
+	HashTableContainer<NodeType,CostType,PlannerSpecificVariables,GraphDescriptorType>* hash;
+	HeapType* heap;
+	SearchGraphNodePool<NodeType,CostType,PlannerSpecificVariables>* nodePool; // NULL unless 'useNodePool' was requested
 	
-	void init( GenericSearchGraphDescriptor<NodeType,CostType> theEnv , int heapKeyNum=20 ); // A planner must call this explicitly.
-	~GenericPlanner() { delete GraphDescriptor; delete hash; delete heap; }
+	GenericPlanner() { GraphDescriptor = NULL; hash = NULL; heap = NULL; nodePool = NULL; }
+	// A planner must call this explicitly. With 'useNodePool' all nodes and successor links of this planner
+	//   are allocated from a slab pool and freed together when the planner is destroyed.
+	void init( GraphDescriptorType theEnv , int heapKeyNum=20 , bool useNodePool=false );
+	~GenericPlanner() { delete GraphDescriptor; delete hash; delete heap; delete nodePool; }
 };
 
 
@@ -0,0 +1,187 @@
+#include "FlowField.h"
+#include <math.h>
+#include <algorithm>
+#include "common.h"
+
+// neighbour offsets in GraphFunctionContainer::getSuccessorSpan order
+static const int stepX[8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+static const int stepY[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+
+FlowField::FlowField(void)
+	: reached(0)
+{
+}
+
+// -------------------------------
+// building the field
+
+void FlowField::build(GraphFunctionContainer& graph, const std::vector<AStarNode>& goals)
+{
+	typedef StaticSearchGraphDescriptor<AStarNode, double, FlowFieldGraph> Descriptor;
+	FlowFieldGraph reverseGraph(&graph);
+	Descriptor searchGraph;
+	searchGraph.graph = &reverseGraph;
+	searchGraph.hashTableSize = GraphFunctionContainer::getHashTableSize();
+	searchGraph.hashBinSizeIncreaseStep = 1; //hash function guarantees unique values
+	searchGraph.perfectHash = true;
+	searchGraph.SeedNodes = goals;
+	A_star_planner<AStarNode, double, DefaultOpenList< AStarNode, double, A_star_variables<double> >::type,
+		Descriptor> planner;
+	planner.setParams(1.0, 10, 0);
+	planner.setNodePooling();
+	planner.init(&searchGraph);
+	planner.plan(); // runs until every node that reaches a goal is expanded
+
+	// the search tree points from every node towards the goals, one step at a time
+	direction.assign(searchGraph.hashTableSize, -1);
+	cost.assign(searchGraph.hashTableSize, -1.0f);
+	reached = 0;
+	for (size_t i = 0; i < planner.hash->nodeCount(); i++) {
+		SearchGraphNode< AStarNode, double, A_star_variables<double> >* node = planner.hash->getNodeByIndex(i);
+		if (!planner.hash->nodeInitiated(node) || !node->plannerVars.accessible || !node->plannerVars.expanded)
+			continue;
+		int b = bin(node->n);
+		cost[b] = (float)node->plannerVars.g;
+		reached++;
+		if (node->came_from) {
+			int k = (node->came_from->n.getX() - node->n.getX() + 1) * 3 + (node->came_from->n.getY() - node->n.getY() + 1);
+			direction[b] = (k > 4) ? k - 1 : k; // no entry for the node itself
+		}
+	}
+}
+
+// -------------------------------
+// following the field
+
+bool FlowField::next(const AStarNode& n, AStarNode& nextNode) const
+{
+	if (n.getX() < GraphFunctionContainer::Xmin || n.getX() > GraphFunctionContainer::Xmax
+		|| n.getY() < GraphFunctionContainer::Ymin || n.getY() > GraphFunctionContainer::Ymax)
+		return false;
+	int k = direction[bin(n)];
+	if (k < 0)
+		return false;
+	nextNode = AStarNode(n.getX() + stepX[k], n.getY() + stepY[k]);
+	return true;
+}
+
+double FlowField::getCost(const AStarNode& n) const
+{
+	if (n.getX() < GraphFunctionContainer::Xmin || n.getX() > GraphFunctionContainer::Xmax
+		|| n.getY() < GraphFunctionContainer::Ymin || n.getY() > GraphFunctionContainer::Ymax)
+		return -1.0;
+	return cost[bin(n)];
+}
+
+bool FlowField::getPath(const AStarNode& start, std::vector<AStarNode>& path) const
+{
+	path.clear();
+	if (getCost(start) < 0.0)
+		return false;
+	AStarNode n = start;
+	path.push_back(n);
+	while (next(n, n))
+		path.push_back(n);
+	std::reverse(path.begin(), path.end());
+	return true;
+}
+
+// -------------------------------
+// reversed graph
+
+FlowFieldGraph::FlowFieldGraph(GraphFunctionContainer* graph)
+	: graph(graph), multipliers(GraphFunctionContainer::getHashTableSize(), 0.0)
+{
+}
+
+void FlowFieldGraph::getSuccessorSpan(AStarNode& n, SuccessorSpan<AStarNode,double>* s)
+{
+	AStarNode m;
+	s->clear();
+	for (int k = 0; k < 8; k++) {
+		m.setX(n.getX() + stepX[k]);
+		m.setY(n.getY() + stepY[k]);
+		s->push_back(m, hypotf(stepX[k], stepY[k]) * multiplier(m));
+	}
+}
+
+double FlowFieldGraph::multiplier(AStarNode& n)
+{
+	double& m = multipliers[graph->getHashBin(n)];
+	if (m == 0.0)
+		m = graph->getCostMultiplier(n);
+	return m;
+}
+
+// -------------------------------
+// cache
+
+FlowFieldCache::FlowFieldCache(void)
+	: builds(0)
+{
+}
+
+std::shared_ptr<const FlowField> FlowFieldCache::get(int goalId, GraphFunctionContainer& graph, const AStarNode& goal)
+{
+	std::shared_future< std::shared_ptr<const FlowField> > cached;
+	std::promise< std::shared_ptr<const FlowField> > promise;
+	Entry added;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		graph.getCostSources(costSources);
+		int generation = GraphFunctionContainer::getWorldGeneration();
+		for (std::list<Entry>::iterator it = entries.begin(); it != entries.end(); ) {
+			if (it->worldGeneration != generation || (it->goalId == goalId && !(it->goal == goal))) {
+				it = entries.erase(it); // built for an old world, or the goal moved
+			}
+			else if (it->goal == goal && it->costProfile == graph.getCostProfile() && it->costSources == costSources) {
+				entries.splice(entries.begin(), entries, it);
+				cached = entries.front().field;
+				break;
+			}
+			else
+				++it;
+		}
+		if (!cached.valid()) {
+			// this thread builds the field; others that ask for it meanwhile wait on its future
+			Entry entry = { goalId, goal, graph.getCostProfile(), costSources, generation, promise.get_future().share() };
+			added = entry;
+			entries.push_front(entry);
+			if (entries.size() > FLOW_FIELD_CACHE_SIZE)
+				entries.pop_back();
+			builds++;
+		}
+	}
+	if (cached.valid())
+		return cached.get(); // waits if another thread is still building it
+
+	// built outside the lock, so threads after other fields or paths go on meanwhile
+	std::shared_ptr<FlowField> field(new FlowField);
+	try {
+		field->build(graph, std::vector<AStarNode>(1, goal));
+	}
+	catch (...) {
+		dropFailedBuild(added); // the next request tries again
+		promise.set_exception(std::current_exception());
+		throw;
+	}
+	promise.set_value(field);
+	return field;
+}
+
+void FlowFieldCache::dropFailedBuild(const Entry& built)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (std::list<Entry>::iterator it = entries.begin(); it != entries.end(); ++it)
+		if (it->goal == built.goal && it->costProfile == built.costProfile && it->costSources == built.costSources
+			&& it->worldGeneration == built.worldGeneration) {
+			entries.erase(it);
+			return;
+		}
+}
+
+void FlowFieldCache::clear(void)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	entries.clear();
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#ifndef	BZF_FLOWFIELD_H
+#define	BZF_FLOWFIELD_H
+
+#include "AStarNode.h"
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <future>
+
+#define FLOW_FIELD_CACHE_SIZE 8 // fields kept by a FlowFieldCache
+
+// ============================================================
+// Flow field towards a goal: for every node that can reach the goal, the neighbour to step to next on a
+// cheapest path. Built by one backward Dijkstra search from the goal nodes over the whole world, so any
+// number of robots with the same goal and cost profile can follow it, each at O(1) per step.
+
+class FlowField
+{
+public:
+	FlowField(void);
+
+	// Builds the field towards goals (the seeds of the search) with the costs of graph
+	void build(GraphFunctionContainer& graph, const std::vector<AStarNode>& goals);
+
+	// Next node from n towards the goal. false if n is a goal or cannot reach one.
+	bool next(const AStarNode& n, AStarNode& nextNode) const;
+	double getCost(const AStarNode& n) const; // cost from n to the goal, negative if it cannot reach it
+	// Path from start to the goal in planner order (goal first, start last, one node per step)
+	bool getPath(const AStarNode& start, std::vector<AStarNode>& path) const;
+
+	int getReachedCount(void) const { return reached; } // nodes that can reach the goal
+
+private:
+	int bin(const AStarNode& n) const { return GraphFunctionContainer::computeHashBin(n.getX(), n.getY()); }
+
+	std::vector<signed char> direction; // by hash bin: index of the next step in getSuccessorSpan order, -1 for none
+	std::vector<float> cost; // by hash bin, negative if unreached
+	int reached;
+};
+
+// ============================================================
+// Graph of GraphFunctionContainer with every step reversed, for the backward search of FlowField.
+// The successors of n are its neighbours m, with the cost of the step from m to n.
+// The search never stops early and has no heuristics (Dijkstra).
+
+class FlowFieldGraph
+{
+public:
+	FlowFieldGraph(GraphFunctionContainer* graph);
+
+	int getHashBin(AStarNode& n) { return graph->getHashBin(n); }
+	bool isAccessible(AStarNode& n) { return graph->isAccessible(n); }
+	void getSuccessorSpan(AStarNode& n, SuccessorSpan<AStarNode,double>* s);
+	bool stopSearch(AStarNode&) { return false; }
+
+private:
+	double multiplier(AStarNode& n); // graph's cost multiplier, queried once per node
+
+	GraphFunctionContainer* graph;
+	std::vector<double> multipliers; // by hash bin, 0 until queried
+};
+
+// ============================================================
+// Flow fields shared by all robots, keyed by goal node, cost profile and cost sources (see
+// GraphFunctionContainer::getCostSources). Only for graphs with trackable costs: costs from
+// enemies change all the time. Keeps the FLOW_FIELD_CACHE_SIZE fields used last. Safe to use
+// from several planner threads; a field a thread still follows outlives its eviction. A field is
+// built outside the lock, so threads after other fields do not wait for it; threads after the same
+// one wait for the thread that builds it.
+
+class FlowFieldCache
+{
+public:
+	FlowFieldCache(void);
+
+	// Field towards goal with graph's costs, built on first use. goalId names the goal (e.g. a flag
+	// index): once the goal of an id is at another node, the fields for its old node are dropped.
+	std::shared_ptr<const FlowField> get(int goalId, GraphFunctionContainer& graph, const AStarNode& goal);
+	void clear(void);
+
+	int getBuildCount(void) const { return builds; }
+
+private:
+	FlowFieldCache(const FlowFieldCache&);
+	FlowFieldCache& operator=(const FlowFieldCache&);
+
+	struct Entry
+	{
+		int goalId;
+		AStarNode goal;
+		int costProfile;
+		std::vector<AStarNode> costSources;
+		int worldGeneration;
+		std::shared_future< std::shared_ptr<const FlowField> > field; // ready once built
+	};
+
+	void dropFailedBuild(const Entry& built);
+
+	std::mutex mutex; // guards everything below
+	std::list<Entry> entries; // most recently used first
+	std::vector<AStarNode> costSources; // scratch list
+	int builds;
+};
+
+#endif // BZF_FLOWFIELD_H
@@ -0,0 +1,187 @@
+#include "InfluenceMap.h"
+#include <math.h>
+#include <algorithm>
+#include "common.h"
+#include "AStarNode.h"
+#include "World.h"
+#include "playing.h" // needed for numFlags
+
+InfluenceMap::Layer InfluenceMap::badFlags;
+std::map<int, InfluenceMap::Layer> InfluenceMap::enemies;
+std::vector<InfluenceMap::Source> InfluenceMap::scratch;
+int InfluenceMap::worldGeneration = -1, InfluenceMap::hashTableSize = 0;
+
+/**
+Convert angle to equivalent value between 0.0 and 6.28
+*/
+static float trueAngle(float angle) {
+	if (angle < 0.0f) return angle + (float)(2.0 * M_PI);
+	if (angle > 2.0f * M_PI) return angle - (float)(2.0 * M_PI);
+	return angle;
+}
+
+// value in INFLUENCE_FIXED_ONE units, rounded to the nearest
+static int toFixed(double value) {
+	return (int)floor(value * INFLUENCE_FIXED_ONE + 0.5);
+}
+
+// -------------------------------
+// keeping the grids up to date
+
+void InfluenceMap::update(void)
+{
+	checkWorld();
+	updateBadFlags();
+	for (std::map<int, Layer>::iterator it = enemies.begin(); it != enemies.end(); ++it)
+		if (it->second.used)
+			updateEnemies(it->first, it->second);
+}
+
+std::shared_ptr<const InfluenceMap::Grid> InfluenceMap::getBadFlagGrid(std::vector<Source>& flags)
+{
+	checkWorld();
+	if (!badFlags.used)
+		updateBadFlags();
+	flags.clear();
+	for (int i = 0; i < (int)badFlags.sources.size(); i++)
+		if (badFlags.sources[i].active)
+			flags.push_back(badFlags.sources[i]);
+	return publish(badFlags);
+}
+
+std::shared_ptr<const InfluenceMap::Grid> InfluenceMap::getEnemyGrid(int team)
+{
+	checkWorld();
+	Layer& layer = enemies[team];
+	if (!layer.used)
+		updateEnemies(team, layer);
+	return publish(layer);
+}
+
+// a new world (or world size) starts all grids over; teams come back into use when asked for
+void InfluenceMap::checkWorld(void)
+{
+	if (worldGeneration == GraphFunctionContainer::getWorldGeneration()
+		&& hashTableSize == GraphFunctionContainer::getHashTableSize())
+		return;
+	worldGeneration = GraphFunctionContainer::getWorldGeneration();
+	hashTableSize = GraphFunctionContainer::getHashTableSize();
+	badFlags = Layer();
+	enemies.clear();
+}
+
+// the team flags of bad quality that no tank carries
+void InfluenceMap::updateBadFlags(void)
+{
+	badFlags.used = true;
+	scratch.clear();
+	for (int i = 0; i < numFlags; i++) {
+		Flag* flag = &World::getWorld()->getFlag(i);
+		Source source = { false, 0, 0, 0.0f };
+		if (flag->type->flagTeam != NoTeam && flag->status != FlagOnTank && flag->type->flagQuality == FlagQuality::FlagBad) {
+			source.active = true;
+			source.x = GraphFunctionContainer::convertCoordinate(flag->position[0]);
+			source.y = GraphFunctionContainer::convertCoordinate(flag->position[1]);
+		}
+		scratch.push_back(source);
+	}
+	restamp(badFlags, scratch, stampBadFlag);
+}
+
+// the players not of team
+void InfluenceMap::updateEnemies(int team, Layer& layer)
+{
+	layer.used = true;
+	scratch.clear();
+	for (int t = 0; t < World::getWorld()->getCurMaxPlayers(); t++) {
+		Player *p = World::getWorld()->getPlayer(t);
+		Source source = { false, 0, 0, 0.0f };
+		if (p && p->getColor() != team) {
+			source.active = true;
+			source.x = GraphFunctionContainer::convertCoordinate(p->getPosition()[0]);
+			source.y = GraphFunctionContainer::convertCoordinate(p->getPosition()[1]);
+			source.angle = p->getAngle();
+		}
+		scratch.push_back(source);
+	}
+	restamp(layer, scratch, stampEnemy);
+}
+
+void InfluenceMap::restamp(Layer& layer, const std::vector<Source>& sources, StampFunction stamp)
+{
+	if ((int)layer.values.size() != hashTableSize)
+		layer.values.assign(hashTableSize, 0);
+	Source none = { false, 0, 0, 0.0f };
+	int count = std::max(layer.sources.size(), sources.size());
+	for (int i = 0; i < count; i++) {
+		const Source& before = i < (int)layer.sources.size() ? layer.sources[i] : none;
+		const Source& now = i < (int)sources.size() ? sources[i] : none;
+		if (before == now)
+			continue;
+		if (before.active)
+			stamp(layer.values, before, -1);
+		if (now.active)
+			stamp(layer.values, now, 1);
+		layer.changed = true;
+	}
+	layer.sources = sources;
+}
+
+std::shared_ptr<const InfluenceMap::Grid> InfluenceMap::publish(Layer& layer)
+{
+	if (layer.changed || !layer.published) {
+		std::shared_ptr<Grid> grid = std::make_shared<Grid>(layer.values.size());
+		for (size_t i = 0; i < layer.values.size(); i++)
+			(*grid)[i] = (double)layer.values[i] / INFLUENCE_FIXED_ONE;
+		layer.published = grid;
+		layer.changed = false;
+	}
+	return layer.published;
+}
+
+// -------------------------------
+// stamps, added (sign 1) or taken off (sign -1) the nodes a source reaches, in the hash table.
+// Each node's share is rounded to fixed point once, so both signs move it by the same amount.
+
+/**
+Calculates the influence of a bad flag on the weight of the path.
+A flag increases the weight of nearby nodes (at most 2 units away);
+*/
+void InfluenceMap::stampBadFlag(FixedGrid& values, const Source& flag, int sign)
+{
+	int reach = (int)INFLUENCE_FLAG_RADIUS;
+	for (int y = std::max(flag.y - reach, GraphFunctionContainer::Ymin - 1); y <= std::min(flag.y + reach, GraphFunctionContainer::Ymax + 1); y++)
+		for (int x = std::max(flag.x - reach, GraphFunctionContainer::Xmin - 1); x <= std::min(flag.x + reach, GraphFunctionContainer::Xmax + 1); x++) {
+			double distance = hypotf(flag.x - x, flag.y - y);
+			if (distance <= INFLUENCE_FLAG_RADIUS)
+				values[GraphFunctionContainer::computeHashBin(x, y)] += sign * toFixed(5.0 / (distance + 1.0));
+		}
+}
+
+/**
+Calculates the influence of an enemy on the weight of the path.
+Greater influence in the direction that enemy is facing.
+Influence within a certain distance from tank (INFLUENCE_MIN_AOI).
+Influence within a 45 degree angle in front of tank, up to a certain distance (INFLUENCE_MAX_AOI).
+*/
+void InfluenceMap::stampEnemy(FixedGrid& values, const Source& enemy, int sign)
+{
+	float angleMin = trueAngle(enemy.angle - M_PI / 16.0);
+	int reach = (int)INFLUENCE_MAX_AOI;
+	for (int y = std::max(enemy.y - reach, GraphFunctionContainer::Ymin - 1); y <= std::min(enemy.y + reach, GraphFunctionContainer::Ymax + 1); y++)
+		for (int x = std::max(enemy.x - reach, GraphFunctionContainer::Xmin - 1); x <= std::min(enemy.x + reach, GraphFunctionContainer::Xmax + 1); x++) {
+			double distance = hypotf(enemy.x - x, enemy.y - y);
+			double added = 0.0;
+			if (distance <= INFLUENCE_MIN_AOI) {
+				added += INFLUENCE_MIN_AOI / (distance + 1.0);
+			}
+			if (distance <= INFLUENCE_MAX_AOI) {
+				float angleFrom = atan2((float)(y - enemy.y), (float)(x - enemy.x));
+				if (trueAngle(angleFrom - angleMin) <= M_PI / 8.0) { // if position is in front of enemy tank (45 degree angle)
+					added += (INFLUENCE_MAX_AOI / 4.0) / (distance + 1.0);
+				}
+			}
+			if (added != 0.0)
+				values[GraphFunctionContainer::computeHashBin(x, y)] += sign * toFixed(added);
+		}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#ifndef	BZF_INFLUENCEMAP_H
+#define	BZF_INFLUENCEMAP_H
+
+#include <vector>
+#include <map>
+#include <memory>
+
+#define INFLUENCE_MAX_AOI 20.0f // reach of the cone in front of an enemy, in nodes
+#define INFLUENCE_MIN_AOI 3.0f // reach of an enemy all around it
+#define INFLUENCE_FLAG_RADIUS 2.0f // reach of a bad flag
+#define INFLUENCE_FIXED_ONE 65536 // fixed-point value of 1 in the grids the game thread keeps
+
+// ============================================================
+// Costs that bad flags and enemies add to the nodes around them, as grids over the hash bins of
+// GraphFunctionContainer. The cost multiplier of a node is 1 plus its value. There is one grid for
+// the bad flags and one per team for the players of the other teams. The game thread keeps them up
+// to date once per tick: a source that moved has its old stamp taken off its grid and a new one
+// put on, so each update only costs as much as the sources that moved. Stamps are added in fixed
+// point (INFLUENCE_FIXED_ONE), so taking one off leaves exactly what was there before: however long
+// a game runs, a grid holds the same values as one stamped from scratch. Planners read an immutable
+// copy of a grid (taken when it is asked for after a change), so they can run on planner threads.
+
+class InfluenceMap
+{
+public:
+	typedef std::vector<double> Grid;
+
+	// node and azimuth of a flag or player that raises the costs around it
+	struct Source
+	{
+		bool active; // false for a slot without a source
+		int x, y;
+		float angle;
+		bool operator==(const Source& s) const { return active == s.active && (!active || (x == s.x && y == s.y && angle == s.angle)); }
+		bool operator!=(const Source& s) const { return !(*this == s); }
+	};
+
+	// Restamps the sources that moved since the last update. Call from the game thread, once per tick.
+	static void update(void);
+
+	// Grids as of the last update; flags is set to the bad flags on the grid, in flag order.
+	// Game thread only. A team's enemy grid is kept up to date from its first use on.
+	static std::shared_ptr<const Grid> getBadFlagGrid(std::vector<Source>& flags);
+	static std::shared_ptr<const Grid> getEnemyGrid(int team);
+
+private:
+	typedef std::vector<int> FixedGrid;
+
+	struct Layer
+	{
+		Layer(void) : used(false), changed(true) {}
+		bool used;
+		bool changed; // since published was taken
+		FixedGrid values; // in INFLUENCE_FIXED_ONE units
+		std::vector<Source> sources; // by flag or player index, as stamped on values
+		std::shared_ptr<const Grid> published;
+	};
+
+	typedef void (*StampFunction)(FixedGrid& values, const Source& source, int sign);
+
+	static void checkWorld(void);
+	static void updateBadFlags(void);
+	static void updateEnemies(int team, Layer& layer);
+	static void restamp(Layer& layer, const std::vector<Source>& sources, StampFunction stamp);
+	static std::shared_ptr<const Grid> publish(Layer& layer);
+	static void stampBadFlag(FixedGrid& values, const Source& flag, int sign);
+	static void stampEnemy(FixedGrid& values, const Source& enemy, int sign);
+
+	static Layer badFlags;
+	static std::map<int, Layer> enemies; // by team
+	static std::vector<Source> scratch;
+	static int worldGeneration, hashTableSize; // the grids are for
+};
+
+#endif // BZF_INFLUENCEMAP_H
@@ -0,0 +1,116 @@
+#include "Landmarks.h"
+#include <queue>
+#include <thread>
+#include <functional>
+#include "common.h"
+#include "BZDBCache.h"
+#include "World.h"
+#include "playing.h" // needed for numFlags
+
+std::vector<AStarNode> Landmarks::landmarks;
+int Landmarks::count = 0;
+std::vector<float> Landmarks::distances;
+int Landmarks::worldGeneration = -1, Landmarks::hashTableSize = 0;
+
+void Landmarks::build(int threads)
+{
+	landmarks.clear();
+	// the bases, where robots go back to with flags
+	for (int team = RedTeam; team <= PurpleTeam; team++)
+		for (int base = 0; World::getWorld()->getBase(team, base) != NULL; base++) {
+			const float* position = World::getWorld()->getBase(team, base);
+			addLandmark(GraphFunctionContainer::convertCoordinate(position[0]), GraphFunctionContainer::convertCoordinate(position[1]));
+		}
+	// the corners, which lie behind everything else seen from the middle of the world
+	addLandmark(GraphFunctionContainer::Xmin, GraphFunctionContainer::Ymin);
+	addLandmark(GraphFunctionContainer::Xmax, GraphFunctionContainer::Ymax);
+	addLandmark(GraphFunctionContainer::Xmin, GraphFunctionContainer::Ymax);
+	addLandmark(GraphFunctionContainer::Xmax, GraphFunctionContainer::Ymin);
+	// the flags as they were spawned
+	for (int i = 0; i < numFlags; i++) {
+		Flag& flag = World::getWorld()->getFlag(i);
+		if (flag.status == FlagOnGround)
+			addLandmark(GraphFunctionContainer::convertCoordinate(flag.position[0]), GraphFunctionContainer::convertCoordinate(flag.position[1]));
+	}
+	count = landmarks.size();
+
+	hashTableSize = GraphFunctionContainer::getHashTableSize();
+	distances.assign(hashTableSize * count, -1.0f);
+	std::atomic<int> nextLandmark(0);
+	std::vector<std::thread> workers;
+	for (int i = 1; i < threads; i++)
+		workers.push_back(std::thread(&Landmarks::work, &nextLandmark));
+	work(&nextLandmark);
+	for (int i = 0; i < (int)workers.size(); i++)
+		workers[i].join();
+
+	worldGeneration = GraphFunctionContainer::getWorldGeneration();
+}
+
+bool Landmarks::isBuilt(void)
+{
+	return worldGeneration == GraphFunctionContainer::getWorldGeneration()
+		&& hashTableSize == GraphFunctionContainer::getHashTableSize();
+}
+
+// the accessible node nearest to (x, y), unless one already picked is close to it
+void Landmarks::addLandmark(int x, int y)
+{
+	if ((int)landmarks.size() >= LANDMARK_MAX)
+		return;
+	for (int reach = 0; reach <= LANDMARK_SPACING / 2; reach++)
+		for (int b = -reach; b <= reach; b++)
+			for (int a = -reach; a <= reach; a++) {
+				if (std::max(abs(a), abs(b)) != reach || !AStarNode::isAccessible(x + a, y + b))
+					continue; // only the ring at this reach
+				for (int l = 0; l < (int)landmarks.size(); l++)
+					if (std::max(abs(landmarks[l].getX() - x - a), abs(landmarks[l].getY() - y - b)) < LANDMARK_SPACING)
+						return;
+				landmarks.push_back(AStarNode(x + a, y + b));
+				return;
+			}
+}
+
+// worker thread: computes tables until none are left
+void Landmarks::work(std::atomic<int>* nextLandmark)
+{
+	std::vector<float> distance;
+	for (int l = (*nextLandmark)++; l < count; l = (*nextLandmark)++) {
+		computeDistances(l, distance);
+		for (int bin = 0; bin < hashTableSize; bin++)
+			distances[bin * count + l] = distance[bin];
+	}
+}
+
+// Dijkstra from landmark l over the nodes of the world, with the steps of GraphFunctionContainer::getSuccessorSpan
+void Landmarks::computeDistances(int l, std::vector<float>& distance)
+{
+	typedef std::pair<float, int> Entry; // distance, hash bin
+	const int rowLength = abs(GraphFunctionContainer::Xmin) * 2 + 3; // of the hash bins, see computeHashBin
+	const float SQRT2 = (float)sqrt(2.0);
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > open;
+
+	distance.assign(hashTableSize, -1.0f);
+	int start = GraphFunctionContainer::computeHashBin(landmarks[l].getX(), landmarks[l].getY());
+	distance[start] = 0.0f;
+	open.push(Entry(0.0f, start));
+	while (!open.empty()) {
+		Entry entry = open.top();
+		open.pop();
+		if (entry.first > distance[entry.second])
+			continue; // reached on a shorter way since it was queued
+		int x = entry.second % rowLength - abs(GraphFunctionContainer::Xmin) - 1;
+		int y = entry.second / rowLength - abs(GraphFunctionContainer::Ymin) - 1;
+		for (int b = -1; b <= 1; b++)
+			for (int a = -1; a <= 1; a++) {
+				if ((a == 0 && b == 0) || !AStarNode::isAccessible(x + a, y + b))
+					continue;
+				int bin = entry.second + b * rowLength + a;
+				float reached = entry.first + ((a != 0 && b != 0) ? SQRT2 : 1.0f);
+				if (distance[bin] < 0.0f || reached < distance[bin]) {
+					distance[bin] = reached;
+					open.push(Entry(reached, bin));
+				}
+			}
+	}
+}
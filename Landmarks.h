@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef	BZF_LANDMARKS_H
+#define	BZF_LANDMARKS_H
+
+#include "AStarNode.h"
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <math.h>
+
+#define LANDMARK_MAX 16 // landmarks kept for a world
+#define LANDMARK_SPACING 8 // landmarks closer than this (in nodes) to one already picked are dropped
+#define LANDMARK_THREADS 4 // threads that compute the distance tables, 0 to do it in the calling thread
+
+// ============================================================
+// ALT heuristics (A*, landmarks and the triangle inequality) for the current world. When a world is
+// loaded, a few landmarks are picked (the team bases, the corners of the world and where the flags lie)
+// and the distance of every node to each of them is computed on the 8-connected graph without cost
+// multipliers. For any two nodes a and b, |d(L, a) - d(L, b)| is then a lower bound on the distance
+// between them; unlike the straight line, it accounts for the buildings in between. The tables are
+// only written by build, so every robot and planner thread can share them.
+
+class Landmarks
+{
+public:
+	// Picks the landmarks and computes their tables, after OccupancyGrid::build. Game thread only.
+	static void build(int threads = LANDMARK_THREADS);
+	// true once built for the current world and bounds
+	static bool isBuilt(void);
+
+	// Lower bound on the distance (in nodes) from (x1, y1) to (x2, y2): the largest one the landmarks
+	// give, or 0 if none can tell (e.g. one of the nodes cannot be reached). The world must be built.
+	static double lowerBound(int x1, int y1, int x2, int y2)
+	{
+		const float* d1 = &distances[GraphFunctionContainer::computeHashBin(x1, y1) * count];
+		const float* d2 = &distances[GraphFunctionContainer::computeHashBin(x2, y2) * count];
+		float bound = 0.0f;
+		for (int l = 0; l < count; l++)
+			if (d1[l] >= 0.0f && d2[l] >= 0.0f)
+				bound = std::max(bound, fabsf(d1[l] - d2[l]));
+		return bound;
+	}
+
+	static int getCount(void) { return count; }
+	static const AStarNode& getLandmark(int l) { return landmarks[l]; }
+	static size_t getBytesPerLandmark(void) { return GraphFunctionContainer::getHashTableSize() * sizeof(float); }
+
+private:
+	static void addLandmark(int x, int y);
+	static void computeDistances(int l, std::vector<float>& distance);
+	static void work(std::atomic<int>* nextLandmark);
+
+	static std::vector<AStarNode> landmarks;
+	static int count;
+	static std::vector<float> distances; // by hash bin, then landmark; -1 for nodes a landmark cannot reach
+	static int worldGeneration, hashTableSize; // the tables are for
+};
+
+#endif // BZF_LANDMARKS_H
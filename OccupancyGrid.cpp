@@ -0,0 +1,135 @@
+#include "OccupancyGrid.h"
+#include <math.h>
+#include <thread>
+#include <algorithm>
+#include "common.h"
+#include "BZDBCache.h"
+#include "Obstacle.h"
+#include "CollisionManager.h"
+
+int OccupancyGrid::xmin, OccupancyGrid::ymin;
+int OccupancyGrid::width, OccupancyGrid::height;
+int OccupancyGrid::wordsPerRow, OccupancyGrid::tileRows;
+std::vector<uint64_t> OccupancyGrid::blocked;
+int OccupancyGrid::tested = 0;
+int OccupancyGrid::blockedNodes = 0;
+int OccupancyGrid::worldGeneration = -1;
+
+void OccupancyGrid::build(int threads)
+{
+	xmin = GraphFunctionContainer::Xmin;
+	ymin = GraphFunctionContainer::Ymin;
+	width = GraphFunctionContainer::Xmax - xmin + 1;
+	height = GraphFunctionContainer::Ymax - ymin + 1;
+	wordsPerRow = (width + 63) / 64;
+	tileRows = (height + OCCUPANCY_TILE_ROWS - 1) / OCCUPANCY_TILE_ROWS;
+	blocked.assign(wordsPerRow * height, 0);
+
+	// the obstacles near each tile, from the collision manager, which only the game thread may query.
+	// A tile with none is free; the rest are rasterised below.
+	const float radius = BZDBCache::tankRadius / 2;
+	std::vector< std::vector<const Obstacle*> > nearby(wordsPerRow * tileRows);
+	tested = 0;
+	for (int t = 0; t < (int)nearby.size(); t++) {
+		int x0 = xmin + (t % wordsPerRow) * 64, y0 = ymin + (t / wordsPerRow) * OCCUPANCY_TILE_ROWS;
+		int x1 = std::min(x0 + 63, xmin + width - 1), y1 = std::min(y0 + OCCUPANCY_TILE_ROWS - 1, ymin + height - 1);
+		float center[3] = { (x0 + x1) * SCALE / 2, (y0 + y1) * SCALE / 2, 0.0f };
+		float reach = hypotf((float)(x1 - x0), (float)(y1 - y0)) * SCALE / 2 + radius;
+		const ObsList* olist = COLLISIONMGR.cylinderTest(center, reach, BZDBCache::tankHeight);
+		for (int i = 0; i < olist->count; i++)
+			nearby[t].push_back(olist->list[i]);
+		if (!nearby[t].empty())
+			tested += (x1 - x0 + 1) * (y1 - y0 + 1);
+	}
+
+	std::atomic<int> nextTile(0);
+	std::vector<std::thread> workers;
+	for (int i = 1; i < threads; i++)
+		workers.push_back(std::thread(&OccupancyGrid::rasterise, &nextTile, &nearby));
+	rasterise(&nextTile, &nearby);
+	for (int i = 0; i < (int)workers.size(); i++)
+		workers[i].join();
+	blockedNodes = 0;
+	for (int i = 0; i < (int)blocked.size(); i++)
+		for (uint64_t bits = blocked[i]; bits; bits &= bits - 1)
+			blockedNodes++;
+
+	worldGeneration = GraphFunctionContainer::getWorldGeneration();
+}
+
+bool OccupancyGrid::isBuilt(void)
+{
+	return worldGeneration == GraphFunctionContainer::getWorldGeneration()
+		&& xmin == GraphFunctionContainer::Xmin && ymin == GraphFunctionContainer::Ymin
+		&& width == GraphFunctionContainer::Xmax - xmin + 1 && height == GraphFunctionContainer::Ymax - ymin + 1;
+}
+
+// walks the rows the line crosses; in each row, the cells between where the line enters and leaves the
+// row are tested together
+bool OccupancyGrid::isLineClear(int x0, int y0, int x1, int y1)
+{
+	if (y0 == y1)
+		return isRowClear(y0, std::min(x0, x1), std::max(x0, x1));
+	if (y0 > y1) {
+		std::swap(x0, x1);
+		std::swap(y0, y1);
+	}
+	double slope = (double)(x1 - x0) / (y1 - y0);
+	for (int y = y0; y <= y1; y++) {
+		// the part of the line inside the row, which reaches half a node spacing around y
+		double xa = x0 + (std::max(y - 0.5, (double)y0) - y0) * slope;
+		double xb = x0 + (std::min(y + 0.5, (double)y1) - y0) * slope;
+		if (xa > xb)
+			std::swap(xa, xb);
+		if (!isRowClear(y, (int)floor(xa + 0.5), (int)ceil(xb - 0.5)))
+			return false;
+	}
+	return true;
+}
+
+bool OccupancyGrid::isRowClear(int y, int xa, int xb)
+{
+	if (xa > xb)
+		return true;
+	if (y < ymin || y >= ymin + height || xa < xmin || xb >= xmin + width)
+		return false;
+	const uint64_t* row = &blocked[(y - ymin) * wordsPerRow];
+	int first = xa - xmin, last = xb - xmin;
+	for (int w = first >> 6; w <= last >> 6; w++) {
+		uint64_t mask = ~(uint64_t)0;
+		if (w == first >> 6)
+			mask &= ~(uint64_t)0 << (first & 63);
+		if (w == last >> 6 && (last & 63) != 63)
+			mask &= ((uint64_t)1 << ((last & 63) + 1)) - 1;
+		if (row[w] & mask)
+			return false;
+	}
+	return true;
+}
+
+// worker thread: rasterises tiles until none are left. A tile covers whole words, so threads never share one.
+void OccupancyGrid::rasterise(std::atomic<int>* nextTile, const std::vector< std::vector<const Obstacle*> >* nearby)
+{
+	const float radius = BZDBCache::tankRadius / 2;
+	for (int t = (*nextTile)++; t < (int)nearby->size(); t = (*nextTile)++) {
+		const std::vector<const Obstacle*>& obstacles = (*nearby)[t];
+		if (obstacles.empty())
+			continue;
+		int word = t % wordsPerRow;
+		int x0 = xmin + word * 64, y0 = ymin + (t / wordsPerRow) * OCCUPANCY_TILE_ROWS;
+		int x1 = std::min(x0 + 63, xmin + width - 1), y1 = std::min(y0 + OCCUPANCY_TILE_ROWS - 1, ymin + height - 1);
+		for (int y = y0; y <= y1; y++) {
+			uint64_t bits = 0;
+			for (int x = x0; x <= x1; x++) {
+				// the test World::inBuilding makes, on the obstacles it would find
+				float pos[3] = { x * SCALE, y * SCALE, 0.0f };
+				for (int i = 0; i < (int)obstacles.size(); i++)
+					if (obstacles[i]->inCylinder(pos, radius, BZDBCache::tankHeight)) {
+						bits |= (uint64_t)1 << (x - x0);
+						break;
+					}
+			}
+			blocked[(y - ymin) * wordsPerRow + word] = bits;
+		}
+	}
+}
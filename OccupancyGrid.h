@@ -0,0 +1,55 @@
+#pragma once
+
+#ifndef	BZF_OCCUPANCYGRID_H
+#define	BZF_OCCUPANCYGRID_H
+
+#include "AStarNode.h"
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+
+class Obstacle;
+
+#define OCCUPANCY_THREADS 4 // threads that rasterise the world, 0 to do it in the calling thread
+#define OCCUPANCY_TILE_ROWS 8 // tile height in nodes; tiles are one 64 bit word of a row wide
+
+// ============================================================
+// Accessibility of every node of the current world, one bit per node, so that AStarNode::isAccessible
+// does not query the world's obstacles for every node a planner touches. Rasterised once when a world
+// is loaded: for each tile of nodes the obstacles near it are collected, and only the nodes of tiles
+// that have some (the tiles partly blocked) are tested against their exact geometry, on several threads.
+// The bit of a node holds the same answer World::inBuilding gives for it.
+
+class OccupancyGrid
+{
+public:
+	// Rasterises the obstacles for the current world bounds (see GraphFunctionContainer::setWorldSize)
+	static void build(int threads = OCCUPANCY_THREADS);
+	// true once built for the current world and bounds
+	static bool isBuilt(void);
+
+	// true if node (x, y), inside the world bounds, is in a building
+	static bool isBlocked(int x, int y)
+		{ return (blocked[(y - ymin) * wordsPerRow + ((x - xmin) >> 6)] >> ((x - xmin) & 63)) & 1; }
+
+	// true if the straight line between nodes (x0, y0) and (x1, y1) only crosses the cells of accessible nodes
+	// (the cell of a node reaches half a node spacing around it; touching a cell's edge or corner does not count).
+	// Blocked nodes already keep half a tank radius from buildings, so this sweeps a corridor of that width.
+	// The world must be built (isBuilt); nodes outside the world count as blocked.
+	static bool isLineClear(int x0, int y0, int x1, int y1);
+
+	static int getTestedNodeCount(void) { return tested; } // nodes the last build checked against obstacles
+	static float getBlockedFraction(void) { return (float)blockedNodes / (width * height); } // of the nodes in the world bounds
+
+private:
+	static bool isRowClear(int y, int xa, int xb); // nodes xa..xb of row y, a word at a time
+	static void rasterise(std::atomic<int>* nextTile, const std::vector< std::vector<const Obstacle*> >* nearby);
+
+	static int xmin, ymin, width, height, wordsPerRow, tileRows;
+	static std::vector<uint64_t> blocked; // a row of nodes starts at a new word
+	static int tested;
+	static int blockedNodes;
+	static int worldGeneration; // world the grid was built for
+};
+
+#endif // BZF_OCCUPANCYGRID_H
@@ -0,0 +1,56 @@
+#include "PathCache.h"
+
+PathCache::PathCache(void)
+	: hits(0), subpathHits(0), misses(0)
+{
+}
+
+bool PathCache::find(GraphFunctionContainer& graph, const AStarNode& start, const AStarNode& goal, std::vector<AStarNode>& path)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	graph.getCostSources(costSources);
+	int generation = GraphFunctionContainer::getWorldGeneration();
+	for (std::list<Entry>::iterator it = entries.begin(); it != entries.end(); ) {
+		if (it->worldGeneration != generation) {
+			it = entries.erase(it); // planned on an old world
+			continue;
+		}
+		if (it->path.front() == goal && it->costProfile == graph.getCostProfile() && it->costSources == costSources) {
+			// the start is usually near the end of the path, where robots spawn
+			for (int i = (int)it->path.size() - 1; i >= 0; i--) {
+				if (it->path[i] == start) {
+					path.assign(it->path.begin(), it->path.begin() + i + 1);
+					entries.splice(entries.begin(), entries, it);
+					hits++;
+					if (i != (int)entries.front().path.size() - 1)
+						subpathHits++;
+					return true;
+				}
+			}
+		}
+		++it;
+	}
+	misses++;
+	return false;
+}
+
+void PathCache::add(GraphFunctionContainer& graph, const std::vector<AStarNode>& path)
+{
+	if (path.empty())
+		return;
+	std::lock_guard<std::mutex> lock(mutex);
+	Entry entry;
+	entry.costProfile = graph.getCostProfile();
+	graph.getCostSources(entry.costSources);
+	entry.worldGeneration = GraphFunctionContainer::getWorldGeneration();
+	entry.path = path;
+	entries.push_front(entry);
+	if (entries.size() > PATH_CACHE_SIZE)
+		entries.pop_back();
+}
+
+void PathCache::clear(void)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	entries.clear();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef	BZF_PATHCACHE_H
+#define	BZF_PATHCACHE_H
+
+#include "AStarNode.h"
+#include <vector>
+#include <list>
+#include <mutex>
+#include <atomic>
+
+#define PATH_CACHE_SIZE 32 // paths kept by a PathCache
+
+// ============================================================
+// Planned paths shared by all robots, so that teammates and respawned robots going the same way
+// do not plan the same route again. A path is keyed by its start and goal node and the cost profile
+// and cost sources of the graph it was planned on (see GraphFunctionContainer::getCostSources).
+// A start anywhere on a cached path reuses the rest of that path, so only cheapest paths may be added:
+// the rest of one is still a cheapest path from there, which does not hold for inflated (ARA*),
+// any-angle or hierarchical (AStarHierarchy) paths. Only for graphs with trackable costs: costs from
+// enemies change all the time. Keeps the PATH_CACHE_SIZE paths used last. Safe to use from several
+// planner threads.
+
+class PathCache
+{
+public:
+	PathCache(void);
+
+	// Path from start to goal on graph's costs in planner order (goal first, start last, one node per step).
+	// false if no cached path for the same goal and costs passes through start.
+	bool find(GraphFunctionContainer& graph, const AStarNode& start, const AStarNode& goal, std::vector<AStarNode>& path);
+	// Adds a cheapest path planned on graph's costs, in planner order
+	void add(GraphFunctionContainer& graph, const std::vector<AStarNode>& path);
+	void clear(void);
+
+	int getHitCount(void) const { return hits; } // finds served, from the start of a cached path or a later node
+	int getSubpathHitCount(void) const { return subpathHits; } // hits from a later node
+	int getMissCount(void) const { return misses; }
+
+private:
+	PathCache(const PathCache&);
+	PathCache& operator=(const PathCache&);
+
+	struct Entry
+	{
+		int costProfile;
+		std::vector<AStarNode> costSources;
+		int worldGeneration;
+		std::vector<AStarNode> path;
+	};
+
+	std::mutex mutex; // guards entries and costSources
+	std::list<Entry> entries; // most recently used first
+	std::vector<AStarNode> costSources; // scratch list
+	std::atomic<int> hits, subpathHits, misses; // read without the lock
+};
+
+#endif // BZF_PATHCACHE_H
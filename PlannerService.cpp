@@ -0,0 +1,156 @@
+#include "PlannerService.h"
+#include <algorithm>
+
+PlannerService::PlannerService(void)
+	: stopping(false), nextSerial(1)
+{
+}
+
+PlannerService::~PlannerService(void)
+{
+	stop();
+}
+
+void PlannerService::start(int threads)
+{
+	if (!workers.empty())
+		return;
+	stopping = false;
+	for (int i = 0; i < threads; i++)
+		workers.push_back(std::thread(&PlannerService::work, this));
+}
+
+void PlannerService::stop(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		queued.clear();
+		current.clear();
+	}
+	requestQueued.notify_all();
+	for (int i = 0; i < (int)workers.size(); i++)
+		workers[i].join();
+	workers.clear();
+	finished.clear();
+}
+
+void PlannerService::submit(const void* owner, int priority, const Job& job, const Completion& completion)
+{
+	Request request;
+	request.owner = owner;
+	request.priority = priority;
+	request.job = job;
+	request.completion = completion;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	request.serial = nextSerial++;
+	current[owner] = request.serial; // a queued or running request of the owner is stale from now on
+	for (std::list<Request>::iterator it = queued.begin(); it != queued.end(); )
+		if (it->owner == owner)
+			it = queued.erase(it);
+		else
+			++it;
+
+	if (workers.empty()) {
+		lock.unlock();
+		request.job(request.paths);
+		lock.lock();
+		if (isCurrent(request))
+			finished.push_back(request);
+		return;
+	}
+	queued.push_back(request);
+	lock.unlock();
+	requestQueued.notify_one();
+}
+
+void PlannerService::cancel(const void* owner, bool wait)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	current.erase(owner);
+	for (std::list<Request>::iterator it = queued.begin(); it != queued.end(); )
+		if (it->owner == owner)
+			it = queued.erase(it);
+		else
+			++it;
+	while (wait && isRunning(owner))
+		jobFinished.wait(lock);
+}
+
+void PlannerService::cancelAll(bool wait)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	current.clear();
+	queued.clear();
+	finished.clear();
+	while (wait && !running.empty())
+		jobFinished.wait(lock);
+}
+
+bool PlannerService::isPending(const void* owner)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return current.count(owner) != 0;
+}
+
+void PlannerService::deliver(void)
+{
+	std::vector<Request> done;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		done.swap(finished);
+	}
+	for (int i = 0; i < (int)done.size(); i++) {
+		{
+			// an earlier completion may have submitted or cancelled for the same owner
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!isCurrent(done[i]))
+				continue;
+			current.erase(done[i].owner);
+		}
+		done[i].completion(done[i].paths);
+	}
+}
+
+// worker thread: runs the queued request with the highest priority (the oldest of those)
+// whose owner has no job running, until stop()
+void PlannerService::work(void)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		std::list<Request>::iterator best = queued.end();
+		for (std::list<Request>::iterator it = queued.begin(); it != queued.end(); ++it)
+			if ((best == queued.end() || it->priority > best->priority) && !isRunning(it->owner))
+				best = it;
+		if (stopping)
+			return;
+		if (best == queued.end()) {
+			requestQueued.wait(lock);
+			continue;
+		}
+
+		Request request = *best;
+		queued.erase(best);
+		running.push_back(request.owner);
+		lock.unlock();
+		request.job(request.paths);
+		lock.lock();
+		running.erase(std::find(running.begin(), running.end(), request.owner));
+		if (isCurrent(request))
+			finished.push_back(request);
+		jobFinished.notify_all();
+		requestQueued.notify_all(); // the owner may have a newer request waiting for this one
+	}
+}
+
+bool PlannerService::isRunning(const void* owner) const
+{
+	return std::find(running.begin(), running.end(), owner) != running.end();
+}
+
+bool PlannerService::isCurrent(const Request& request) const
+{
+	std::map<const void*, unsigned long>::const_iterator it = current.find(request.owner);
+	return it != current.end() && it->second == request.serial;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#ifndef	BZF_PLANNERSERVICE_H
+#define	BZF_PLANNERSERVICE_H
+
+#include "AStarNode.h"
+#include <vector>
+#include <list>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#ifndef PLANNER_THREADS
+#define PLANNER_THREADS 2 // worker threads of the robots' planner service, 0 to plan in the calling thread
+#endif
+
+// request priorities, higher ones are planned first
+#define PLAN_PRIORITY_DETOUR 0
+#define PLAN_PRIORITY_TARGET 1
+#define PLAN_PRIORITY_RETURN 2 // robots carrying a flag home
+
+// ============================================================
+// Runs path planning requests on a pool of worker threads, so that planning does not hold up the game loop.
+// A request belongs to an owner (a robot). It has a job, which runs on a worker and fills in the paths, and a
+// completion, which gets the paths back on the game thread in deliver(). An owner has at most one live request:
+// a newer one replaces it, and the older one's result is dropped. Jobs of the same owner never run at the same
+// time, so a job may use its owner's planners. Jobs must only read world data that does not change while a
+// world is loaded (see GraphFunctionContainer); the game thread has to cancel all requests before loading a new one.
+
+class PlannerService
+{
+public:
+	typedef std::vector< std::vector< AStarNode > > Paths;
+	typedef std::function<void (Paths& paths)> Job;
+	typedef std::function<void (Paths& paths)> Completion;
+
+	PlannerService(void);
+	~PlannerService(void);
+
+	void start(int threads); // starts the workers, unless they run already
+	void stop(void); // drops all requests and joins the workers
+	int getThreadCount(void) const { return workers.size(); }
+
+	// Queues a request. Without workers the job runs right away; the completion still waits for deliver().
+	void submit(const void* owner, int priority, const Job& job, const Completion& completion);
+	// Drops the owner's request. With wait, also waits until its job is no longer running,
+	// e.g. before the owner is deleted.
+	void cancel(const void* owner, bool wait = false);
+	void cancelAll(bool wait = true);
+	bool isPending(const void* owner); // true from submit until the completion ran or the request was dropped
+
+	// Runs the completions of the jobs finished since the last call. Call from the game thread.
+	void deliver(void);
+
+private:
+	PlannerService(const PlannerService&);
+	PlannerService& operator=(const PlannerService&);
+
+	struct Request
+	{
+		const void* owner;
+		int priority;
+		unsigned long serial; // tells a request from the ones that replaced it
+		Job job;
+		Completion completion;
+		Paths paths;
+	};
+
+	void work(void);
+	bool isRunning(const void* owner) const;
+	bool isCurrent(const Request& request) const;
+
+	std::vector<std::thread> workers;
+	std::mutex mutex; // guards everything below
+	std::condition_variable requestQueued, jobFinished;
+	bool stopping;
+	unsigned long nextSerial;
+	std::list<Request> queued; // in submit order
+	std::vector<const void*> running; // owners whose job runs
+	std::vector<Request> finished; // waiting for deliver
+	std::map<const void*, unsigned long> current; // serial of each owner's live request
+};
+
+#endif // BZF_PLANNERSERVICE_H
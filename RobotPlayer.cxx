@@ -20,6 +20,7 @@
 //#define TRACE_PLANNER
 //#define TRACE_DECTREE
 #define ASTAR_TRACE
+//#define PATH_CACHE_TRACE
 //#define SHOT_TRACE
 #define SEEK_FLAG_TRACE
 #define STATUS_TRACE
@@ -35,15 +36,21 @@
 #include "Intersect.h"
 #include "TargetingUtils.h"
 
-#include "playing.h" // needed for numFlags, controlPanel, serverLink
+#include "playing.h" // needed for controlPanel, serverLink
 #include "Roster.h" // needed for robots[]
 #include "BZDBCache.h" // needed for worldSize, tankRadius
 #include <time.h>  // needed for clock_t, clock, CLOCKS_PER_SECOND
 #include "dectree.h" // needed for decision trees
+#include "WorldView.h" // needed for the players, flags and shots of this tick
 #include <algorithm>
 #include <limits>
 
 std::vector<BzfRegion*>* RobotPlayer::obstacleList = NULL;
+PlannerService RobotPlayer::plannerService;
+FlowFieldCache RobotPlayer::flowFields;
+PathCache RobotPlayer::pathCache;
+WorkStealingPool RobotPlayer::decisionPool;
+RobotPlayer::DecisionSettings RobotPlayer::settings;
 
 const float RobotPlayer::CohesionW = 1.0f;
 const float RobotPlayer::SeparationW = 1000.0f;
@@ -59,12 +66,102 @@ RobotPlayer::RobotPlayer(const PlayerId& _id, const char* _name,
 				timerForShot(0.0f),
 				drivingForward(true),
 				currentStatus(UNDEFINED),
-				seekingFlag(false)
+				seekingFlag(false),
+				planningTarget(false),
+				decided(false),
+				ownStateUpdated(false),
+				shootingAction(NULL),
+				dropFlagAction(NULL),
+				motionAction(NULL)
 {
   gettingSound = false;
   server       = _server;
 }
 
+RobotPlayer::~RobotPlayer()
+{
+  // a planner thread may still use this robot's planners
+  plannerService.cancel(this, true);
+}
+
+/*
+ * hand the paths planned on the planner threads to their robots
+ */
+void			RobotPlayer::deliverPlans()
+{
+  AI_PROFILE_SCOPE(AIProfile::PLANNING);
+  plannerService.deliver();
+}
+
+/*
+ * sense and decide for all robots, on the world as it is now. The robots only read the world
+ * and change themselves here, so they decide on the threads of decisionPool; what they do comes
+ * after, one robot at a time, in their update(). Nothing may change the world meanwhile.
+ * First, on the game thread, each robot's own shots, reload and explosion move on to this tick,
+ * which update() would only do after deciding, so that the trees see the robot as it acts.
+ * The shots of the others are those of the tick's WorldView for every robot: a shot fired in this
+ * tick shows in the next, as a remote player's does (shotComing ignores the robot's own shots).
+ * The shooting tree also runs there, since isShotCloseToTarget and isBuildingInWay test the
+ * buildings with the collision manager, which is not thread-safe; the other trees run in parallel.
+ */
+void			RobotPlayer::decideAll(float dt)
+{
+  readSettings();
+  for (int i = 0; i < numRobots; i++)
+    if (robots[i]) {
+      robots[i]->LocalPlayer::doUpdate(dt);
+      robots[i]->ownStateUpdated = true;
+      robots[i]->decideShooting(dt);
+    }
+  decisionPool.run(numRobots, [dt](int i) {
+    if (robots[i])
+      robots[i]->decideMoves(dt);
+  });
+}
+
+/*
+ * run the decision trees, and keep the actions they chose for the next update
+ */
+void			RobotPlayer::decide(float dt)
+{
+  decideShooting(dt);
+  decideMoves(dt);
+}
+
+void			RobotPlayer::decideShooting(float dt)
+{
+  AI_PROFILE_SCOPE(AIProfile::DECISIONS);
+  // fire shot if any available
+  timerForShot  -= dt;
+  if (timerForShot < 0.0f)
+    timerForShot = 0.0f;
+
+  shootingAction = aicore::DecisionPtr::findAction(aicore::DecisionTrees::doUpdateShootingDecisions, this, dt);
+}
+
+void			RobotPlayer::decideMoves(float dt)
+{
+  AI_PROFILE_SCOPE(AIProfile::DECISIONS);
+  dropFlagAction = aicore::DecisionPtr::findAction(aicore::DecisionTrees::doUpdateDropFlagDecisions, this, dt);
+  motionAction = aicore::DecisionPtr::findAction(aicore::DecisionTrees::doUpdateMotionDecisions, this, dt);
+  decided = true;
+}
+
+/*
+ * copy the BZDB values decide() reads; on the game thread only
+ */
+void			RobotPlayer::readSettings(void)
+{
+  settings.muzzleFront = BZDB.eval(StateDatabase::BZDB_MUZZLEFRONT);
+  settings.muzzleHeight = BZDB.eval(StateDatabase::BZDB_MUZZLEHEIGHT);
+  settings.shotRadius = BZDB.eval(StateDatabase::BZDB_SHOTRADIUS);
+  settings.shotRange = BZDB.eval(StateDatabase::BZDB_SHOTRANGE);
+  settings.shotSpeed = BZDB.eval(StateDatabase::BZDB_SHOTSPEED);
+  settings.laserAdVel = BZDB.eval(StateDatabase::BZDB_LASERADVEL);
+  settings.rapidFireAdVel = BZDB.eval(StateDatabase::BZDB_RFIREADVEL);
+  settings.machineGunAdVel = BZDB.eval(StateDatabase::BZDB_MGUNADVEL);
+}
+
 // estimate a player's position at now+t, similar to dead reckoning
 void RobotPlayer::projectPosition(const Player *targ,const float t,float &x,float &y,float &z) const
 {
@@ -116,12 +213,12 @@ void RobotPlayer::getProjectedPosition(const Player *targ, float *projpos) const
   double hisy = targ->getPosition()[1];
   double deltax = hisx - myx;
   double deltay = hisy - myy;
-  double distance = hypotf(deltax,deltay) - BZDB.eval(StateDatabase::BZDB_MUZZLEFRONT) - BZDBCache::tankRadius;
+  double distance = hypotf(deltax,deltay) - settings.muzzleFront - BZDBCache::tankRadius;
   if (distance <= 0) distance = 0;
-  double shotspeed = BZDB.eval(StateDatabase::BZDB_SHOTSPEED)*
-    (getFlag() == Flags::Laser ? BZDB.eval(StateDatabase::BZDB_LASERADVEL) :
-     getFlag() == Flags::RapidFire ? BZDB.eval(StateDatabase::BZDB_RFIREADVEL) :
-     getFlag() == Flags::MachineGun ? BZDB.eval(StateDatabase::BZDB_MGUNADVEL) : 1) +
+  double shotspeed = settings.shotSpeed*
+    (getFlag() == Flags::Laser ? settings.laserAdVel :
+     getFlag() == Flags::RapidFire ? settings.rapidFireAdVel :
+     getFlag() == Flags::MachineGun ? settings.machineGunAdVel : 1) +
       hypotf(getVelocity()[0], getVelocity()[1]);
 
   double errdistance = 1.0;
@@ -145,26 +242,38 @@ void RobotPlayer::getProjectedPosition(const Player *targ, float *projpos) const
 }
 
 /*
- * Fire shot and drop flag if appropriate
+ * Fire shot and drop flag if decide() chose to
  */
 void			RobotPlayer::doUpdate(float dt)
 {
-  LocalPlayer::doUpdate(dt);
-
-  float tankRadius = BZDBCache::tankRadius;
-  const float shotRange  = BZDB.eval(StateDatabase::BZDB_SHOTRANGE);
-  const float shotRadius = BZDB.eval(StateDatabase::BZDB_SHOTRADIUS);
+  // decideAll may have done it already
+  if (!ownStateUpdated)
+    LocalPlayer::doUpdate(dt);
+  ownStateUpdated = false;
+  AI_PROFILE_SCOPE(AIProfile::DECISIONS);
+
+  // continue a plan spread over frames, and switch to the better paths it finds
+  // (not during a flag detour, which only exists in the current path)
+  {
+    AI_PROFILE_SCOPE(AIProfile::PLANNING);
+    slicedPlanner.resume();
+    if (slicedPlanner.hasNewPaths() && !seekingFlag)
+      takeSlicedPaths();
+  }
 
-  // fire shot if any available
-  timerForShot  -= dt;
-  if (timerForShot < 0.0f)
-    timerForShot = 0.0f;
+	// robots updated without decideAll decide now
+	if (!decided) {
+		readSettings();
+		decide(dt);
+	}
 
-	// Find the shooting decision
-	aicore::DecisionPtr::runDecisionTree(aicore::DecisionTrees::doUpdateShootingDecisions, this, dt);
+	// Do the shooting decision
+	if (shootingAction)
+		(this->*shootingAction)(dt);
 
-	// Find the drop flag decision
-	aicore::DecisionPtr::runDecisionTree(aicore::DecisionTrees::doUpdateDropFlagDecisions, this, dt);
+	// Do the drop flag decision
+	if (dropFlagAction)
+		(this->*dropFlagAction)(dt);
 }
 
 /*
@@ -181,6 +290,7 @@ bool		RobotPlayer::amAlive(float dt)
  */
 bool		RobotPlayer::shotComing(float dt)
 {
+    AI_PROFILE_SCOPE(AIProfile::PERCEPTION);
     // record previous position
     const float oldAzimuth = getAngle();
     const float* oldPosition = getPosition();
@@ -191,39 +301,27 @@ bool		RobotPlayer::shotComing(float dt)
     float azimuth = oldAzimuth;
 
     // basically a clone of Roger's evasive code
-    for (int t=0; t <= World::getWorld()->getCurMaxPlayers(); t++)
-    {
-      Player *p = 0;
-      if (t < World::getWorld()->getCurMaxPlayers())
-	p = World::getWorld()->getPlayer(t);
-      else
-	p = LocalPlayer::getMyTank();
-      if (!p || p->getId() == getId())
+    const WorldView& view = WorldView::get();
+    for (int s = 0; s < view.shotCount; s++) {
+      if (view.shotOwner[s] == getId())
 	continue;
-      const int maxShots = p->getMaxShots();
-      for (int s = 0; s < maxShots; s++) {
-	ShotPath* shot = p->getShot(s);
-	if (!shot || shot->isExpired())
-	  continue;
-
-	const float* shotPos = shot->getPosition();
-	if ((fabs(shotPos[2] - position[2]) > BZDBCache::tankHeight) && (shot->getFlag() != Flags::GuidedMissile))
-	  continue;
-	const float dist = TargetingUtils::getTargetDistance(position, shotPos);
-	if (dist < 150.0f) {
-	  const float *shotVel = shot->getVelocity();
-				shotAngle = atan2f(shotVel[1], shotVel[0]);
-	  float shotUnitVec[2] = {cosf(shotAngle), sinf(shotAngle)};
-
-	  float trueVec[2] = {(position[0]-shotPos[0])/dist,(position[1]-shotPos[1])/dist};
-	  float dotProd = trueVec[0]*shotUnitVec[0]+trueVec[1]*shotUnitVec[1];
-
-				if (dotProd > 0.97f)
-					return true;
-			}
-		}
-	}
-	return false;
+
+      const float shotPos[3] = {view.shotX[s], view.shotY[s], view.shotZ[s]};
+      if ((fabs(shotPos[2] - position[2]) > BZDBCache::tankHeight) && !view.shotGuided[s])
+	continue;
+      const float dist = TargetingUtils::getTargetDistance(position, shotPos);
+      if (dist < 150.0f) {
+	shotAngle = atan2f(view.shotVY[s], view.shotVX[s]);
+	float shotUnitVec[2] = {cosf(shotAngle), sinf(shotAngle)};
+
+	float trueVec[2] = {(position[0]-shotPos[0])/dist,(position[1]-shotPos[1])/dist};
+	float dotProd = trueVec[0]*shotUnitVec[0]+trueVec[1]*shotUnitVec[1];
+
+	if (dotProd > 0.97f)
+	  return true;
+      }
+    }
+    return false;
 }
 
 /*
@@ -267,6 +365,9 @@ void			RobotPlayer::evade(float dt)
     }
 
 void			RobotPlayer::seekFlag() {
+	AI_PROFILE_SCOPE(AIProfile::PERCEPTION);
+	if (plannerService.isPending(this))
+		return; // wait for the plan on the way
 	const float* oldPosition = getPosition();
 	float position[3];
 	position[0] = oldPosition[0];
@@ -285,33 +386,33 @@ void			RobotPlayer::seekFlag() {
 	char buffer[512];
 #endif
 
-	std::vector<Flag*> nearbyGoodFlags;
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
-		if (flagTeamColor == NoTeam && flag.status != FlagOnTank && flag.type->flagQuality == FlagGood) {
+	const WorldView& view = WorldView::get();
+	std::vector<int> nearbyGoodFlags;
+	for (int i = 0; i < view.flagCount; i++) {
+		FlagType* type = view.flagType[i];
+		if (view.flagTeam[i] == NoTeam && view.flagStatus[i] != FlagOnTank && type->flagQuality == FlagGood) {
 			float acceptableDistance = 0.0f;
-			if (flag.type == Flags::Genocide) {
+			if (type == Flags::Genocide) {
 				acceptableDistance = genocideValue;
 			}
-			else if (flag.type == Flags::Laser) {
+			else if (type == Flags::Laser) {
 				acceptableDistance = laserValue;
 			}
-			else if (flag.type == Flags::Velocity) {
+			else if (type == Flags::Velocity) {
 				acceptableDistance = velocityValue;
 			}
-			else if (flag.type == Flags::Burrow || flag.type == Flags::Seer || flag.type == Flags::Jumping) {
+			else if (type == Flags::Burrow || type == Flags::Seer || type == Flags::Jumping) {
 				acceptableDistance = 0.0f;
 			}
 			else {
 				acceptableDistance = otherValue;
 			}
-			if (hypotf(flag.position[0] - position[0], flag.position[1] - position[1]) <= acceptableDistance) {
+			if (hypotf(view.flagX[i] - position[0], view.flagY[i] - position[1]) <= acceptableDistance) {
 #ifdef SEEK_FLAG_TRACE
 				sprintf(buffer, "%s Found Candidate", getCallSign());
 				controlPanel->addMessage(buffer);
 #endif
-				nearbyGoodFlags.push_back(&World::getWorld()->getFlag(i));
+				nearbyGoodFlags.push_back(i);
 			}
 		}
 	}
@@ -321,18 +422,19 @@ void			RobotPlayer::seekFlag() {
 		controlPanel->addMessage(buffer);
 #endif
 		float bestValue = 0.0f; //based on flag's worth and distance
-		Flag* bestFlag = NULL;
-		for (Flag* flag : nearbyGoodFlags) {
-			float flagDistance = hypotf(flag->position[0] - position[0], flag->position[1] - position[1]);
-			if (flag->type == Flags::Genocide && bestValue < genocideValue + genocideValue - flagDistance) {
+		int bestFlag = -1;
+		for (int flag : nearbyGoodFlags) {
+			FlagType* type = view.flagType[flag];
+			float flagDistance = hypotf(view.flagX[flag] - position[0], view.flagY[flag] - position[1]);
+			if (type == Flags::Genocide && bestValue < genocideValue + genocideValue - flagDistance) {
 				bestValue = genocideValue + genocideValue - flagDistance;
 				bestFlag = flag;
 			}
-			else if (flag->type == Flags::Laser && bestValue < laserValue + genocideValue - flagDistance) {
+			else if (type == Flags::Laser && bestValue < laserValue + genocideValue - flagDistance) {
 				bestValue = laserValue + genocideValue - flagDistance;
 				bestFlag = flag;
 			}
-			else if (flag->type == Flags::Velocity && bestValue < velocityValue + genocideValue - flagDistance) {
+			else if (type == Flags::Velocity && bestValue < velocityValue + genocideValue - flagDistance) {
 				bestValue = velocityValue + genocideValue - flagDistance;
 				bestFlag = flag;
 			}
@@ -341,37 +443,67 @@ void			RobotPlayer::seekFlag() {
 				bestFlag = flag;
 			}
 		}
-		if (bestValue != 0.0f && bestFlag != NULL) {
+		if (bestValue != 0.0f && bestFlag >= 0) {
+			const float bestFlagPosition[3] = {view.flagX[bestFlag], view.flagY[bestFlag], view.flagZ[bestFlag]};
 #ifdef SEEK_FLAG_TRACE
 			sprintf(buffer, "Good Flag Found at (%f, %f), %s taking detour, current position: (%f, %f)", 
-				bestFlag->position[0], bestFlag->position[1], getCallSign(), getPosition()[0], getPosition()[1]);
+				bestFlagPosition[0], bestFlagPosition[1], getCallSign(), getPosition()[0], getPosition()[1]);
 			controlPanel->addMessage(buffer);
 #endif
+			int nextIndex = std::max(0, findClosestPartOfPath(bestFlagPosition) - 1);
+			float nextNode[3] = { paths[0][nextIndex].getScaledX(), paths[0][nextIndex].getScaledY(), 0.0f };
+			if (plannerService.getThreadCount() > 0) {
+				// plan both legs on a planner thread, takeDetourPaths gets them at the start of a later updateRobots
+				GraphFunctionContainer fun_cont(BZDBCache::worldSize, currentStatus, LocalPlayer::getMyTank());
+				AStarNode startNode(getPosition()), flagNode(bestFlagPosition), returnNode(nextNode);
+				int status = currentStatus;
+				planningTarget = false;
+				plannerService.submit(this, PLAN_PRIORITY_DETOUR,
+					[this, fun_cont, status, startNode, flagNode, returnNode](PlannerService::Paths& legs) mutable {
+						std::vector<std::vector<AStarNode>> pathReturn;
+						planPaths(fun_cont, status, startNode, flagNode, legs, false);
+						planPaths(fun_cont, status, flagNode, returnNode, pathReturn, false);
+						if (!legs.empty() && !pathReturn.empty())
+							legs.push_back(pathReturn[0]);
+					},
+					[this, nextIndex](PlannerService::Paths& legs) {
+						if (legs.size() == 2)
+							takeDetourPaths(legs[0], legs[1], nextIndex);
+					});
+				return;
+			}
 			std::vector<std::vector<AStarNode>> detour;
-			aStarSearch(getPosition(), bestFlag->position, detour);
+			aStarSearch(getPosition(), bestFlagPosition, detour);
 			std::vector<std::vector<AStarNode>> pathReturn;
-			int nextIndex = std::max(0, findClosestPartOfPath(bestFlag->position) - 1);
-			float nextNode[3] = { paths[0][nextIndex].getScaledX(), paths[0][nextIndex].getScaledY(), 0.0f };
-			aStarSearch(bestFlag->position, nextNode, pathReturn);
+			aStarSearch(bestFlagPosition, nextNode, pathReturn);
 
 			if (!detour.empty() && !pathReturn.empty()) {
-
-				for (int i = pathReturn[0].size() - 2; i >= 0; i--) {
-					detour[0].insert(detour[0].begin(), pathReturn[0][i]);
-				}
-				for (int i = detour[0].size() - 2; i >= 0; i--) {
-					paths[0].insert(paths[0].begin() + nextIndex, detour[0][i]);
-				}
-
-				int indexAdjustment = std::max(0, (int) detour[0].size() - 2);
-
-				pathIndex = nextIndex + indexAdjustment;
-				seekingFlag = true;
+				takeDetourPaths(detour[0], pathReturn[0], nextIndex);
 			}
 		}
 	}
 }
 
+/*
+ * splice the detour to a flag and the path back from it into the path at nextIndex
+ */
+void			RobotPlayer::takeDetourPaths(std::vector<AStarNode>& detour, std::vector<AStarNode>& pathReturn, int nextIndex) {
+	if (paths.empty() || nextIndex >= (int)paths[0].size())
+		return; // the path changed meanwhile
+
+	for (int i = pathReturn.size() - 2; i >= 0; i--) {
+		detour.insert(detour.begin(), pathReturn[i]);
+	}
+	for (int i = detour.size() - 2; i >= 0; i--) {
+		paths[0].insert(paths[0].begin() + nextIndex, detour[i]);
+	}
+
+	int indexAdjustment = std::max(0, (int) detour.size() - 2);
+
+	pathIndex = nextIndex + indexAdjustment;
+	seekingFlag = true;
+}
+
 int		RobotPlayer::findClosestPartOfPath(float* position) {
 	int bestIndex = 0;
 	float bestDistance = std::numeric_limits<float>::infinity();
@@ -391,6 +523,7 @@ int		RobotPlayer::findClosestPartOfPath(float* position) {
  */
 void			RobotPlayer::followPath(float dt)
 {
+	AI_PROFILE_SCOPE(AIProfile::PATH_FOLLOWING);
 	// record previous position
 	const float oldAzimuth = getAngle();
 	const float* oldPosition = getPosition();
@@ -538,10 +671,11 @@ bool		RobotPlayer::hasShotTimerElapsed(float dt)
  */
 bool		RobotPlayer::isShotCloseToTarget(float dt)
 {
+	AI_PROFILE_SCOPE(AIProfile::PERCEPTION);
 	if(!target) return false;
 	const float azimuth = getAngle();
 	float tankRadius = BZDBCache::tankRadius;
-	const float shotRadius = BZDB.eval(StateDatabase::BZDB_SHOTRADIUS);
+	const float shotRadius = settings.shotRadius;
 	float p1[3];
 	getProjectedPosition(target, p1);
 	const float* p2     = getPosition();
@@ -556,7 +690,7 @@ bool		RobotPlayer::isShotCloseToTarget(float dt)
 			azimuthDiff += (float)(2.0 * M_PI);
 
 	targetdistance = hypotf(p1[0] - p2[0], p1[1] - p2[1]) -
-		BZDB.eval(StateDatabase::BZDB_MUZZLEFRONT) - tankRadius;
+		settings.muzzleFront - tankRadius;
 
 	const float missby = fabs(azimuthDiff) *
 		(targetdistance - BZDBCache::tankLength);
@@ -571,9 +705,10 @@ bool		RobotPlayer::isShotCloseToTarget(float dt)
  */
 bool		RobotPlayer::isBuildingInWay(float dt)
 {
+	AI_PROFILE_SCOPE(AIProfile::PERCEPTION);
 	const float azimuth = getAngle();
 	float pos[3] = {getPosition()[0], getPosition()[1],
-		getPosition()[2] +  BZDB.eval(StateDatabase::BZDB_MUZZLEHEIGHT)};
+		getPosition()[2] + settings.muzzleHeight};
 	targetdir[0] = cosf(azimuth);
 	targetdir[1] = sinf(azimuth);
 	targetdir[2] = 0.0f;
@@ -587,20 +722,17 @@ bool		RobotPlayer::isBuildingInWay(float dt)
  */
 bool		RobotPlayer::isTeammateInWay(float dt)
 {
-	const float shotRange  = BZDB.eval(StateDatabase::BZDB_SHOTRANGE);
+	AI_PROFILE_SCOPE(AIProfile::PERCEPTION);
+	const float shotRange  = settings.shotRange;
 
-	for (int i=0; i <= World::getWorld()->getCurMaxPlayers(); i++)
+	const WorldView& view = WorldView::get();
+	for (int i=0; i < view.playerCount; i++)
 	{
-		Player *p = 0;
-		if (i < World::getWorld()->getCurMaxPlayers())
-			p = World::getWorld()->getPlayer(i);
-		else
-			p = LocalPlayer::getMyTank();
-		if (!p || p->getId() == getId() || validTeamTarget(p) ||
-			!p->isAlive()) continue;
-		float relpos[3] = {getPosition()[0] - p->getPosition()[0],
-			getPosition()[1] - p->getPosition()[1],
-			getPosition()[2] - p->getPosition()[2]};
+		if (view.playerId[i] == getId() || !view.playerAlive[i] ||
+			validTeamTarget(view.player[i])) continue;
+		float relpos[3] = {getPosition()[0] - view.playerX[i],
+			getPosition()[1] - view.playerY[i],
+			getPosition()[2] - view.playerZ[i]};
 		Ray ray(relpos, targetdir);
 		float impact = rayAtDistanceFromOrigin(ray, 5 * BZDBCache::tankRadius);
 		if (impact > 0 && impact < shotRange) return true;
@@ -751,11 +883,12 @@ bool			RobotPlayer::isTargetVeryClose(float dt) {
 }
 
 bool			RobotPlayer::isTargetAFlag(float dt) {
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
-		if (flagTeamColor != NoTeam 
-			&& hypotf(paths[0][0].getScaledX() - flag.position[0], paths[0][0].getScaledY() - flag.position[1]) <= 2.0 * BZDBCache::tankRadius) {
+	if (paths.empty() || paths[0].empty())
+		return false; // no path, so no target at its end
+	const WorldView& view = WorldView::get();
+	for (int i = 0; i < view.flagCount; i++) {
+		if (view.flagTeam[i] != NoTeam
+			&& hypotf(paths[0][0].getScaledX() - view.flagX[i], paths[0][0].getScaledY() - view.flagY[i]) <= 2.0 * BZDBCache::tankRadius) {
 			return true;
 		}
 	}
@@ -763,12 +896,13 @@ bool			RobotPlayer::isTargetAFlag(float dt) {
 }
 
 bool			RobotPlayer::isTargetATank(float dt) {
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
-		if (flagTeamColor != NoTeam && flag.type->flagTeam != getTeam()
-			&& hypotf(paths[0][0].getScaledX() - flag.position[0], paths[0][0].getScaledY() - flag.position[1]) <= 2.0 * BZDBCache::tankRadius
-			&& flag.status == FlagOnTank ) {
+	if (paths.empty() || paths[0].empty())
+		return false; // no path, so no target at its end
+	const WorldView& view = WorldView::get();
+	for (int i = 0; i < view.flagCount; i++) {
+		if (view.flagTeam[i] != NoTeam && view.flagTeam[i] != getTeam()
+			&& hypotf(paths[0][0].getScaledX() - view.flagX[i], paths[0][0].getScaledY() - view.flagY[i]) <= 2.0 * BZDBCache::tankRadius
+			&& view.flagStatus[i] == FlagOnTank ) {
 			return true;
 		}
 	}
@@ -777,8 +911,13 @@ bool			RobotPlayer::isTargetATank(float dt) {
 
 void				RobotPlayer::doUpdateMotion(float dt)
 {
-	// Find the update motion decision
-	aicore::DecisionPtr::runDecisionTree(aicore::DecisionTrees::doUpdateMotionDecisions, this, dt);
+	// Do the update motion decision
+	{
+		AI_PROFILE_SCOPE(AIProfile::DECISIONS);
+		if (motionAction)
+			(this->*motionAction)(dt);
+	}
+	decided = false; // the next update needs new decisions
 	LocalPlayer::doUpdateMotion(dt);
 }
 
@@ -789,6 +928,8 @@ void			RobotPlayer::explodeTank()
   path.clear();
   paths.clear();
   pathIndex = -1;
+  slicedPlanner.cancel();
+  plannerService.cancel(this);
   seekingFlag = false;
   currentStatus = UNDEFINED;
 }
@@ -801,6 +942,8 @@ void			RobotPlayer::restart(const float* pos, float _azimuth)
   paths.clear();
   target = NULL;
   pathIndex = -1;
+  slicedPlanner.cancel();
+  plannerService.cancel(this);
   seekingFlag = false;
   currentStatus = UNDEFINED;
 
@@ -809,6 +952,7 @@ void			RobotPlayer::restart(const float* pos, float _azimuth)
 float			RobotPlayer::getTargetPriority(const
 							Player* _target) const
 {
+  AI_PROFILE_SCOPE(AIProfile::PERCEPTION);
   // don't target teammates or myself
   if (!this->validTeamTarget(_target))
     return 0.0f;
@@ -838,6 +982,22 @@ void		    RobotPlayer::setObstacleList(std::vector<BzfRegion*>*
 						     _obstacleList)
 {
   obstacleList = _obstacleList;
+  plannerService.cancelAll(); // plans on the old world have to finish before it changes
+  flowFields.clear();
+  pathCache.clear();
+  GraphFunctionContainer::worldChanged(); // new world, so planners must not reuse their node tables
+  GraphFunctionContainer::setWorldSize(BZDBCache::worldSize);
+  OccupancyGrid::build(); // before anything asks which nodes are accessible
+  GraphFunctionContainer::buildCoverField();
+  FixedCostGraphFunctionContainer::buildJumpDistances();
+  Landmarks::build(); // heuristics for all robots' plans
+#ifdef ASTAR_TRACE
+  char buffer[128];
+  sprintf(buffer, "%d A* landmarks, %u KB each", Landmarks::getCount(), (unsigned int)(Landmarks::getBytesPerLandmark() / 1024));
+  controlPanel->addMessage(buffer);
+#endif
+  plannerService.start(PLANNER_THREADS);
+  decisionPool.start(ROBOT_THREADS);
   aicore::DecisionTrees::init();
 }
 
@@ -848,44 +1008,25 @@ const Player*		RobotPlayer::getTarget() const
 
 bool				RobotPlayer::checkPursuit()
 {
-	TeamColor myTeamColor = getTeam();
-	if (!World::getWorld()->allowTeamFlags()) return false;
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
-		if (flagTeamColor == myTeamColor) {
-			for (int j = 0; j < World::getWorld()->getCurMaxPlayers(); j++) {
-				Player* p = World::getWorld()->getPlayer(j);
-				if (p) {
-					if (p->getId() == flag.owner && p->getId() != getId() && flag.status == FlagOnTank) {
-
-						return true;
-					}
-				}
-			}
-		}
-	}
-	return false;
+	const WorldView& view = WorldView::get();
+	int flag = view.findTeamFlag(getTeam());
+	if (flag < 0 || view.flagStatus[flag] != FlagOnTank || view.flagOwner[flag] == getId()) return false;
+	int owner = view.findPlayer(view.flagOwner[flag]);
+	return owner >= 0 && owner < view.worldPlayerCount;
 }
 
 bool				RobotPlayer::checkReturnFlag()
 {
-	TeamColor myTeamColor = getTeam();
-	if (!World::getWorld()->allowTeamFlags()) return false;
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
-		if (flagTeamColor == myTeamColor) {
-			const float* myBase = World::getWorld()->getBase(getTeam(), 0);
-			const float* flagPos = flag.position;
-			float tankRadius = (BZDBCache::tankRadius * 2);
-			if (flag.status == FlagOnGround && (abs(myBase[0] - flagPos[0]) > tankRadius) || (abs(myBase[1] - flagPos[1]) > tankRadius)) {
-				//char buffer[128];
-				//sprintf(buffer, "Robot(%d) Returning flag", getId());
-				//controlPanel->addMessage(buffer);
-				return true;
-			}
-		}
+	const WorldView& view = WorldView::get();
+	int flag = view.findTeamFlag(getTeam());
+	if (flag < 0) return false;
+	const float* myBase = World::getWorld()->getBase(getTeam(), 0);
+	float tankRadius = (BZDBCache::tankRadius * 2);
+	if (view.flagStatus[flag] == FlagOnGround && (abs(myBase[0] - view.flagX[flag]) > tankRadius) || (abs(myBase[1] - view.flagY[flag]) > tankRadius)) {
+		//char buffer[128];
+		//sprintf(buffer, "Robot(%d) Returning flag", getId());
+		//controlPanel->addMessage(buffer);
+		return true;
 	}
 	return false;
 }
@@ -899,58 +1040,40 @@ bool			RobotPlayer::inCorrectBaseSpot() {
 
 bool				RobotPlayer::checkHoldingOwnFlag()
 {
-	TeamColor myTeamColor = getTeam();
-	if (!World::getWorld()->allowTeamFlags()) return false;
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
-		if (flagTeamColor == myTeamColor) {
-			if (flag.owner == getId() && flag.status == FlagOnTank) {
-				//char buffer[128];
-				//sprintf(buffer, "Robot(%d) Going to own base", getId());
-				//controlPanel->addMessage(buffer);
-				return true;
-			}
-		}
+	const WorldView& view = WorldView::get();
+	int flag = view.findTeamFlag(getTeam());
+	if (flag >= 0 && view.flagOwner[flag] == getId() && view.flagStatus[flag] == FlagOnTank) {
+		//char buffer[128];
+		//sprintf(buffer, "Robot(%d) Going to own base", getId());
+		//controlPanel->addMessage(buffer);
+		return true;
 	}
 	return false;
 }
 
 bool				RobotPlayer::checkToBase()
 {
-	TeamColor myTeamColor = getTeam();
-	if (!World::getWorld()->allowTeamFlags()) return false;
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
-
-		if (flagTeamColor == myTeamColor) {
-			for (int j = 0; j < World::getWorld()->getCurMaxPlayers(); j++) {
-				Player* p = World::getWorld()->getPlayer(j);
-				if (p) {
-					if (p->getId() == flag.owner && p->getId() != getId() && flag.status == FlagOnTank) {
-						float* flagpos = flag.position;
-						const float* mypos = getPosition();
-						const float* basepos = World::getWorld()->getBase(p->getTeam(), 0);
-						if (pow((mypos[0] - basepos[0]), 2) + pow((mypos[1] - basepos[1]), 2) > pow((flagpos[0] - basepos[0]), 2) + pow((flagpos[1] - basepos[1]), 2)) {
-							char buffer[128];
-							sprintf(buffer, "%s cuttin off base rought", getCallSign());
-							controlPanel->addMessage(buffer);
-							return true;
-						}
-
-					}
-				}
-			}
-		}
+	const WorldView& view = WorldView::get();
+	int flag = view.findTeamFlag(getTeam());
+	if (flag < 0 || view.flagStatus[flag] != FlagOnTank || view.flagOwner[flag] == getId()) return false;
+	int owner = view.findPlayer(view.flagOwner[flag]);
+	if (owner < 0 || owner >= view.worldPlayerCount) return false;
+	const float flagpos[2] = {view.flagX[flag], view.flagY[flag]};
+	const float* mypos = getPosition();
+	const float* basepos = World::getWorld()->getBase(view.playerTeam[owner], 0);
+	if (pow((mypos[0] - basepos[0]), 2) + pow((mypos[1] - basepos[1]), 2) > pow((flagpos[0] - basepos[0]), 2) + pow((flagpos[1] - basepos[1]), 2)) {
+		char buffer[128];
+		sprintf(buffer, "%s cuttin off base rought", getCallSign());
+		controlPanel->addMessage(buffer);
+		return true;
 	}
 	return false;
 }
 
 bool			RobotPlayer::flagIsStolen() {
-	for (int i = 0; i < World::getWorld()->getCurMaxPlayers(); i++) {
-		Player* p = World::getWorld()->getPlayer(i);
-		if (p != NULL && p->getTeam() != getTeam() && p->getFlag() != NULL && p->getFlag() != Flags::Null && p->getFlag()->flagTeam == getTeam()) {
+	const WorldView& view = WorldView::get();
+	for (int i = 0; i < view.worldPlayerCount; i++) {
+		if (view.playerTeam[i] != getTeam() && view.playerFlag[i] != Flags::Null && view.playerFlagTeam[i] == getTeam()) {
 			return true;
 		}
 	}
@@ -958,35 +1081,28 @@ bool			RobotPlayer::flagIsStolen() {
 }
 
 bool		RobotPlayer::oneOfTwoClosestToOwnFlag() {
-	TeamColor myTeamColor = getTeam();
-	if (!World::getWorld()->allowTeamFlags()) return false;
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
-		if (flagTeamColor == myTeamColor) {
-			const float* flagPos = flag.position;
-			float bestDistance = std::numeric_limits<float>::infinity();
-			float secondBestDistance = std::numeric_limits<float>::infinity();
-			for (int i2 = 0; i2 < World::getWorld()->getCurMaxPlayers(); i2++) {
-				Player* p = World::getWorld()->getPlayer(i2);
-				if (p != NULL && p->getTeam() == getTeam() &&
-					!(p->getFlag() != NULL && p->getFlag() != Flags::Null && p->getFlag()->flagTeam != NoTeam && p->getFlag()->flagTeam != getTeam())) { //does not consider enemy team flag carriers
-					float playerDistance = hypotf(flagPos[0] - p->getPosition()[0], flagPos[1] - p->getPosition()[1]);
-					if (bestDistance > playerDistance) {
-						secondBestDistance = bestDistance;
-						bestDistance = playerDistance;
-					} else if (secondBestDistance > playerDistance) {
-						secondBestDistance = playerDistance;
-					}
-				}
+	const WorldView& view = WorldView::get();
+	int flag = view.findTeamFlag(getTeam());
+	if (flag < 0) return false;
+	const float flagPos[2] = {view.flagX[flag], view.flagY[flag]};
+	float bestDistance = std::numeric_limits<float>::infinity();
+	float secondBestDistance = std::numeric_limits<float>::infinity();
+	for (int i = 0; i < view.worldPlayerCount; i++) {
+		if (view.playerTeam[i] == getTeam() &&
+			!(view.playerFlagTeam[i] != NoTeam && view.playerFlagTeam[i] != getTeam())) { //does not consider enemy team flag carriers
+			float playerDistance = hypotf(flagPos[0] - view.playerX[i], flagPos[1] - view.playerY[i]);
+			if (bestDistance > playerDistance) {
+				secondBestDistance = bestDistance;
+				bestDistance = playerDistance;
+			} else if (secondBestDistance > playerDistance) {
+				secondBestDistance = playerDistance;
 			}
-
-			float ownDistance = hypotf(flagPos[0] - getPosition()[0], flagPos[1] - getPosition()[1]);
-
-			return ownDistance <= bestDistance || ownDistance <= secondBestDistance;
 		}
 	}
-	return false;
+
+	float ownDistance = hypotf(flagPos[0] - getPosition()[0], flagPos[1] - getPosition()[1]);
+
+	return ownDistance <= bestDistance || ownDistance <= secondBestDistance;
 }
 
 void		RobotPlayer::findWallNextToBase(float* goal) {
@@ -1013,22 +1129,20 @@ Intercepters must be closer to the enemy's base than the enemy is.
 The best candidate is the one closest to the enemy.
 */
 bool			RobotPlayer::isBestInterceptCandidate() {
-	if (!World::getWorld()->allowTeamFlags()) return false;
-	for (int i = 0; i < World::getWorld()->getCurMaxPlayers(); i++) {
-		Player* p = World::getWorld()->getPlayer(i);
-		if (p != NULL && p->getTeam() != getTeam() && p->getFlag() != NULL && p->getFlag() != Flags::Null && p->getFlag()->flagTeam == getTeam()) {
-			const float* basepos = World::getWorld()->getBase(p->getTeam(), 0);
-			const float* flagpos = p->getPosition();
+	const WorldView& view = WorldView::get();
+	if (!view.teamFlags) return false;
+	for (int i = 0; i < view.worldPlayerCount; i++) {
+		if (view.playerTeam[i] != getTeam() && view.playerFlag[i] != Flags::Null && view.playerFlagTeam[i] == getTeam()) {
+			const float* basepos = World::getWorld()->getBase(view.playerTeam[i], 0);
+			const float flagpos[2] = {view.playerX[i], view.playerY[i]};
 			float enemyDistanceToBase = hypotf(basepos[0] - flagpos[0], basepos[1] - flagpos[1]);
 			float shortestDistance = std::numeric_limits<float>::infinity();
 
-			for (int i2 = 0; i2 < World::getWorld()->getCurMaxPlayers(); i2++) {
-				Player* p2 = World::getWorld()->getPlayer(i2);
-				if (p2 != NULL && p2->getTeam() == getTeam() && p2->getFlag() != NULL && 
-					!(p2->getFlag() != Flags::Null && p2->getFlag()->flagTeam != NoTeam)) { //does not include flag carriers
-					float pDistanceToBase = hypotf(basepos[0] - p2->getPosition()[0], basepos[1] - p2->getPosition()[1]);
+			for (int i2 = 0; i2 < view.worldPlayerCount; i2++) {
+				if (view.playerTeam[i2] == getTeam() && view.playerFlagTeam[i2] == NoTeam) { //does not include flag carriers
+					float pDistanceToBase = hypotf(basepos[0] - view.playerX[i2], basepos[1] - view.playerY[i2]);
 					if (pDistanceToBase < enemyDistanceToBase) {
-						float pDistanceToEnemy = hypotf(flagpos[0] - p2->getPosition()[0], flagpos[1] - p2->getPosition()[1]);
+						float pDistanceToEnemy = hypotf(flagpos[0] - view.playerX[i2], flagpos[1] - view.playerY[i2]);
 						if (pDistanceToEnemy < shortestDistance) {
 							shortestDistance = pDistanceToEnemy;
 						}
@@ -1051,6 +1165,7 @@ bool			RobotPlayer::isBestInterceptCandidate() {
 }
 
 void			RobotPlayer::determineStatusAndGoal(float* goalPos) {
+	const WorldView& view = WorldView::get();
 	if (getFlag() != NULL && getFlag() != Flags::Null && getFlag()->flagTeam != NoTeam) { //if carrying team flag return
 		currentStatus = RETURN;
 		/*if (getFlag()->flagTeam == getTeam()) {
@@ -1065,23 +1180,21 @@ void			RobotPlayer::determineStatusAndGoal(float* goalPos) {
 		currentStatus = PATROL;
 		const float* basepos = World::getWorld()->getBase(getTeam(), 0);
 		float shortestDistance = std::numeric_limits<float>::infinity();
-		Player* closestPlayer = NULL;
-		for (int i2 = 0; i2 < World::getWorld()->getCurMaxPlayers(); i2++) {
-			Player* p2 = World::getWorld()->getPlayer(i2);
-			
-			if (p2 != NULL && p2->getTeam() != getTeam()) { 
-				float pDistanceToBase = hypotf(basepos[0] - p2->getPosition()[0], basepos[1] - p2->getPosition()[1]);
+		int closestPlayer = -1;
+		for (int i2 = 0; i2 < view.worldPlayerCount; i2++) {
+			if (view.playerTeam[i2] != getTeam()) { 
+				float pDistanceToBase = hypotf(basepos[0] - view.playerX[i2], basepos[1] - view.playerY[i2]);
 				if (pDistanceToBase < (BZDBCache::worldSize / 3.0f) && pDistanceToBase < shortestDistance) {
-					closestPlayer = p2;
+					closestPlayer = i2;
 					shortestDistance = pDistanceToBase;
 				}
 			}
 		}
 
-		if (closestPlayer != NULL) {
-			goalPos[0] = closestPlayer->getPosition()[0];
-			goalPos[1] = closestPlayer->getPosition()[1];
-			goalPos[2] = closestPlayer->getPosition()[2];
+		if (closestPlayer >= 0) {
+			goalPos[0] = view.playerX[closestPlayer];
+			goalPos[1] = view.playerY[closestPlayer];
+			goalPos[2] = view.playerZ[closestPlayer];
 			char buffer5[128];
 			sprintf(buffer5, "%s targeting player", getCallSign());
 			controlPanel->addMessage(buffer5);
@@ -1093,41 +1206,20 @@ void			RobotPlayer::determineStatusAndGoal(float* goalPos) {
 		return;
 	} 
 	if (!flagIsInBase()) { //if flag is not in base, pursue
-		if (flagIsStolen()) {
-			if (isClosestToOwnFlag() || isBestInterceptCandidate()) {
-				for (int i = 0; i < numFlags; i++) {
-					Flag& flag = World::getWorld()->getFlag(i);
-					TeamColor flagTeamColor = flag.type->flagTeam;
-					if (flagTeamColor == getTeam()) {
-						currentStatus = PURSUIT;
-						goalPos[0] = flag.position[0];
-						goalPos[1] = flag.position[1];
-						goalPos[2] = flag.position[2];
-						return;
-					}
-				}
-			} 
-		} else if(oneOfTwoClosestToOwnFlag()){
-			for (int i = 0; i < numFlags; i++) {
-				Flag& flag = World::getWorld()->getFlag(i);
-				TeamColor flagTeamColor = flag.type->flagTeam;
-				if (flagTeamColor == getTeam()) {
-					currentStatus = PURSUIT;
-					goalPos[0] = flag.position[0];
-					goalPos[1] = flag.position[1];
-					goalPos[2] = flag.position[2];
-					return;
-				}
-			}
+		int flag = view.findTeamFlag(getTeam());
+		if (flag >= 0 && (flagIsStolen() ? isClosestToOwnFlag() || isBestInterceptCandidate() : oneOfTwoClosestToOwnFlag())) {
+			currentStatus = PURSUIT;
+			goalPos[0] = view.flagX[flag];
+			goalPos[1] = view.flagY[flag];
+			goalPos[2] = view.flagZ[flag];
+			return;
 		}
 	}
 
 	findOpponentFlag(goalPos);
 	currentStatus = OFFENSE;
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
-		if (flagTeamColor != getTeam() && flag.position[0] == goalPos[0] && flag.position[1] == goalPos[1] && flag.status == FlagOnTank) {
+	for (int i = 0; i < view.flagCount; i++) {
+		if (view.flagTeam[i] != getTeam() && view.flagX[i] == goalPos[0] && view.flagY[i] == goalPos[1] && view.flagStatus[i] == FlagOnTank) {
 			currentStatus = OFFENSIVE_PURSUIT;
 			return;
 		}
@@ -1135,53 +1227,68 @@ void			RobotPlayer::determineStatusAndGoal(float* goalPos) {
 }
 
 bool		RobotPlayer::flagIsInBase() {
-	TeamColor myTeamColor = getTeam();
-	if (!World::getWorld()->allowTeamFlags()) return false;
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
-		if (flagTeamColor == myTeamColor) {
-			const float* myBase = World::getWorld()->getBase(getTeam(), 0);
-			const float* flagPos = flag.position;
-			float tankRadius = (BZDBCache::tankRadius * 2);
-
-			if (!(flag.status == FlagOnTank && World::getWorld()->getPlayer(flag.owner)->getTeam() != getTeam()) && hypotf(myBase[0] - flagPos[0], myBase[1] - flagPos[1]) < tankRadius * 2) {
-				//char buffer[128];
-				//sprintf(buffer, "Robot(%d) Returning flag", getId());
-				//controlPanel->addMessage(buffer);
-				return true;
-			}
-		}
+	const WorldView& view = WorldView::get();
+	int flag = view.findTeamFlag(getTeam());
+	if (flag < 0) return false;
+	const float* myBase = World::getWorld()->getBase(getTeam(), 0);
+	float tankRadius = (BZDBCache::tankRadius * 2);
+	int owner = view.findPlayer(view.flagOwner[flag]);
+	bool stolen = view.flagStatus[flag] == FlagOnTank && owner >= 0 && view.playerTeam[owner] != getTeam();
+	if (!stolen && hypotf(myBase[0] - view.flagX[flag], myBase[1] - view.flagY[flag]) < tankRadius * 2) {
+		//char buffer[128];
+		//sprintf(buffer, "Robot(%d) Returning flag", getId());
+		//controlPanel->addMessage(buffer);
+		return true;
 	}
 	return false;
 }
 
 bool			RobotPlayer::isClosestToOwnFlag() {
-	TeamColor myTeamColor = getTeam();
-	if (!World::getWorld()->allowTeamFlags()) return false;
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
-		if (flagTeamColor == myTeamColor) {
-			const float* flagPos = flag.position;
-			float bestDistance = std::numeric_limits<float>::infinity();
-			for (int i2 = 0; i2 < World::getWorld()->getCurMaxPlayers(); i2++) {
-				Player* p = World::getWorld()->getPlayer(i2);
-				if (p != NULL && p->getTeam() == getTeam() && 
-					!(p->getFlag() != NULL && p->getFlag() != Flags::Null && p->getFlag()->flagTeam != NoTeam)) { //does not consider team flag carriers
-					float playerDistance = hypotf(flagPos[0] - p->getPosition()[0], flagPos[1] - p->getPosition()[1]);
-					if (bestDistance > playerDistance) {
-						bestDistance = playerDistance;
-					}
-				}
+	const WorldView& view = WorldView::get();
+	int flag = view.findTeamFlag(getTeam());
+	if (flag < 0) return false;
+	const float flagPos[2] = {view.flagX[flag], view.flagY[flag]};
+	float bestDistance = std::numeric_limits<float>::infinity();
+	for (int i = 0; i < view.worldPlayerCount; i++) {
+		if (view.playerTeam[i] == getTeam() && view.playerFlagTeam[i] == NoTeam) { //does not consider team flag carriers
+			float playerDistance = hypotf(flagPos[0] - view.playerX[i], flagPos[1] - view.playerY[i]);
+			if (bestDistance > playerDistance) {
+				bestDistance = playerDistance;
 			}
-
-			if (hypotf(flagPos[0] - getPosition()[0], flagPos[1] - getPosition()[1]) <= bestDistance) {
-				return true;
-			}			
 		}
 	}
-	return false;
+
+	return hypotf(flagPos[0] - getPosition()[0], flagPos[1] - getPosition()[1]) <= bestDistance;
+}
+
+/*
+ * switch to the paths planned for setTarget on a planner thread
+ */
+void			RobotPlayer::takeTargetPaths(std::vector< std::vector< AStarNode > >& result, const AStarNode& goalNode)
+{
+  planningTarget = false;
+  paths.swap(result);
+  if (!paths.empty()) {
+	  pathGoalNode.setX(paths[0][0].getX());
+	  pathGoalNode.setY(paths[0][0].getY());
+	  // the plan started from where the tank was when it was submitted, so continue from the part
+	  // of the path closest to where the tank is now
+	  float position[3] = { getPosition()[0], getPosition()[1], getPosition()[2] };
+	  pathIndex = std::max(0, findClosestPartOfPath(position) - 1);
+  }
+  else {
+	  pathIndex = -1;
+	  char buffer[512];
+	  sprintf (buffer, "***RobotPlayer::takeTargetPaths: %s could not find a path to (%f, %f)***",
+		  getCallSign(), goalNode.getScaledX(), goalNode.getScaledY());
+	  controlPanel->addMessage(buffer);
+  }
+#ifdef PATH_CACHE_TRACE
+  char cacheBuffer[128];
+  sprintf(cacheBuffer, "path cache: %d hits (%d on a subpath), %d misses",
+	  pathCache.getHitCount(), pathCache.getSubpathHitCount(), pathCache.getMissCount());
+  controlPanel->addMessage(cacheBuffer);
+#endif
 }
 
 void			RobotPlayer::setTarget(const Player* _target)
@@ -1195,7 +1302,11 @@ void			RobotPlayer::setTarget(const Player* _target)
   TeamColor myteam = getTeam();
   float goalPos[3];
 
-  determineStatusAndGoal(goalPos);
+  {
+    AI_PROFILE_SCOPE(AIProfile::PERCEPTION);
+    determineStatusAndGoal(goalPos);
+  }
+  AI_PROFILE_SCOPE(AIProfile::PLANNING);
 #ifdef STATUS_TRACE
   char buffer5[128];
   sprintf(buffer5, "%s status: %i", getCallSign(), currentStatus);
@@ -1205,15 +1316,45 @@ void			RobotPlayer::setTarget(const Player* _target)
   AStarNode goalNode(goalPos);
   if (!paths.empty() && goalNode == pathGoalNode)
 	  return; // same goal so no need to plan again
+  if (slicedPlanner.isPlanning() && goalNode == slicedPlanner.getGoal())
+	  return; // still planning for this goal over the next frames
+  if (planningTarget && goalNode == pendingGoalNode && plannerService.isPending(this))
+	  return; // still planning for this goal on a planner thread
   
+  slicedPlanner.cancel(); // its goal is out of date
+  // teammates going for the same flag follow one shared flow field towards it
+  int flowGoal = currentStatus == OFFENSE ? findFlagAt(goalNode) : -1;
+  if (plannerService.getThreadCount() > 0) {
+	  // plan on a planner thread, takeTargetPaths gets the paths at the start of a later updateRobots
+	  // (this replaces a plan of this robot that is still on the way)
+	  GraphFunctionContainer fun_cont(BZDBCache::worldSize, currentStatus, LocalPlayer::getMyTank());
+	  AStarNode startNode(getPosition());
+	  int status = currentStatus;
+	  planningTarget = true;
+	  pendingGoalNode = goalNode;
+	  plannerService.submit(this, currentStatus == RETURN ? PLAN_PRIORITY_RETURN : PLAN_PRIORITY_TARGET,
+		  [this, fun_cont, status, startNode, goalNode, flowGoal](PlannerService::Paths& result) mutable {
+			  planPaths(fun_cont, status, startNode, goalNode, result, false, flowGoal);
+		  },
+		  [this, goalNode](PlannerService::Paths& result) {
+			  takeTargetPaths(result, goalNode);
+		  });
+	  return;
+  }
   clock_t start_s = clock();
-  aStarSearch(getPosition(), goalPos, paths);
+  aStarSearch(getPosition(), goalPos, paths, true, flowGoal);
   clock_t stop_s = clock();
   float sum = (float)(stop_s - start_s) / CLOCKS_PER_SEC;
 #ifdef ASTAR_TRACE
   char buffer[512];
   sprintf(buffer, "\nA* search took %f seconds", sum);
   controlPanel->addMessage(buffer);
+#endif
+#ifdef PATH_CACHE_TRACE
+  char cacheBuffer[128];
+  sprintf(cacheBuffer, "path cache: %d hits (%d on a subpath), %d misses",
+	  pathCache.getHitCount(), pathCache.getSubpathHitCount(), pathCache.getMissCount());
+  controlPanel->addMessage(cacheBuffer);
 #endif
   if (!paths.empty()) {
 	  pathGoalNode.setX(paths[0][0].getX());
@@ -1221,7 +1362,7 @@ void			RobotPlayer::setTarget(const Player* _target)
 	  pathIndex = paths[0].size()-2; // last index is start node
   }
   else {
-	  pathIndex = -1;
+	  pathIndex = -1; // or until a sliced plan finds a path
   }
 #ifdef TRACE2
   sprintf (buffer, "\nNumber of paths: %d\nPath coordinates: \n[ ", paths.size());
@@ -1377,29 +1518,24 @@ int		RobotPlayer::computeCenterOfMass(float neighborhoodSize, float cm[3])
 	sprintf (buffer, "curMaxPlayers() is  %d", World::getWorld()->getCurMaxPlayers());
 	controlPanel->addMessage(buffer);
 #endif
-	for (int i=0; i <= World::getWorld()->getCurMaxPlayers(); i++)
+	const WorldView& view = WorldView::get();
+	for (int i=0; i < view.playerCount; i++)
 	{
-		Player* p = NULL;
-		const float* pos; // p's position
+		const float pos[3] = {view.playerX[i], view.playerY[i], view.playerZ[i]}; // the player's position
 		double distance = 0; // distance from p to this robot
-		if (i < World::getWorld()->getCurMaxPlayers())
-			p = World::getWorld()->getPlayer(i);
-		else
-			p = LocalPlayer::getMyTank();
 
 #ifdef TRACE
-		if(p) sprintf (buffer, "getPlayer(%d), id=%d has team color %d",
-			i, p->getId(), p->getTeam());
+		sprintf (buffer, "player %d, id=%d has team color %d",
+			i, view.playerId[i], view.playerTeam[i]);
 		controlPanel->addMessage(buffer);
 #endif
-		if (p && p->getTeam() == myTeam && p->getId() != getId()) {
-			pos = p->getPosition();
+		if (view.playerTeam[i] == myTeam && view.playerId[i] != getId()) {
 			double deltax = pos[0] - mypos[0];
 			double deltay = pos[1] - mypos[1];
 			distance = hypotf(deltax,deltay);
 #ifdef TRACE
-			sprintf (buffer, "getPlayer(%d), id=%d has location (%f, %f, %f)",
-				i, p->getId(), pos[0], pos[1], pos[2]);
+			sprintf (buffer, "player %d, id=%d has location (%f, %f, %f)",
+				i, view.playerId[i], pos[0], pos[1], pos[2]);
 			controlPanel->addMessage(buffer);
 			sprintf (buffer, "distance = %f, neighborhood = %f",
 				distance, neighborhoodSize);
@@ -1444,24 +1580,19 @@ int		RobotPlayer::computeRepulsion(float neighborhoodSize, float repulse[3])
 	sprintf (buffer, "curMaxPlayers() is  %d", World::getWorld()->getCurMaxPlayers());
 	controlPanel->addMessage(buffer);
 #endif
-	for (int i=0; i <= World::getWorld()->getCurMaxPlayers(); i++)
+	const WorldView& view = WorldView::get();
+	for (int i=0; i < view.playerCount; i++)
 	{
-		Player* p = NULL;
-		const float* pos; // p's position
+		const float pos[3] = {view.playerX[i], view.playerY[i], view.playerZ[i]}; // the player's position
 		float direction[3]; // flee direction
 		float distance = 0; // distance from p to this robot
-		if (i < World::getWorld()->getCurMaxPlayers())
-			p = World::getWorld()->getPlayer(i);
-		else
-			p = LocalPlayer::getMyTank();
 
 #ifdef TRACE
-		if(p) sprintf (buffer, "getPlayer(%d), id=%d has team color %d",
-			i, p->getId(), p->getTeam());
+		sprintf (buffer, "player %d, id=%d has team color %d",
+			i, view.playerId[i], view.playerTeam[i]);
 		controlPanel->addMessage(buffer);
 #endif
-		if (p && p->getTeam() == myTeam && p->getId() != getId()) {
-			pos = p->getPosition();
+		if (view.playerTeam[i] == myTeam && view.playerId[i] != getId()) {
 			direction[0] = mypos[0] - pos[0];
 			direction[1] = mypos[1] - pos[1];
 			distance = hypotf(direction[0],direction[1]);
@@ -1471,8 +1602,8 @@ int		RobotPlayer::computeRepulsion(float neighborhoodSize, float repulse[3])
 				direction[1] = bzfrand();
 			}
 #ifdef TRACE
-			sprintf (buffer, "getPlayer(%d), id=%d has location (%f, %f, %f)",
-				i, p->getId(), pos[0], pos[1], pos[2]);
+			sprintf (buffer, "player %d, id=%d has location (%f, %f, %f)",
+				i, view.playerId[i], pos[0], pos[1], pos[2]);
 			controlPanel->addMessage(buffer);
 			sprintf (buffer, "distance = %f, neighborhood = %f",
 				distance, neighborhoodSize);
@@ -1516,32 +1647,26 @@ int		RobotPlayer::computeAlign(float neighborhoodSize,
 	sprintf (buffer, "curMaxPlayers() is  %d", World::getWorld()->getCurMaxPlayers());
 	controlPanel->addMessage(buffer);
 #endif
-	for (int i=0; i <= World::getWorld()->getCurMaxPlayers(); i++)
+	const WorldView& view = WorldView::get();
+	for (int i=0; i < view.playerCount; i++)
 	{
-		Player* p = NULL;
-		const float* pos; // position of p
-		const float* v; // velocity of v
+		const float pos[3] = {view.playerX[i], view.playerY[i], view.playerZ[i]}; // position of the player
+		const float v[3] = {view.playerVX[i], view.playerVY[i], view.playerVZ[i]}; // velocity of the player
 		//const float* azimuth; // angle of v
 		double distance = 0; // distance from p to this robot
-		if (i < World::getWorld()->getCurMaxPlayers())
-			p = World::getWorld()->getPlayer(i);
-		else
-			p = LocalPlayer::getMyTank();
 
 #ifdef TRACE
-		if(p) sprintf (buffer, "getPlayer(%d), id=%d has team color %d",
-			i, p->getId(), p->getTeam());
+		sprintf (buffer, "player %d, id=%d has team color %d",
+			i, view.playerId[i], view.playerTeam[i]);
 		controlPanel->addMessage(buffer);
 #endif
-		if (p && p->getTeam() == myTeam && p->getId() != getId()) {
-			pos = p->getPosition();
+		if (view.playerTeam[i] == myTeam && view.playerId[i] != getId()) {
 			double deltax = pos[0] - mypos[0];
 			double deltay = pos[1] - mypos[1];
 			distance = hypotf(deltax,deltay);
-			v = p->getVelocity();
 #ifdef TRACE
-			sprintf (buffer, "getPlayer(%d), id=%d has velocity (%f, %f, %f)",
-				i, p->getId(), v[0], v[1], v[2]);
+			sprintf (buffer, "player %d, id=%d has velocity (%f, %f, %f)",
+				i, view.playerId[i], v[0], v[1], v[2]);
 			controlPanel->addMessage(buffer);
 			sprintf (buffer, "distance = %f, neighborhood = %f",
 				distance, neighborhoodSize);
@@ -1552,7 +1677,7 @@ int		RobotPlayer::computeAlign(float neighborhoodSize,
 				avV[0] += v[0];
 				avV[1] += v[1];
 				avV[2] += v[2];
-				*avAzimuth += p->getAngle();
+				*avAzimuth += view.playerAngle[i];
 			}
 		}
 	}
@@ -1622,24 +1747,24 @@ float* RobotPlayer::findPatrolPoint(float patrolArea[3]) {
 bool		RobotPlayer::myTeamHoldingOpponentFlag(void)
 {
 	TeamColor myTeamColor = getTeam();
-	if (!World::getWorld()->allowTeamFlags()) return false;
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
+	const WorldView& view = WorldView::get();
+	if (!view.teamFlags) return false;
+	for (int i = 0; i < view.flagCount; i++) {
+		TeamColor flagTeamColor = view.flagTeam[i];
 		if (flagTeamColor != NoTeam && flagTeamColor != myTeamColor
-			&& flag.status == FlagOnTank) {
-			PlayerId ownerId = flag.owner;
+			&& view.flagStatus[i] == FlagOnTank) {
+			PlayerId ownerId = view.flagOwner[i];
 #ifdef TRACE2
 			char buffer[512];
 			sprintf (buffer, "Looking for a Player with id=%d",
 				ownerId);
 			controlPanel->addMessage(buffer);
 #endif
-			Player* p = lookupLocalPlayer(ownerId);
-			if (p && (p->getTeam() == myTeamColor)) {
+			int owner = view.findPlayer(ownerId);
+			if (owner >= 0 && (view.playerTeam[owner] == myTeamColor)) {
 #ifdef TRACE2
 				sprintf (buffer, "Player id=%d, TeamColor=%d holds flag %d, robots[0]=%d",
-					p->getId(), p->getTeam(), myTeamColor, robots[0]->getId());
+					ownerId, view.playerTeam[owner], myTeamColor, robots[0]->getId());
 				controlPanel->addMessage(buffer);
 #endif
 				return true;
@@ -1659,10 +1784,25 @@ bool		RobotPlayer::myTeamHoldingOpponentFlag(void)
  * Find any opponent flag and return its location
  */
 
+/*
+ * index of the team flag at node, -1 if there is none
+ */
+int		RobotPlayer::findFlagAt(const AStarNode& node)
+{
+	const WorldView& view = WorldView::get();
+	for (int i = 0; i < view.flagCount; i++) {
+		const float position[3] = {view.flagX[i], view.flagY[i], view.flagZ[i]};
+		if (view.flagTeam[i] != NoTeam && AStarNode(position) == node)
+			return i;
+	}
+	return -1;
+}
+
 void		RobotPlayer::findOpponentFlag(float location[3])
 {
 	TeamColor myTeamColor = getTeam();
-	if (!World::getWorld()->allowTeamFlags()) return;
+	const WorldView& view = WorldView::get();
+	if (!view.teamFlags) return;
 
 	const float* mypos = getPosition();
 	const float* basepos = World::getWorld()->getBase(getTeam(), 0);
@@ -1671,26 +1811,25 @@ void		RobotPlayer::findOpponentFlag(float location[3])
 
 	float flag1[3], flag2[3],flag3[3];
 	//find all enemy flags
-	for (int i = 0; i < numFlags; i++) {
-		Flag& flag = World::getWorld()->getFlag(i);
-		TeamColor flagTeamColor = flag.type->flagTeam;
+	for (int i = 0; i < view.flagCount; i++) {
+		TeamColor flagTeamColor = view.flagTeam[i];
 		if (flagTeamColor != NoTeam && flagTeamColor != myTeamColor) {
 			if (count == 0) {
-				flag1[0] = flag.position[0];
-				flag1[1] = flag.position[1];
-				flag1[2] = flag.position[2];
+				flag1[0] = view.flagX[i];
+				flag1[1] = view.flagY[i];
+				flag1[2] = view.flagZ[i];
 				count++;
 			}
 			else if (count == 1) {
-				flag2[0] = flag.position[0];
-				flag2[1] = flag.position[1];
-				flag2[2] = flag.position[2];
+				flag2[0] = view.flagX[i];
+				flag2[1] = view.flagY[i];
+				flag2[2] = view.flagZ[i];
 				count++;
 			}
 			else if (count == 2) {
-				flag3[0] = flag.position[0];
-				flag3[1] = flag.position[1];
-				flag3[2] = flag.position[2];
+				flag3[0] = view.flagX[i];
+				flag3[1] = view.flagY[i];
+				flag3[2] = view.flagZ[i];
 				break;
 			}
 			
@@ -1784,16 +1923,9 @@ void		RobotPlayer::findOpponentFlag(float location[3])
  */
 Player*		RobotPlayer::lookupLocalPlayer(PlayerId id)
 {
-	for (int i=0; i <= World::getWorld()->getCurMaxPlayers(); i++)
-	{
-		Player* p = NULL;
-		if (i < World::getWorld()->getCurMaxPlayers())
-			p = World::getWorld()->getPlayer(i);
-		else
-			p = LocalPlayer::getMyTank();
-		if (p && p->getId() == id) return p;
-	}
-	return NULL;
+	const WorldView& view = WorldView::get();
+	int i = view.findPlayer(id);
+	return i >= 0 ? view.player[i] : NULL;
 }
 
 /*
@@ -1802,42 +1934,27 @@ Player*		RobotPlayer::lookupLocalPlayer(PlayerId id)
  * typically only paths[0] will be non-empty
  * Note that paths[0][0] is the same as the goal node
  * and paths[0][paths.size()-1] is the same as the start node
+ * If sliced, a plan with cost multipliers may be left to slicedPlanner
+ * (see takeSlicedPaths), and paths stay empty until it finds one
+ * flowGoal, if not negative, is the index of the flag at the goal (see planPaths)
  */
 void		RobotPlayer::aStarSearch(const float startPos[3], const float goalPos[3],
-									 std::vector< std::vector< AStarNode > >& paths)
+									 std::vector< std::vector< AStarNode > >& paths, bool sliced, int flowGoal)
 {
-	// Profiling observation: Using int instead of double cost provides marginal improvement (~10%)
-	GenericSearchGraphDescriptor<AStarNode,double> AStarGraph;
 	GraphFunctionContainer fun_cont(BZDBCache::worldSize, currentStatus, LocalPlayer::getMyTank());
-	AStarGraph.func_container = &fun_cont;
-	// Set other variables
-	AStarGraph.hashTableSize = (int)pow((floor(GraphFunctionContainer::Xmin * 2) - 2), 2) + 2; //amount of Nodes in graph plus a bit of wiggle room; 
-	AStarGraph.hashBinSizeIncreaseStep = 1; //hash function guarantees unique values
-	AStarGraph.SeedNode = AStarNode(startPos); // Start node
-	AStarGraph.TargetNode = AStarNode(goalPos); // Goal node
-
-	if (AStarGraph.SeedNode.getX() == AStarGraph.TargetNode.getX() && AStarGraph.SeedNode.getX() == AStarGraph.TargetNode.getY()) {
-		std::vector<AStarNode> singleNodePath;
-		singleNodePath.push_back(AStarNode(startPos));
-		paths.clear();
-		paths.push_back(singleNodePath);
-	}
+	AStarNode startNode(startPos);
+	AStarNode goalNode(goalPos);
 
-	A_star_planner<AStarNode,double> planner;
-	planner.setParams(1.0, 10); // optional.
-	planner.init(&AStarGraph);
-	planner.plan();
-	if (!paths.empty()) paths.clear();
-	paths = planner.getPlannedPaths();
-	if (paths.empty()) {
+	planPaths(fun_cont, currentStatus, startNode, goalNode, paths, sliced, flowGoal);
+	if (paths.empty() && sliced && slicedPlanner.isPlanning()) {
+		// no path yet, the following slices look on
+	}
+	else if (paths.empty()) {
 		char buffer[512];
 		sprintf (buffer, "***RobotPlayer::aStarSearch: %s could not find a path from (%f, %f) to (%f, %f)***",
 			getCallSign(), startPos[0], startPos[1], goalPos[0], goalPos[1]);
 		controlPanel->addMessage(buffer);
 	}
-	else {
-		paths[0] = generateSmoothedPath(paths[0]);
-	}
 #ifdef TRACE_PLANNER
 	  char buffer[512];
 	  sprintf (buffer, "R%d-%d planning from (%f, %f) to (%f, %f) with plan size %d",
@@ -1851,27 +1968,119 @@ void		RobotPlayer::aStarSearch(const float startPos[3], const float goalPos[3],
 #endif
 }
 
+/*
+ * the planning part of aStarSearch, on a graph that has already been set up for status
+ * Only uses this robot's planners and world data that stays the same while a world is loaded,
+ * so it may run on a planner thread (see plannerService)
+ * With a flowGoal (the index of the flag at the goal), the path follows the shared flow field towards it
+ * Otherwise optimal paths with trackable costs are shared with the other robots through pathCache
+ */
+void		RobotPlayer::planPaths(GraphFunctionContainer& fun_cont, int status, AStarNode& startNode, AStarNode& goalNode,
+									 std::vector< std::vector< AStarNode > >& paths, bool sliced, int flowGoal)
+{
+	AI_PROFILE_SCOPE(AIProfile::PLANNING);
+	if (startNode.getX() == goalNode.getX() && startNode.getX() == goalNode.getY()) {
+		std::vector<AStarNode> singleNodePath;
+		singleNodePath.push_back(startNode);
+		paths.clear();
+		paths.push_back(singleNodePath);
+	}
+
+	if (!paths.empty()) paths.clear();
+	std::vector<AStarNode> flowPath, cachedPath;
+	bool cachePath = fun_cont.hasTrackableCosts();
+	if (flowGoal >= 0 && fun_cont.hasTrackableCosts()
+		&& flowFields.get(flowGoal, fun_cont, goalNode)->getPath(startNode, flowPath)) {
+		// built once per flag and cost profile, then each robot only walks the field
+		paths.push_back(flowPath);
+		cachePath = false;
+	}
+	else if (cachePath && pathCache.find(fun_cont, startNode, goalNode, cachedPath)) {
+		// a teammate, or this robot before it respawned, already planned through here to the same goal
+		paths.push_back(cachedPath);
+		cachePath = false;
+	}
+	else if (fun_cont.hasConstantCosts()) {
+		// no cost multipliers: jump point search with uniform integer costs on a radix heap, jumping
+		// by the distances precomputed for the world (plannerbench: 8 to 150 times the plans/sec of
+		// A* on open, city and maze maps), which also beats repairing the last plan when the goal moves.
+		// Long plans do not go through the cluster abstraction (AStarHierarchy) either: its paths cost
+		// up to 1.07 times the optimum (1.05 on city maps, 1.03 on open ones, sizes 400 to 3200) and
+		// take 2 to 100 times as long as jump point search, which finds the optimal ones
+		FixedCostGraphFunctionContainer fixed_cont;
+		paths = jpsPlanner.plan(&fixed_cont, startNode, goalNode, fixed_cont.getStraightCost(), fixed_cont.getDiagonalCost());
+	}
+	else if ((status == PATROL || status == PURSUIT || status == OFFENSIVE_PURSUIT) && fun_cont.hasTrackableCosts()
+		&& OccupancyGrid::isBuilt() && OccupancyGrid::getBlockedFraction() >= D_STAR_LITE_MIN_BLOCKED) {
+		// the goal is a moving player or flag, so repair the last plan instead of planning from scratch.
+		// Not on open worlds, where A* is as fast (see PersistentDStarLitePlanner)
+		paths = incrementalPlanner.plan(&fun_cont, startNode, goalNode);
+	}
+	else if (sliced) {
+		// ARA* over several frames: the first slice usually finds an inflated path already,
+		// doUpdate runs the rest and takes the better paths
+		slicedPlanner.start(fun_cont, startNode, goalNode, A_STAR_SLICE_EXPANSIONS, A_STAR_ANYTIME_EPS);
+		if (slicedPlanner.hasNewPaths())
+			paths = slicedPlanner.takePaths();
+		cachePath = false; // inflated until the last slice
+	}
+	else {
+		paths = planner.plan(&fun_cont, startNode, goalNode, false);
+	}
+	if (!paths.empty()) {
+		if (cachePath)
+			pathCache.add(fun_cont, paths[0]);
+		paths[0] = generateSmoothedPath(paths[0]);
+	}
+}
+
+/*
+ * switch to the paths the sliced planner found since they were last taken
+ */
+void		RobotPlayer::takeSlicedPaths()
+{
+	std::vector< std::vector< AStarNode > > slicedPaths = slicedPlanner.takePaths();
+	if (slicedPaths.empty())
+		return;
+	paths.swap(slicedPaths);
+	paths[0] = generateSmoothedPath(paths[0]);
+	pathGoalNode.setX(paths[0][0].getX());
+	pathGoalNode.setY(paths[0][0].getY());
+	// the tank moved on while planning, so continue from the part of the path closest to it
+	float position[3] = { getPosition()[0], getPosition()[1], getPosition()[2] };
+	pathIndex = std::max(0, findClosestPartOfPath(position) - 1);
+}
+
+/*
+ * Shortens a path (in planner order, goal first) to the nodes where it has to turn.
+ * Greedy, from the start: the last node seen so far stays in view until the path leaves
+ * its line of sight, and then the node before that becomes the next one kept.
+ * Each node of the original path is tested once.
+ */
 std::vector< AStarNode > RobotPlayer::generateSmoothedPath(std::vector< AStarNode > original) {
+	if (original.size() < 3)
+		return original;
 	std::vector< AStarNode > smoothed;
-	std::reverse(original.begin(), original.end());
-	for (int i = 0; i < original.size(); i++) {
-		int until; //final node before the node can be reached in a straight line.
-		until = i + 1;
-		for (int i2 = (i + 1); i2 < original.size(); i2++) {
-			until = i2;
-			if (!pathIsClear(original[i], original[i2])) {
-				break;
-			}
+	int kept = original.size() - 1; // start node
+	smoothed.push_back(original[kept]);
+	for (int i = kept - 2; i >= 0; i--) {
+		if (!pathIsClear(original[kept], original[i])) {
+			kept = i + 1; // last node still in view
+			smoothed.push_back(original[kept]);
 		}
-		smoothed.push_back(original[i]);
-		i = until - 1; //skip to next node in new path. Ignore all nodes in between
 	}
-	//smoothed.push_back(original[original.size() - 1]);
+	smoothed.push_back(original[0]);
 	std::reverse(smoothed.begin(), smoothed.end());
 	return smoothed;
 }
 
+/*
+ * true if a tank can drive straight from start to end
+ * Walks the occupancy grid; before it is built, casts rays along the middle and both sides of the tank
+ */
 bool		RobotPlayer::pathIsClear(AStarNode& start, AStarNode& end) {
+	if (OccupancyGrid::isBuilt())
+		return OccupancyGrid::isLineClear(start.getX(), start.getY(), end.getX(), end.getY());
 	float startCoordinates[3] = { start.getScaledX(), start.getScaledY(), 0 };
 	float endCoordinates[3] = { end.getScaledX(), end.getScaledY(), 0 };
 	float direction[3] = { endCoordinates[0] - startCoordinates[0], endCoordinates[1] - startCoordinates[1], endCoordinates[2] - startCoordinates[2] };
@@ -32,17 +32,33 @@
 
 #include "ControlPanel.h"
 #include "AStarNode.h" // needed for A* search
+#include "OccupancyGrid.h" // needed for rasterising the world
+#include "Landmarks.h" // needed for the heuristic tables
+#include "PlannerService.h" // needed for planning on worker threads
+#include "FlowField.h" // needed for shared flow fields
+#include "PathCache.h" // needed for shared paths
+#include "AIProfile.h" // needed for timing the robots' work
+#include "WorkStealingPool.h" // needed for deciding on several threads
+
+#ifndef ROBOT_THREADS
+#define ROBOT_THREADS 2 // threads that decide for the robots besides the game thread, 0 to decide in the game thread
+#endif
 
 class RobotPlayer : public LocalPlayer {
   public:
+    typedef void (RobotPlayer::*Action)(float dt); // an action of the decision trees
 			RobotPlayer(const PlayerId&,
 				const char* name, ServerLink*,
 				const char* _motto);
+			~RobotPlayer();
 
     float		getTargetPriority(const Player*) const;
     const Player*	getTarget() const;
     void		setTarget(const Player*);
     static void		setObstacleList(std::vector<BzfRegion*>*);
+    static void		deliverPlans();
+    static void		decideAll(float dt);
+    void		decide(float dt);
 
     void		restart(const float* pos, float azimuth);
     void		explodeTank();
@@ -103,9 +119,15 @@ class RobotPlayer : public LocalPlayer {
 	 float* RobotPlayer::findPatrolPoint(float patrolArea[3]);
 	 bool		RobotPlayer::myTeamHoldingOpponentFlag(void);
 	 void		RobotPlayer::findOpponentFlag(float location[3]);
+	 int		RobotPlayer::findFlagAt(const AStarNode& node);
 	 Player*		RobotPlayer::lookupLocalPlayer(PlayerId id);
 	 void		RobotPlayer::aStarSearch(const float startPos[3], const float goalPos[3],
-										 std::vector< std::vector< AStarNode > >& paths);
+										 std::vector< std::vector< AStarNode > >& paths, bool sliced = false, int flowGoal = -1);
+	 void		RobotPlayer::planPaths(GraphFunctionContainer& fun_cont, int status, AStarNode& startNode, AStarNode& goalNode,
+										 std::vector< std::vector< AStarNode > >& paths, bool sliced, int flowGoal = -1);
+	 void		RobotPlayer::takeSlicedPaths();
+	 void		RobotPlayer::takeTargetPaths(std::vector< std::vector< AStarNode > >& result, const AStarNode& goalNode);
+	 void		RobotPlayer::takeDetourPaths(std::vector<AStarNode>& detour, std::vector<AStarNode>& pathReturn, int nextIndex);
 	 std::vector< AStarNode > RobotPlayer::generateSmoothedPath(std::vector< AStarNode > orig);
 	 bool		RobotPlayer::pathIsClear(AStarNode& start, AStarNode& end);
 	 void		RobotPlayer::seekFlag();
@@ -131,13 +153,32 @@ class RobotPlayer : public LocalPlayer {
     float		timerForShot;
     bool		drivingForward;
     static std::vector<BzfRegion*>* obstacleList;
+	static PlannerService plannerService; // plans of all robots, on worker threads
+	static FlowFieldCache flowFields; // fields towards the flags robots go for, shared by all robots
+	static PathCache pathCache; // paths planned by all robots
 	std::vector< std::vector< AStarNode > > paths; // planner result paths
+	PersistentAStarPlanner<double, GraphFunctionContainer> planner; // kept between plans, reset in O(1)
+	PersistentJPSPlanner<int, FixedCostGraphFunctionContainer> jpsPlanner; // jump point search, for plans without cost multipliers
+	PersistentDStarLitePlanner<double, GraphFunctionContainer> incrementalPlanner; // repairs the last plan, for moving goals with cost multipliers
+	SlicedAStarPlanner<double, GraphFunctionContainer> slicedPlanner; // spreads plans with cost multipliers over frames
 	AStarNode pathGoalNode; // goal position for current planner result
 	float shotAngle; // azimuth of incoming shot
 	float targetdistance; // distance to target
 	float targetdir[3]; // direction to target
 	int currentStatus; //number indicating what the tank will do at the moment
 	bool seekingFlag;
+	bool planningTarget; // the request in plannerService is for setTarget, to pendingGoalNode
+	AStarNode pendingGoalNode;
+	bool decided; // decide() chose the actions below for the next update
+	bool ownStateUpdated; // decideAll already moved the robot's shots, reload and explosion on for the next update
+	Action shootingAction, dropFlagAction, motionAction;
+	static WorkStealingPool decisionPool; // threads of decideAll
+	// BZDB values the decision trees read, copied on the game thread before the robots decide (BZDB is not thread-safe)
+	struct DecisionSettings { float muzzleFront, muzzleHeight, shotRadius, shotRange, shotSpeed, laserAdVel, rapidFireAdVel, machineGunAdVel; };
+	static DecisionSettings settings;
+	static void readSettings(void);
+	void decideShooting(float dt); // the shooting tree, which asks the collision manager: game thread only
+	void decideMoves(float dt); // the drop-flag and motion trees
 };
 
 #endif // BZF_ROBOT_PLAYER_H
@@ -0,0 +1,122 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(void)
+	: body(NULL), unfinished(0), loop(0), stopping(false)
+{
+}
+
+WorkStealingPool::~WorkStealingPool(void)
+{
+	stop();
+}
+
+void WorkStealingPool::start(int threads)
+{
+	if (!workers.empty() || threads <= 0)
+		return;
+	stopping = false;
+	queues.clear();
+	for (int i = 0; i <= threads; i++)
+		queues.push_back(std::unique_ptr<Queue>(new Queue));
+	for (int i = 0; i < threads; i++)
+		workers.push_back(std::thread(&WorkStealingPool::work, this, i));
+}
+
+void WorkStealingPool::stop(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	loopStarted.notify_all();
+	for (int i = 0; i < (int)workers.size(); i++)
+		workers[i].join();
+	workers.clear();
+	queues.clear();
+}
+
+void WorkStealingPool::run(int count, const Body& loopBody)
+{
+	if (count <= 0)
+		return;
+	if (workers.empty()) {
+		for (int i = 0; i < count; i++)
+			loopBody(i);
+		return;
+	}
+
+	// body and unfinished before the chunks: a worker still looking for chunks of the last loop may take one at once
+	const int threads = (int)queues.size();
+	const int chunks = std::min(count, threads * WORK_CHUNKS_PER_THREAD);
+	body = &loopBody;
+	unfinished = chunks;
+	for (int c = 0; c < chunks; c++) {
+		Chunk chunk = { (int)((long long)count * c / chunks), (int)((long long)count * (c + 1) / chunks) };
+		Queue& queue = *queues[c % threads];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.chunks.push_back(chunk);
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		loop++;
+	}
+	loopStarted.notify_all();
+
+	while (runChunk(threads - 1))
+		;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (unfinished > 0)
+		loopFinished.wait(lock);
+	body = NULL;
+}
+
+// worker thread: works on each loop until it has no chunks left
+void WorkStealingPool::work(int self)
+{
+	unsigned long seen = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (!stopping && loop == seen)
+				loopStarted.wait(lock);
+			if (stopping)
+				return;
+			seen = loop;
+		}
+		while (runChunk(self))
+			;
+	}
+}
+
+// the newest chunk of the thread's own deque, else the oldest of another's
+bool WorkStealingPool::runChunk(int self)
+{
+	Chunk chunk;
+	bool found = false;
+	for (int i = 0; i < (int)queues.size() && !found; i++) {
+		Queue& queue = *queues[(self + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.chunks.empty())
+			continue;
+		if (i == 0) {
+			chunk = queue.chunks.back();
+			queue.chunks.pop_back();
+		}
+		else {
+			chunk = queue.chunks.front();
+			queue.chunks.pop_front();
+		}
+		found = true;
+	}
+	if (!found)
+		return false;
+
+	for (int i = chunk.begin; i < chunk.end; i++)
+		(*body)(i);
+	if (--unfinished == 0) {
+		std::lock_guard<std::mutex> lock(mutex); // so that run cannot miss the notification between its test and its wait
+		loopFinished.notify_all();
+	}
+	return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#ifndef	BZF_WORKSTEALINGPOOL_H
+#define	BZF_WORKSTEALINGPOOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#define WORK_CHUNKS_PER_THREAD 4 // chunks a loop is cut into per thread, so that there is something to steal
+
+// ============================================================
+// Threads for the parallel loops of the game thread. run(count, body) calls body(i) for each i in 0..count-1,
+// and returns once all calls are done; the calling thread works on the loop too. The indices are cut into
+// chunks and dealt out to a deque per thread. A thread takes chunks from the back of its own deque, and when
+// that is empty steals from the front of the others', so a thread that drew slow chunks does not hold up the
+// loop. The calls of a loop may run in any order and on any thread: body must not depend on either.
+// One loop at a time.
+
+class WorkStealingPool
+{
+public:
+	typedef std::function<void (int index)> Body;
+
+	WorkStealingPool(void);
+	~WorkStealingPool(void);
+
+	void start(int threads); // starts the workers, unless they run already
+	void stop(void); // joins the workers; not during a loop
+	int getThreadCount(void) const { return workers.size(); }
+
+	// Without workers, the calls run in the calling thread in index order
+	void run(int count, const Body& body);
+
+private:
+	WorkStealingPool(const WorkStealingPool&);
+	WorkStealingPool& operator=(const WorkStealingPool&);
+
+	struct Chunk
+	{
+		int begin, end;
+	};
+
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Chunk> chunks;
+	};
+
+	void work(int self);
+	bool runChunk(int self); // false once there is no chunk left to take or steal
+
+	std::vector<std::thread> workers;
+	std::vector<std::unique_ptr<Queue>> queues; // one per worker, the last for the thread calling run
+	const Body* body; // of the loop running
+	std::atomic<int> unfinished; // chunks of the loop not done yet
+	std::mutex mutex; // guards loop and stopping
+	std::condition_variable loopStarted, loopFinished;
+	unsigned long loop; // counts the loops started
+	bool stopping;
+};
+
+#endif // BZF_WORKSTEALINGPOOL_H
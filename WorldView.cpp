@@ -0,0 +1,128 @@
+#include "WorldView.h"
+#include "World.h"
+#include "LocalPlayer.h"
+#include "ShotPath.h"
+#include "playing.h" // needed for numFlags
+
+WorldView WorldView::view;
+
+WorldView::WorldView(void)
+	: playerCount(0), worldPlayerCount(0), flagCount(0), shotCount(0), teamFlags(false)
+{
+	for (int t = 0; t < NumTeams; t++)
+		teamFlag[t] = -1;
+}
+
+void WorldView::update(void)
+{
+	WorldView& v = view;
+	v.clear();
+	World* world = World::getWorld();
+	if (!world)
+		return;
+
+	const int maxPlayers = world->getCurMaxPlayers();
+	for (int i = 0; i < maxPlayers; i++)
+		if (world->getPlayer(i))
+			v.addPlayer(world->getPlayer(i));
+	v.worldPlayerCount = v.playerCount;
+	if (LocalPlayer::getMyTank())
+		v.addPlayer(LocalPlayer::getMyTank());
+
+	v.teamFlags = world->allowTeamFlags();
+	for (int i = 0; i < numFlags; i++) {
+		const Flag& flag = world->getFlag(i);
+		v.flagType.push_back(flag.type);
+		v.flagTeam.push_back(flag.type->flagTeam);
+		v.flagStatus.push_back(flag.status);
+		v.flagOwner.push_back(flag.owner);
+		v.flagX.push_back(flag.position[0]);
+		v.flagY.push_back(flag.position[1]);
+		v.flagZ.push_back(flag.position[2]);
+		TeamColor team = flag.type->flagTeam;
+		if (team >= 0 && team < NumTeams && v.teamFlag[team] < 0)
+			v.teamFlag[team] = i;
+	}
+	v.flagCount = numFlags;
+}
+
+void WorldView::clear(void)
+{
+	// clear keeps the capacity, so after the first ticks an update allocates nothing
+	playerCount = worldPlayerCount = flagCount = shotCount = 0;
+	player.clear();
+	playerId.clear();
+	playerTeam.clear();
+	playerAlive.clear();
+	playerFlag.clear();
+	playerFlagTeam.clear();
+	playerX.clear();
+	playerY.clear();
+	playerZ.clear();
+	playerVX.clear();
+	playerVY.clear();
+	playerVZ.clear();
+	playerAngle.clear();
+	playerIndex.clear();
+	flagType.clear();
+	flagTeam.clear();
+	flagStatus.clear();
+	flagOwner.clear();
+	flagX.clear();
+	flagY.clear();
+	flagZ.clear();
+	for (int t = 0; t < NumTeams; t++)
+		teamFlag[t] = -1;
+	shotOwner.clear();
+	shotX.clear();
+	shotY.clear();
+	shotZ.clear();
+	shotVX.clear();
+	shotVY.clear();
+	shotGuided.clear();
+	teamFlags = false;
+}
+
+void WorldView::addPlayer(Player* p)
+{
+	const PlayerId id = p->getId();
+	if (id >= playerIndex.size())
+		playerIndex.resize(id + 1, -1);
+	if (playerIndex[id] < 0)
+		playerIndex[id] = playerCount;
+
+	FlagType* flag = p->getFlag() ? p->getFlag() : Flags::Null;
+	const float* pos = p->getPosition();
+	const float* vel = p->getVelocity();
+	player.push_back(p);
+	playerId.push_back(id);
+	playerTeam.push_back(p->getTeam());
+	playerAlive.push_back(p->isAlive());
+	playerFlag.push_back(flag);
+	playerFlagTeam.push_back(flag != Flags::Null ? flag->flagTeam : NoTeam);
+	playerX.push_back(pos[0]);
+	playerY.push_back(pos[1]);
+	playerZ.push_back(pos[2]);
+	playerVX.push_back(vel[0]);
+	playerVY.push_back(vel[1]);
+	playerVZ.push_back(vel[2]);
+	playerAngle.push_back(p->getAngle());
+	playerCount++;
+
+	const int maxShots = p->getMaxShots();
+	for (int s = 0; s < maxShots; s++) {
+		ShotPath* shot = p->getShot(s);
+		if (!shot || shot->isExpired())
+			continue;
+		const float* shotPos = shot->getPosition();
+		const float* shotVel = shot->getVelocity();
+		shotOwner.push_back(id);
+		shotX.push_back(shotPos[0]);
+		shotY.push_back(shotPos[1]);
+		shotZ.push_back(shotPos[2]);
+		shotVX.push_back(shotVel[0]);
+		shotVY.push_back(shotVel[1]);
+		shotGuided.push_back(shot->getFlag() == Flags::GuidedMissile);
+		shotCount++;
+	}
+}
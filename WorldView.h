@@ -0,0 +1,74 @@
+#pragma once
+
+#ifndef	BZF_WORLDVIEW_H
+#define	BZF_WORLDVIEW_H
+
+#include <vector>
+#include "common.h"
+#include "Player.h"
+
+// ============================================================
+// The players, flags and shots of the world as the robots see them in a tick, in flat arrays: one
+// array per field, all indexed alike, so a scan over the players or flags reads only the fields it
+// tests, one after the other, instead of chasing a pointer per player or flag into World. The game
+// thread rebuilds the view once per tick, before the robots are retargeted and decide; from then on
+// the robots only read it, from any thread. What the robots do while they act in the tick (move,
+// shoot, drop a flag) shows in the next tick's view.
+//
+// Players are the world's players in index order (empty slots left out), then the local tank.
+// Flags are in world flag order, so a flag index means the same in the view as in World.
+
+class WorldView
+{
+public:
+	// Rebuilds the view from World. Call from the game thread, once per tick, before the robots think.
+	static void update(void);
+	// The view as of the last update
+	static const WorldView& get(void) { return view; }
+
+	int playerCount;
+	int worldPlayerCount; // the players before the local tank
+	std::vector<Player*> player;
+	std::vector<PlayerId> playerId;
+	std::vector<TeamColor> playerTeam;
+	std::vector<unsigned char> playerAlive; // not vector<bool>: one byte each, read without bit masking
+	std::vector<FlagType*> playerFlag; // carried, Flags::Null for none
+	std::vector<TeamColor> playerFlagTeam; // team of the flag carried, NoTeam for none or a flag of no team
+	std::vector<float> playerX, playerY, playerZ;
+	std::vector<float> playerVX, playerVY, playerVZ;
+	std::vector<float> playerAngle;
+
+	int flagCount;
+	std::vector<FlagType*> flagType;
+	std::vector<TeamColor> flagTeam;
+	std::vector<FlagStatus> flagStatus;
+	std::vector<PlayerId> flagOwner;
+	std::vector<float> flagX, flagY, flagZ;
+	int teamFlag[NumTeams]; // index of the team's flag, -1 for none
+
+	// shots in flight
+	int shotCount;
+	std::vector<PlayerId> shotOwner;
+	std::vector<float> shotX, shotY, shotZ;
+	std::vector<float> shotVX, shotVY;
+	std::vector<unsigned char> shotGuided; // a guided missile
+
+	bool teamFlags; // the world allows team flags
+
+	// index of the player with id, -1 for none
+	int findPlayer(PlayerId id) const { return id < playerIndex.size() ? playerIndex[id] : -1; }
+	// index of team's flag, -1 for none or without team flags
+	int findTeamFlag(TeamColor team) const { return teamFlags && team >= 0 && team < NumTeams ? teamFlag[team] : -1; }
+
+private:
+	WorldView(void);
+
+	void clear(void);
+	void addPlayer(Player* p);
+
+	std::vector<int> playerIndex; // by id
+
+	static WorldView view;
+};
+
+#endif // BZF_WORLDVIEW_H
@@ -0,0 +1,239 @@
+#include "MapGenerator.h"
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "common.h"
+#include "BZDBCache.h"
+#include "playing.h"
+
+#define CITY_BLOCK 60.0f // distance between the middles of two streets
+#define CITY_STREET 20.0f // width of a street
+#define CITY_PARKS 5 // one block in this many has no building
+#define MAZE_CELL 40.0f
+#define MAZE_WALL 2.0f // wall thickness
+#define BUILDING_HEIGHT 10.0f
+#define BASE_SIZE 15.0f // half width and breadth of a generated base
+#define BAD_FLAGS 4
+#define GOOD_FLAGS 4
+
+// small deterministic generator, so maps do not depend on the standard library's rand
+static unsigned int nextRandom(unsigned int& state)
+{
+	state = state * 1664525u + 1013904223u;
+	return state >> 8;
+}
+
+static float randomIn(unsigned int& state, float low, float high)
+{
+	return low + (high - low) * (nextRandom(state) & 0xffff) / 65535.0f;
+}
+
+const char* MapGenerator::getName(Layout layout)
+{
+	switch (layout) {
+		case OPEN: return "open";
+		case CITY: return "city";
+		case MAZE: return "maze";
+		default: return "bzw";
+	}
+}
+
+bool MapGenerator::parseName(const std::string& name, Layout& layout)
+{
+	for (int l = OPEN; l <= MAZE; l++)
+		if (name == getName((Layout)l)) {
+			layout = (Layout)l;
+			return true;
+		}
+	return false;
+}
+
+void MapGenerator::generate(Layout layout, float worldSize, unsigned int seed)
+{
+	World::getWorld()->clear();
+	BZDBCache::worldSize = worldSize;
+	float corner = worldSize / 2 * 0.75f;
+	addBase(RedTeam, -corner, -corner, BASE_SIZE, BASE_SIZE);
+	addBase(BlueTeam, corner, corner, BASE_SIZE, BASE_SIZE);
+	if (layout == CITY)
+		city(seed);
+	else if (layout == MAZE)
+		maze(seed);
+	addFlags(seed);
+}
+
+// BZW objects are blocks of "name value..." lines closed by "end"; boxes and bases give their position
+// (middle of the bottom face), size (half width and breadth, height) and rotation (degrees)
+bool MapGenerator::load(const std::string& path, unsigned int seed)
+{
+	std::ifstream file(path.c_str());
+	if (!file)
+		return false;
+	World::getWorld()->clear();
+	BZDBCache::worldSize = 800.0f; // bzflag's default
+	std::string line, object;
+	float position[3] = { 0.0f, 0.0f, 0.0f }, size[3] = { 0.0f, 0.0f, 0.0f }, rotation = 0.0f;
+	int color = 0;
+	while (std::getline(file, line)) {
+		std::istringstream words(line.substr(0, line.find('#')));
+		std::string word;
+		if (!(words >> word))
+			continue;
+		std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+		if (object.empty()) {
+			object = word;
+			position[0] = position[1] = position[2] = 0.0f;
+			size[0] = size[1] = size[2] = 0.0f;
+			rotation = 0.0f;
+			color = 0;
+		}
+		else if (word == "end") {
+			if (object == "box")
+				addBox(position[0], position[1], rotation * (float)M_PI / 180.0f, size[0], size[1], size[2]);
+			else if (object == "base" && color > 0 && color < NumTeams)
+				addBase(color, position[0], position[1], size[0] > 0.0f ? size[0] : BASE_SIZE, size[1] > 0.0f ? size[1] : BASE_SIZE);
+			object.clear();
+		}
+		else if (word == "position" || word == "pos")
+			words >> position[0] >> position[1] >> position[2];
+		else if (word == "size") {
+			words >> size[0] >> size[1] >> size[2];
+			if (object == "world")
+				BZDBCache::worldSize = 2.0f * size[0]; // a world's size is from the middle to an edge
+		}
+		else if (word == "rotation" || word == "rot")
+			words >> rotation;
+		else if (word == "color")
+			words >> color;
+	}
+	addFlags(seed);
+	return true;
+}
+
+void MapGenerator::addBox(float x, float y, float rotation, float width, float breadth, float height)
+{
+	float position[3] = { x, y, 0.0f };
+	World::getWorld()->buildings.push_back(BoxBuilding(position, rotation, width, breadth, height));
+}
+
+void MapGenerator::addBase(int team, float x, float y, float width, float breadth)
+{
+	World::Base base = { { x, y, 0.0f }, { width, breadth } };
+	World::getWorld()->bases[team].push_back(base);
+}
+
+// team flags on their bases, bad and good flags on free spots
+void MapGenerator::addFlags(unsigned int seed)
+{
+	World* world = World::getWorld();
+	unsigned int random = seed ^ 0x9e3779b9u;
+	FlagType* teamFlags[NumTeams] = { NULL, Flags::RedTeam, Flags::GreenTeam, Flags::BlueTeam, Flags::PurpleTeam };
+	for (int team = RedTeam; team < NumTeams; team++)
+		if (!world->bases[team].empty()) {
+			Flag flag = { teamFlags[team], FlagOnGround, 0, { 0.0f, 0.0f, 0.0f } };
+			memcpy(flag.position, world->bases[team][0].position, sizeof(flag.position));
+			world->flags.push_back(flag);
+		}
+	for (int i = 0; i < BAD_FLAGS; i++) {
+		Flag flag = { Flags::Bad, FlagOnGround, 0, { 0.0f, 0.0f, 0.0f } };
+		if (findFreeSpot(flag.position, random))
+			world->flags.push_back(flag);
+	}
+	FlagType* goodFlags[] = { Flags::Velocity, Flags::Laser, Flags::RapidFire, Flags::GuidedMissile };
+	for (int i = 0; i < GOOD_FLAGS; i++) {
+		Flag flag = { goodFlags[i % (sizeof(goodFlags) / sizeof(goodFlags[0]))], FlagOnGround, 0, { 0.0f, 0.0f, 0.0f } };
+		if (findFreeSpot(flag.position, random))
+			world->flags.push_back(flag);
+	}
+	numFlags = (int)world->flags.size();
+}
+
+void MapGenerator::addTanks(int count, int team, unsigned int seed)
+{
+	World* world = World::getWorld();
+	unsigned int random = seed ^ 0x7f4a7c15u;
+	for (int i = 0; i < count; i++) {
+		float position[3];
+		if (findFreeSpot(position, random))
+			world->players.push_back(new Player((PlayerId)world->players.size(), (TeamColor)team, position,
+				randomIn(random, 0.0f, 2.0f * (float)M_PI)));
+	}
+}
+
+bool MapGenerator::findFreeSpot(float* position, unsigned int& random)
+{
+	float edge = BZDBCache::worldSize / 2 - BZDBCache::tankRadius;
+	for (int attempt = 0; attempt < 100; attempt++) {
+		position[0] = randomIn(random, -edge, edge);
+		position[1] = randomIn(random, -edge, edge);
+		position[2] = 0.0f;
+		if (!World::getWorld()->inBuilding(position, BZDBCache::tankRadius, BZDBCache::tankHeight))
+			return true;
+	}
+	return false;
+}
+
+// true if a square of half size around (x, y) overlaps a base, so that the base is left free to drive onto
+static bool onBase(float x, float y, float half)
+{
+	World* world = World::getWorld();
+	for (int team = 0; team < NumTeams; team++)
+		for (int b = 0; b < (int)world->bases[team].size(); b++) {
+			const World::Base& base = world->bases[team][b];
+			if (fabsf(x - base.position[0]) < half + base.size[0] && fabsf(y - base.position[1]) < half + base.size[1])
+				return true;
+		}
+	return false;
+}
+
+void MapGenerator::city(unsigned int seed)
+{
+	unsigned int random = seed;
+	float half = BZDBCache::worldSize / 2;
+	float building = (CITY_BLOCK - CITY_STREET) / 2;
+	for (float x = -half + CITY_BLOCK / 2; x + building <= half; x += CITY_BLOCK)
+		for (float y = -half + CITY_BLOCK / 2; y + building <= half; y += CITY_BLOCK)
+			if (nextRandom(random) % CITY_PARKS != 0 && !onBase(x, y, building))
+				addBox(x, y, 0.0f, building, building, BUILDING_HEIGHT);
+}
+
+// depth-first maze over square cells: each cell starts walled in, and walls are knocked down along
+// a random walk that backs up at dead ends
+void MapGenerator::maze(unsigned int seed)
+{
+	unsigned int random = seed;
+	int cells = std::max(1, (int)(BZDBCache::worldSize / MAZE_CELL));
+	float start = -cells * MAZE_CELL / 2;
+	// east and north wall of each cell; the west and south edges of the maze are the world's
+	std::vector<bool> east(cells * cells, true), north(cells * cells, true), visited(cells * cells, false);
+	std::vector<int> stack(1, 0);
+	visited[0] = true;
+	while (!stack.empty()) {
+		int cell = stack.back(), x = cell % cells, y = cell / cells;
+		int next[4], count = 0;
+		if (x > 0 && !visited[cell - 1]) next[count++] = cell - 1;
+		if (x < cells - 1 && !visited[cell + 1]) next[count++] = cell + 1;
+		if (y > 0 && !visited[cell - cells]) next[count++] = cell - cells;
+		if (y < cells - 1 && !visited[cell + cells]) next[count++] = cell + cells;
+		if (count == 0) {
+			stack.pop_back();
+			continue;
+		}
+		int to = next[nextRandom(random) % count];
+		if (to == cell + 1) east[cell] = false;
+		else if (to == cell - 1) east[to] = false;
+		else if (to == cell + cells) north[cell] = false;
+		else north[to] = false;
+		visited[to] = true;
+		stack.push_back(to);
+	}
+	for (int y = 0; y < cells; y++)
+		for (int x = 0; x < cells; x++) {
+			float left = start + x * MAZE_CELL, bottom = start + y * MAZE_CELL;
+			if (east[y * cells + x] && x < cells - 1)
+				addBox(left + MAZE_CELL, bottom + MAZE_CELL / 2, 0.0f, MAZE_WALL / 2, MAZE_CELL / 2, BUILDING_HEIGHT);
+			if (north[y * cells + x] && y < cells - 1)
+				addBox(left + MAZE_CELL / 2, bottom + MAZE_CELL, 0.0f, MAZE_CELL / 2, MAZE_WALL / 2, BUILDING_HEIGHT);
+		}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifndef	BZF_MAPGENERATOR_H
+#define	BZF_MAPGENERATOR_H
+
+#include <string>
+
+// ============================================================
+// Maps for the benchmarks, built into the stand-in World (see standin/World.h). Each map has a red and
+// a blue base with their team flags, a few bad flags, so that every cost profile of GraphFunctionContainer
+// has something to avoid, and a few good flags for robots to pick up. Tanks are added separately. Maps
+// are a function of their layout, size and seed.
+
+class MapGenerator
+{
+public:
+	enum Layout
+	{
+		OPEN, // no buildings
+		CITY, // blocks of buildings between streets, some blocks and those on the bases left empty
+		MAZE, // walls of a maze with one way between any two cells
+		BZW // the boxes and bases of a BZW world file
+	};
+
+	static const char* getName(Layout layout);
+	static bool parseName(const std::string& name, Layout& layout); // false for an unknown name
+
+	// Fills the world with a map of the layout (not BZW) for a world of the given size and sets
+	// BZDBCache::worldSize to it
+	static void generate(Layout layout, float worldSize, unsigned int seed);
+	// Fills the world with the boxes, bases and size of a BZW file, and the flags of a generated map.
+	// Other objects (pyramids, meshes, teleporters...) are left out. false if the file cannot be read.
+	static bool load(const std::string& path, unsigned int seed);
+	// Adds count tanks of team that stand still, on free spots, with the next player ids
+	static void addTanks(int count, int team, unsigned int seed);
+
+private:
+	static void addBox(float x, float y, float rotation, float width, float breadth, float height);
+	static void addBase(int team, float x, float y, float width, float breadth);
+	static void addFlags(unsigned int seed); // after the buildings and bases
+	static bool findFreeSpot(float* position, unsigned int& random); // a random spot outside the buildings
+	static void city(unsigned int seed);
+	static void maze(unsigned int seed);
+};
+
+#endif // BZF_MAPGENERATOR_H
@@ -0,0 +1,508 @@
+/*
+ * Planner benchmark: plans between nodes of generated maps (and BZW worlds) with each of the
+ * robots' planners and their graph, outside the game. See README.txt for building and running it.
+ *
+ * For each map, world size, kind of queries, cost profile and planner that serves that profile,
+ * one line of JSON goes to stdout:
+ *   map, world_size, nodes        the map and the accessible nodes of its graph
+ *   queries                       "random": start and goal anywhere; "moving": runs of plans where
+ *                                 the start steps toward the goal and the goal steps away at random,
+ *                                 as in a pursuit
+ *   status                        cost profile: the currentStatus the graph is built for, with
+ *                                 "/flag" if the robot carries a good flag (the only profiles
+ *                                 without cost multipliers, so the only ones for jps and hpa)
+ *   planner                       astar, ara (sliced ARA*, all slices of a plan), lazy_theta,
+ *                                 jps and hpa (constant costs only), dstar_lite (trackable costs only)
+ *   plans, found                  plans made and how many found a path
+ *   plans_per_sec                 plans over the total time they took
+ *   expansions_mean, expansions_max
+ *   latency_p50_ms, latency_p99_ms, latency_max_ms
+ *   node_pool_bytes               memory the planner's nodes and successor links took (astar and ara,
+ *                                 -1 for the others)
+ *   peak_rss_kb                   peak resident memory of the process so far (-1 if unknown)
+ *   cost_ratio_max                with --check, the most a path cost in times the optimal cost (-1 without)
+ * A plan is timed from building the graph (as RobotPlayer::aStarSearch does for each plan) to
+ * taking its paths. Each planner is kept between the plans of a line, as a robot keeps it; hpa
+ * (which the robots no longer use, see AStarHierarchy.h) falls back to jps for plans too short for
+ * the abstraction, and counts abstract nodes reached as expansions. Messages from the planner sources go to stderr.
+ * --check also finds the optimal cost of each plan with Dijkstra's algorithm on the profile's graph (untimed),
+ * reports each planner and profile whose paths do not join start and goal, go through buildings or cost
+ * more than costBound allows, and then exits with 1.
+ */
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include "common.h"
+#include "BZDBCache.h"
+#include "playing.h"
+#include "AStarNode.h"
+#include "AStarHierarchy.h"
+#include "OccupancyGrid.h"
+#include "Landmarks.h"
+#include "InfluenceMap.h"
+#include "MapGenerator.h"
+#include "Report.h"
+
+typedef PersistentAStarPlanner<double, GraphFunctionContainer>::Planner Planner;
+typedef PersistentAStarPlanner<double, GraphFunctionContainer>::GraphDescriptor GraphDescriptor;
+typedef SlicedAStarPlanner<double, GraphFunctionContainer>::Planner SlicedPlanner;
+
+#define ENEMY_TANKS 3 // blue tanks standing on each map, for the RETURN profile's enemy costs
+#define MOVING_RUN 20 // plans of one pursuit in moving queries, before the next starts from a new pair
+#define CHECK_TOLERANCE 1e-3 // relative; jps plans on costs rounded to 1/FIXED_COST_SCALE
+
+struct Profile
+{
+	int status;
+	bool goodFlag; // the robot carries a good flag
+	const char* name;
+};
+static const Profile profiles[] = {
+	{ OFFENSE, false, "OFFENSE" }, { OFFENSIVE_PURSUIT, false, "OFFENSIVE_PURSUIT" }, { PATROL, false, "PATROL" },
+	{ PURSUIT, false, "PURSUIT" }, { RETURN, false, "RETURN" },
+	{ OFFENSIVE_PURSUIT, true, "OFFENSIVE_PURSUIT/flag" }, { PURSUIT, true, "PURSUIT/flag" }
+};
+
+enum PlannerKind { ASTAR, ARA, LAZY_THETA, JPS, HPA, DSTAR_LITE, PLANNER_KINDS };
+static const char* plannerNames[] = { "astar", "ara", "lazy_theta", "jps", "hpa", "dstar_lite" };
+
+static const char* queryNames[] = { "random", "moving" };
+
+struct Options
+{
+	int plans;
+	std::vector<int> planners;
+	std::vector<int> queries; // 0 random, 1 moving
+	std::vector<float> sizes;
+	std::vector<MapGenerator::Layout> layouts;
+	std::vector<std::string> bzwFiles;
+	unsigned int seed;
+	bool check; // compare each path's cost with the optimal one
+};
+
+static long expansions = 0; // counted by the A* planners' expansion event
+
+static void countExpansion(AStarNode, double, double, int)
+{
+	expansions++;
+}
+
+static bool checkFailed = false; // some planner's path cost more than its bound allows, or it found none
+
+static AStarHierarchy hierarchy;
+
+// what RobotPlayer::setObstacleList does when a world is loaded
+static void loadWorld(void)
+{
+	GraphFunctionContainer::worldChanged();
+	GraphFunctionContainer::setWorldSize(BZDBCache::worldSize);
+	OccupancyGrid::build();
+	GraphFunctionContainer::buildCoverField();
+	FixedCostGraphFunctionContainer::buildJumpDistances();
+	Landmarks::build();
+	InfluenceMap::update();
+	hierarchy.build();
+}
+
+static int countAccessibleNodes(void)
+{
+	int count = 0;
+	for (int y = GraphFunctionContainer::Ymin; y <= GraphFunctionContainer::Ymax; y++)
+		for (int x = GraphFunctionContainer::Xmin; x <= GraphFunctionContainer::Xmax; x++)
+			count += AStarNode::isAccessible(x, y);
+	return count;
+}
+
+static AStarNode randomNode(void)
+{
+	int width = GraphFunctionContainer::Xmax - GraphFunctionContainer::Xmin + 1;
+	int height = GraphFunctionContainer::Ymax - GraphFunctionContainer::Ymin + 1;
+	while (true) {
+		AStarNode node(GraphFunctionContainer::Xmin + rand() % width, GraphFunctionContainer::Ymin + rand() % height);
+		if (AStarNode::isAccessible(node.getX(), node.getY()))
+			return node;
+	}
+}
+
+// the accessible neighbour of node closest to target, or a random one; node itself if it has none
+static AStarNode step(const AStarNode& node, const AStarNode* target)
+{
+	AStarNode best = node;
+	int bestDistance = 0x7fffffff, neighbours = 0;
+	for (int dy = -1; dy <= 1; dy++)
+		for (int dx = -1; dx <= 1; dx++) {
+			int x = node.getX() + dx, y = node.getY() + dy;
+			if ((dx == 0 && dy == 0) || !AStarNode::isAccessible(x, y))
+				continue;
+			neighbours++;
+			if (target) {
+				int distance = std::max(abs(target->getX() - x), abs(target->getY() - y));
+				if (distance < bestDistance) {
+					bestDistance = distance;
+					best = AStarNode(x, y);
+				}
+			}
+			else if (rand() % neighbours == 0) // each neighbour is as likely
+				best = AStarNode(x, y);
+		}
+	return best;
+}
+
+// start and goal pairs of accessible nodes, the same for every cost profile and planner of a map
+static void pickQueries(int count, bool moving, unsigned int seed, std::vector<AStarNode>& starts, std::vector<AStarNode>& goals)
+{
+	srand(seed);
+	starts.clear();
+	goals.clear();
+	for (int q = 0; q < count; q++) {
+		if (moving && q % MOVING_RUN != 0) {
+			AStarNode goal = goals.back();
+			starts.push_back(step(starts.back(), &goal));
+			goals.push_back(step(goal, NULL));
+		}
+		else {
+			starts.push_back(randomNode());
+			goals.push_back(randomNode());
+		}
+	}
+}
+
+static bool servesProfile(int kind, const GraphFunctionContainer& graph)
+{
+	if (kind == JPS || kind == HPA)
+		return graph.hasConstantCosts();
+	if (kind == DSTAR_LITE)
+		return graph.hasTrackableCosts();
+	return true;
+}
+
+struct Reached
+{
+	double cost;
+	AStarNode node;
+	bool operator<(const Reached& r) const { return cost > r.cost; } // the cheapest on top of a priority_queue
+};
+
+// cost of the cheapest path from start to goal on graph, by Dijkstra's algorithm; -1 if there is none
+static double optimalCost(GraphFunctionContainer& graph, AStarNode start, AStarNode goal)
+{
+	std::vector<double> best(GraphFunctionContainer::getHashTableSize(), -1.0);
+	std::priority_queue<Reached> open;
+	std::vector<AStarNode> successors;
+	std::vector<double> costs;
+	Reached first = { 0.0, start };
+	best[graph.getHashBin(start)] = 0.0;
+	open.push(first);
+	while (!open.empty()) {
+		Reached reached = open.top();
+		open.pop();
+		if (reached.cost > best[graph.getHashBin(reached.node)])
+			continue; // reached for less since
+		if (reached.node == goal)
+			return reached.cost;
+		graph.getSuccessors(reached.node, &successors, &costs);
+		for (int i = 0; i < (int)successors.size(); i++) {
+			if (!graph.isAccessible(successors[i]))
+				continue;
+			double& cost = best[graph.getHashBin(successors[i])];
+			if (cost < 0.0 || reached.cost + costs[i] < cost) {
+				cost = reached.cost + costs[i];
+				Reached next = { cost, successors[i] };
+				open.push(next);
+			}
+		}
+	}
+	return -1.0;
+}
+
+// cost of driving path on graph from start to goal, whichever end of it start is at; -1 if it does not
+// join them or a tank cannot drive straight along one of its segments
+static double pathCost(GraphFunctionContainer& graph, std::vector<AStarNode> path, const AStarNode& start, const AStarNode& goal)
+{
+	if (path.empty())
+		return -1.0;
+	if (!(path.front() == start))
+		std::reverse(path.begin(), path.end());
+	if (!(path.front() == start) || !(path.back() == goal))
+		return -1.0;
+	double cost = 0.0;
+	for (int i = 0; i + 1 < (int)path.size(); i++) {
+		if (!graph.lineOfSight(path[i], path[i + 1]))
+			return -1.0;
+		cost += graph.getSegmentCost(path[i], path[i + 1]);
+	}
+	return cost;
+}
+
+// most a path of planner kind may cost, in times the optimal cost on graph. astar, jps and dstar_lite
+// are exact, and so is ara, which runs all its slices down to an optimal path. With cover the heuristic
+// may overestimate up to 2 times (see GraphFunctionContainer::getHeuristics), and so may every path.
+static double costBound(int kind, const GraphFunctionContainer& graph)
+{
+	if (graph.getCostProfile() & 2) // seeks cover
+		return 2.0;
+	if (kind == HPA)
+		return HPA_COST_BOUND;
+	if (kind == LAZY_THETA)
+		return LAZY_THETA_COST_BOUND;
+	return 1.0;
+}
+
+// Plans all queries in order with one planner for one cost profile, and prints their line.
+// With the optimal costs of the queries, also checks each path against costBound.
+static void benchmarkPlanner(const std::string& name, int nodes, int queries, const Profile& profile, int kind, Player& robot,
+	const std::vector<AStarNode>& starts, const std::vector<AStarNode>& goals, const std::vector<double>* optimal)
+{
+	Planner* planner = NULL;
+	SlicedPlanner* slicedPlanner = NULL;
+	PersistentLazyThetaStarPlanner<double, GraphFunctionContainer> anyAnglePlanner;
+	PersistentJPSPlanner<int, FixedCostGraphFunctionContainer> jpsPlanner;
+	PersistentDStarLitePlanner<double, GraphFunctionContainer> incrementalPlanner;
+	std::vector<double> latencies, expanded;
+	int found = 0, failed = 0;
+	double total = 0.0, worstRatio = optimal ? 0.0 : -1.0, bound = 1.0;
+	for (int q = 0; q < (int)starts.size(); q++) {
+		AStarNode start = starts[q], goal = goals[q];
+		std::vector< std::vector< AStarNode > > paths;
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		GraphFunctionContainer graph(BZDBCache::worldSize, profile.status, &robot);
+		expansions = 0;
+		if (kind == ASTAR || kind == ARA) {
+			// as PersistentAStarPlanner::plan and SlicedAStarPlanner::start, without progress messages and counting expansions
+			GraphDescriptor descriptor;
+			descriptor.graph = &graph;
+			descriptor.hashTableSize = GraphFunctionContainer::getHashTableSize();
+			descriptor.hashBinSizeIncreaseStep = 1;
+			descriptor.perfectHash = true;
+			descriptor.cacheSuccessorCosts = false;
+			descriptor.SeedNode = start;
+			descriptor.TargetNode = goal;
+			if (kind == ASTAR) {
+				if (!planner) {
+					planner = new Planner;
+					planner->setParams(1.0, 10, 0);
+					planner->setNodePooling();
+					planner->event_NodeExpanded_g = countExpansion;
+					planner->init(&descriptor);
+				}
+				else
+					planner->clearLastPlanAndInit(&descriptor);
+				planner->plan();
+				paths = planner->getPlannedPaths();
+			}
+			else {
+				if (!slicedPlanner) {
+					slicedPlanner = new SlicedPlanner;
+					slicedPlanner->setParams(A_STAR_ANYTIME_EPS, 10, 0);
+					slicedPlanner->setNodePooling();
+					slicedPlanner->setAnytime(true, A_STAR_ANYTIME_EPS_STEP);
+					slicedPlanner->setPlanningBudget(A_STAR_SLICE_EXPANSIONS);
+					slicedPlanner->event_NodeExpanded_g = countExpansion;
+					slicedPlanner->init(&descriptor);
+				}
+				else {
+					slicedPlanner->setParams(A_STAR_ANYTIME_EPS, 10, 0);
+					slicedPlanner->clearLastPlanAndInit(&descriptor);
+				}
+				do
+					slicedPlanner->plan();
+				while (!slicedPlanner->isPlanComplete());
+				paths = slicedPlanner->getPlannedPaths();
+			}
+		}
+		else if (kind == LAZY_THETA) {
+			paths = anyAnglePlanner.plan(&graph, start, goal);
+			expansions = anyAnglePlanner.getExpansionCount();
+		}
+		else if (kind == DSTAR_LITE) {
+			paths = incrementalPlanner.plan(&graph, start, goal);
+			expansions = incrementalPlanner.getExpansionCount();
+		}
+		else {
+			std::vector<AStarNode> hierarchyPath;
+			int hierarchyExpansions = 0;
+			if (kind == HPA && hierarchy.isLongRange(start, goal) && hierarchy.plan(start, goal, hierarchyPath, &hierarchyExpansions)) {
+				paths.push_back(hierarchyPath);
+				expansions = hierarchyExpansions;
+			}
+			else {
+				FixedCostGraphFunctionContainer fixedGraph;
+				paths = jpsPlanner.plan(&fixedGraph, start, goal, fixedGraph.getStraightCost(), fixedGraph.getDiagonalCost());
+				expansions = jpsPlanner.getExpansionCount();
+			}
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		total += seconds;
+		latencies.push_back(seconds * 1000.0);
+		expanded.push_back((double)expansions);
+		if (!paths.empty() && !paths[0].empty())
+			found++;
+		if (optimal) {
+			double best = (*optimal)[q];
+			double cost = paths.empty() ? -1.0 : pathCost(graph, paths[0], start, goal);
+			if (best < 0.0 || cost < 0.0)
+				failed += (best < 0.0) != (cost < 0.0); // a path where there is none, or none (or a broken one) where there is
+			else {
+				double ratio = best > 0.0 ? cost / best : 1.0 + cost;
+				bound = costBound(kind, graph);
+				worstRatio = std::max(worstRatio, ratio);
+				failed += ratio > bound * (1.0 + CHECK_TOLERANCE);
+			}
+		}
+	}
+	if (failed > 0) {
+		fprintf(stderr, "plannerbench: %s, size %g, %s, %s: %d of %d paths fail the check (cost up to %.4f times the optimum, bound %.4f)\n",
+			name.c_str(), BZDBCache::worldSize, profile.name, plannerNames[kind], failed, (int)starts.size(), worstRatio, bound);
+		checkFailed = true;
+	}
+	long poolBytes = -1;
+	if (planner)
+		poolBytes = planner->GenericPlannerInstance.nodePool ? (long)planner->GenericPlannerInstance.nodePool->bytesReserved() : 0;
+	else if (slicedPlanner)
+		poolBytes = slicedPlanner->GenericPlannerInstance.nodePool ? (long)slicedPlanner->GenericPlannerInstance.nodePool->bytesReserved() : 0;
+	double meanExpanded = 0.0;
+	for (int i = 0; i < (int)expanded.size(); i++)
+		meanExpanded += expanded[i] / expanded.size();
+	printf("{\"map\": \"%s\", \"world_size\": %g, \"nodes\": %d, \"queries\": \"%s\", \"status\": \"%s\", \"planner\": \"%s\", "
+		"\"plans\": %d, \"found\": %d, \"plans_per_sec\": %.1f, \"expansions_mean\": %.1f, \"expansions_max\": %.0f, "
+		"\"latency_p50_ms\": %.3f, \"latency_p99_ms\": %.3f, \"latency_max_ms\": %.3f, "
+		"\"node_pool_bytes\": %ld, \"peak_rss_kb\": %ld, \"cost_ratio_max\": %.4f}\n",
+		Report::escaped(name).c_str(), BZDBCache::worldSize, nodes, queryNames[queries], profile.name, plannerNames[kind],
+		(int)latencies.size(), found, total > 0.0 ? latencies.size() / total : 0.0, meanExpanded, Report::percentile(expanded, 1.0),
+		Report::percentile(latencies, 0.5), Report::percentile(latencies, 0.99), Report::percentile(latencies, 1.0),
+		poolBytes, Report::peakResidentKB(), worstRatio);
+	fflush(stdout);
+	delete planner;
+	delete slicedPlanner;
+}
+
+static void benchmarkMap(const std::string& name, const Options& options)
+{
+	loadWorld();
+	int nodes = countAccessibleNodes();
+	// the robot: a red tank on its base
+	const float* base = World::getWorld()->getBase(RedTeam, 0);
+	float origin[3] = { 0.0f, 0.0f, 0.0f };
+	Player robot(0, RedTeam, base ? base : origin, 0.0f);
+
+	for (int k = 0; k < (int)options.queries.size(); k++) {
+		std::vector<AStarNode> starts, goals;
+		if (nodes > 0)
+			pickQueries(options.plans, options.queries[k] == 1, options.seed, starts, goals);
+		for (int s = 0; s < (int)(sizeof(profiles) / sizeof(profiles[0])); s++) {
+			robot.setFlag(profiles[s].goodFlag ? Flags::Velocity : Flags::Null);
+			GraphFunctionContainer graph(BZDBCache::worldSize, profiles[s].status, &robot);
+			std::vector<double> optimal;
+			if (options.check)
+				for (int q = 0; q < (int)starts.size(); q++)
+					optimal.push_back(optimalCost(graph, starts[q], goals[q]));
+			for (int p = 0; p < (int)options.planners.size(); p++)
+				if (servesProfile(options.planners[p], graph))
+					benchmarkPlanner(name, nodes, options.queries[k], profiles[s], options.planners[p], robot, starts, goals,
+						options.check ? &optimal : NULL);
+		}
+	}
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: plannerbench [--plans N] [--sizes 400,800,...] [--maps open,city,maze] [--bzw FILE]... [--seed N]\n"
+		"                   [--planners astar,ara,lazy_theta,jps,hpa,dstar_lite] [--queries random,moving] [--check]\n");
+	exit(2);
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	options.plans = 200;
+	options.sizes.push_back(400.0f);
+	options.sizes.push_back(800.0f);
+	options.sizes.push_back(1600.0f);
+	options.layouts.push_back(MapGenerator::OPEN);
+	options.layouts.push_back(MapGenerator::CITY);
+	options.layouts.push_back(MapGenerator::MAZE);
+	options.seed = 1;
+	options.check = false;
+	for (int p = 0; p < PLANNER_KINDS; p++)
+		options.planners.push_back(p);
+	options.queries.push_back(0);
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--check") {
+			options.check = true;
+			continue;
+		}
+		if (i + 1 >= argc)
+			usage();
+		std::string value = argv[++i];
+		if (arg == "--plans")
+			options.plans = std::max(1, atoi(value.c_str()));
+		else if (arg == "--seed")
+			options.seed = (unsigned int)strtoul(value.c_str(), NULL, 10);
+		else if (arg == "--bzw")
+			options.bzwFiles.push_back(value);
+		else if (arg == "--sizes") {
+			options.sizes.clear();
+			std::vector<std::string> sizes = Report::splitList(value);
+			for (int s = 0; s < (int)sizes.size(); s++)
+				options.sizes.push_back((float)atof(sizes[s].c_str()));
+		}
+		else if (arg == "--maps") {
+			options.layouts.clear();
+			std::vector<std::string> names = Report::splitList(value);
+			for (int n = 0; n < (int)names.size(); n++) {
+				MapGenerator::Layout layout;
+				if (!MapGenerator::parseName(names[n], layout))
+					usage();
+				options.layouts.push_back(layout);
+			}
+		}
+		else if (arg == "--planners") {
+			options.planners.clear();
+			std::vector<std::string> names = Report::splitList(value);
+			for (int n = 0; n < (int)names.size(); n++) {
+				int p = 0;
+				while (p < PLANNER_KINDS && names[n] != plannerNames[p])
+					p++;
+				if (p == PLANNER_KINDS)
+					usage();
+				options.planners.push_back(p);
+			}
+		}
+		else if (arg == "--queries") {
+			options.queries.clear();
+			std::vector<std::string> names = Report::splitList(value);
+			for (int n = 0; n < (int)names.size(); n++) {
+				if (names[n] == queryNames[0])
+					options.queries.push_back(0);
+				else if (names[n] == queryNames[1])
+					options.queries.push_back(1);
+				else
+					usage();
+			}
+		}
+		else
+			usage();
+	}
+
+	for (int l = 0; l < (int)options.layouts.size(); l++)
+		for (int s = 0; s < (int)options.sizes.size(); s++) {
+			MapGenerator::generate(options.layouts[l], options.sizes[s], options.seed);
+			MapGenerator::addTanks(ENEMY_TANKS, BlueTeam, options.seed);
+			benchmarkMap(MapGenerator::getName(options.layouts[l]), options);
+		}
+	for (int f = 0; f < (int)options.bzwFiles.size(); f++) {
+		if (!MapGenerator::load(options.bzwFiles[f], options.seed)) {
+			fprintf(stderr, "cannot read %s\n", options.bzwFiles[f].c_str());
+			continue;
+		}
+		MapGenerator::addTanks(ENEMY_TANKS, BlueTeam, options.seed);
+		benchmarkMap(options.bzwFiles[f], options);
+	}
+	return checkFailed ? 1 : 0;
+}
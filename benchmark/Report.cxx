@@ -0,0 +1,45 @@
+#include "Report.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+
+std::string Report::escaped(const std::string& name)
+{
+	std::string out;
+	for (int i = 0; i < (int)name.size(); i++) {
+		if (name[i] == '"' || name[i] == '\\')
+			out += '\\';
+		out += name[i];
+	}
+	return out;
+}
+
+double Report::percentile(std::vector<double> values, double p)
+{
+	if (values.empty())
+		return 0.0;
+	std::sort(values.begin(), values.end());
+	return values[std::min(values.size() - 1, (size_t)(p * (values.size() - 1) + 0.5))];
+}
+
+long Report::peakResidentKB(void)
+{
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+		if (line.compare(0, 6, "VmHWM:") == 0)
+			return atol(line.c_str() + 6);
+	return -1;
+}
+
+std::vector<std::string> Report::splitList(const std::string& list)
+{
+	std::vector<std::string> items;
+	std::istringstream stream(list);
+	std::string item;
+	while (std::getline(stream, item, ','))
+		if (!item.empty())
+			items.push_back(item);
+	return items;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#ifndef	BZF_REPORT_H
+#define	BZF_REPORT_H
+
+#include <vector>
+#include <string>
+
+// ============================================================
+// What the benchmarks share for reading their options and writing their results as lines of JSON
+
+class Report
+{
+public:
+	static std::string escaped(const std::string& name); // name as a JSON string's contents
+	static double percentile(std::vector<double> values, double p); // p from 0 to 1, 0 without values
+	static long peakResidentKB(void); // peak resident memory of the process so far, -1 if unknown
+	static std::vector<std::string> splitList(const std::string& list); // the items of a comma separated list
+};
+
+#endif // BZF_REPORT_H
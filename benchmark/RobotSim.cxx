@@ -0,0 +1,438 @@
+/*
+ * Robot simulation benchmark: robots play capture the flag on a generated map (or a BZW world),
+ * headless, at a fixed timestep, with RobotPlayer, its decision trees and planners as in the game.
+ * The server, the network and the rest of the client are stood in for by the code below, which
+ * follows what playing.cxx and the server do for robots. See README.txt for building and running it.
+ *
+ * Runs are reproducible: the map, spawn spots and bzfrand() come from the seed, rand() is seeded
+ * with it, plans are made on the game thread (build with PLANNER_THREADS 0), and retargeting has
+ * no time budget per tick unless one is given with --budget. The checksum of the final positions and
+ * flags tells whether two runs played the same game.
+ *
+ * For each robot count, one line of JSON goes to stdout:
+ *   map, world_size, robots, ticks, dt
+ *   ai_ms_mean, ai_ms_p50, ai_ms_p99, ai_ms_max   AI time per tick (the sum of the parts below)
+ *   decisions_ms, planning_ms, path_following_ms, perception_ms   mean per tick (see AIProfile.h)
+ *   tick_ms_mean                  wall time per tick, including the stand-in server and tank motion
+ *   captures, kills               to tell at a glance that the robots played
+ *   peak_rss_kb                   peak resident memory of the process so far (-1 if unknown)
+ *   checksum
+ * Messages from the robot and planner sources go to stderr, including what the planners print to
+ * stdout, so that stdout only has the JSON.
+ */
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <unistd.h>
+#include "common.h"
+#include "BZDBCache.h"
+#include "playing.h"
+#include "Roster.h"
+#include "RobotPlayer.h"
+#include "InfluenceMap.h"
+#include "AIScheduler.h"
+#include "WorldView.h"
+#include "MapGenerator.h"
+#include "Report.h"
+
+#ifndef AI_PROFILE
+#error build with AI_PROFILE defined, so that RobotPlayer times its work
+#endif
+
+#define MAX_ROBOTS 256
+
+struct Options
+{
+	std::vector<int> robotCounts;
+	int ticks;
+	float dt;
+	MapGenerator::Layout layout;
+	float size;
+	std::string bzwFile;
+	unsigned int seed;
+	float budget; // seconds of retargeting per tick, 0 for no limit
+};
+
+RobotPlayer* robots[MAX_ROBOTS];
+int numRobots = 0;
+static ServerLink server;
+ServerLink* serverLink = &server;
+
+static int captures = 0, kills = 0;
+static std::vector<BzfRegion*> obstacleList;
+static FILE* report = stdout;
+
+static RobotPlayer* lookupRobot(PlayerId id)
+{
+	return id < numRobots ? robots[id] : NULL;
+}
+
+// a random spot outside the buildings, from bzfrand so that it follows the seed
+static void findSpawnSpot(float* position)
+{
+	float edge = BZDBCache::worldSize / 2 - BZDBCache::tankRadius;
+	for (int attempt = 0; attempt < 100; attempt++) {
+		position[0] = (float)(bzfrand() * 2.0 - 1.0) * edge;
+		position[1] = (float)(bzfrand() * 2.0 - 1.0) * edge;
+		position[2] = 0.0f;
+		if (!World::getWorld()->inBuilding(position, BZDBCache::tankRadius, BZDBCache::tankHeight))
+			return;
+	}
+}
+
+// the flag player id carries, -1 if none
+static int findCarriedFlag(PlayerId id)
+{
+	for (int i = 0; i < numFlags; i++) {
+		Flag& flag = World::getWorld()->getFlag(i);
+		if (flag.status == FlagOnTank && flag.owner == id)
+			return i;
+	}
+	return -1;
+}
+
+// -------------------------------
+// the stand-in server: answers at once, as if every message arrived in the same tick
+
+void ServerLink::sendAlive(PlayerId id)
+{
+	RobotPlayer* robot = lookupRobot(id);
+	if (!robot)
+		return;
+	float position[3];
+	findSpawnSpot(position);
+	robot->restart(position, (float)(bzfrand() * 2.0 * M_PI));
+	AIScheduler::makeUrgent(id); // retargeted in the next update
+}
+
+void ServerLink::sendDropFlag(PlayerId id, const float* position)
+{
+	int index = findCarriedFlag(id);
+	RobotPlayer* robot = lookupRobot(id);
+	if (index < 0 || !robot)
+		return;
+	Flag& flag = World::getWorld()->getFlag(index);
+	flag.status = FlagOnGround;
+	flag.position[0] = position[0];
+	flag.position[1] = position[1];
+	flag.position[2] = 0.0f;
+	robot->setFlag(Flags::Null);
+}
+
+void ServerLink::sendGrabFlag(PlayerId id, int flagIndex)
+{
+	RobotPlayer* robot = lookupRobot(id);
+	Flag& flag = World::getWorld()->getFlag(flagIndex);
+	if (!robot || flag.status != FlagOnGround || robot->getFlag() != Flags::Null)
+		return;
+	flag.status = FlagOnTank;
+	flag.owner = id;
+	robot->setFlag(flag.type);
+}
+
+// the flag goes back to its base
+void ServerLink::sendCaptureFlag(PlayerId id, TeamColor)
+{
+	int index = findCarriedFlag(id);
+	RobotPlayer* robot = lookupRobot(id);
+	if (index < 0 || !robot)
+		return;
+	Flag& flag = World::getWorld()->getFlag(index);
+	const float* base = World::getWorld()->getBase(flag.type->flagTeam, 0);
+	flag.status = FlagOnGround;
+	if (base)
+		memcpy(flag.position, base, sizeof(flag.position));
+	robot->setFlag(Flags::Null);
+	captures++;
+}
+
+// a shot killed robot: it drops its flag where it died
+static void gotBlowedUp(RobotPlayer* robot)
+{
+	if (robot->getFlag() != Flags::Null)
+		serverLink->sendDropFlag(robot->getId(), robot->getPosition());
+	robot->explodeTank();
+	kills++;
+}
+
+// -------------------------------
+// what playing.cxx does for robots every frame
+
+static void setRobotTarget(RobotPlayer* robot)
+{
+	Player* bestTarget = NULL;
+	float bestPriority = 0.0f;
+	World* world = World::getWorld();
+	for (int j = 0; j < world->getCurMaxPlayers(); j++) {
+		Player* p = world->getPlayer(j);
+		if (p && p->getId() != robot->getId() && p->isAlive() && robot->validTeamTarget(p)) {
+			if ((robot->getTeam() == RedTeam && p->getFlag() == Flags::RedTeam) ||
+				(robot->getTeam() == BlueTeam && p->getFlag() == Flags::BlueTeam)) {
+				bestTarget = p;
+				break;
+			}
+			const float priority = robot->getTargetPriority(p);
+			if (priority > bestPriority) {
+				bestTarget = p;
+				bestPriority = priority;
+			}
+		}
+	}
+	robot->setTarget(bestTarget);
+}
+
+static void updateRobots(float dt)
+{
+	// paths planned since the last update
+	RobotPlayer::deliverPlans();
+	// the players, flags and shots the robots see this tick, and the costs around the flags and enemies
+	{
+		AI_PROFILE_SCOPE(AIProfile::PERCEPTION);
+		WorldView::update();
+		InfluenceMap::update();
+	}
+
+	// retarget live robots and start dead ones on their turns, spread over the frames
+	AIScheduler::beginFrame(dt);
+	for (int i = AIScheduler::nextRobot(); i >= 0; i = AIScheduler::nextRobot()) {
+		if (robots[i]->isAlive())
+			setRobotTarget(robots[i]);
+		else // not while exploding (see AIScheduler)
+			serverLink->sendAlive(robots[i]->getId());
+	}
+
+	// all robots decide on the world as it is now, on several threads, then act one at a time
+	RobotPlayer::decideAll(dt);
+
+	// do updates
+	for (int i = 0; i < numRobots; i++)
+		robots[i]->update(dt);
+}
+
+// captures, flags driven over, and shots that hit
+static void checkEnvironment(RobotPlayer* tank)
+{
+	if (!tank->isAlive())
+		return;
+	World* world = World::getWorld();
+	const float* position = tank->getPosition();
+
+	FlagType* flagd = tank->getFlag();
+	if (flagd->flagTeam != NoTeam) {
+		TeamColor base = world->whoseBase(position);
+		TeamColor team = tank->getTeam();
+		if (base != NoTeam && ((flagd->flagTeam == team && base != team) || (flagd->flagTeam != team && base == team)))
+			serverLink->sendCaptureFlag(tank->getId(), base);
+	}
+	else if (flagd == Flags::Null) {
+		const float radius = tank->getRadius() + BZDBCache::flagRadius;
+		for (int i = 0; i < numFlags; i++) {
+			Flag& flag = world->getFlag(i);
+			if (flag.status == FlagOnGround && hypotf(position[0] - flag.position[0], position[1] - flag.position[1]) < radius) {
+				serverLink->sendGrabFlag(tank->getId(), i);
+				break;
+			}
+		}
+	}
+
+	for (int i = 0; i < world->getCurMaxPlayers(); i++) {
+		Player* shooter = world->getPlayer(i);
+		if (!shooter || shooter == tank)
+			continue;
+		for (int s = 0; s < shooter->getMaxShots(); s++) {
+			ShotPath* shot = shooter->getShot(s);
+			if (!shot || shot->isExpired())
+				continue;
+			const float* shotPos = shot->getPosition();
+			if (fabsf(shotPos[2] - position[2]) < BZDBCache::tankHeight
+				&& hypotf(shotPos[0] - position[0], shotPos[1] - position[1]) < BZDBCache::tankRadius) {
+				shot->setExpired();
+				gotBlowedUp(tank);
+				return;
+			}
+		}
+	}
+}
+
+// -------------------------------
+// runs
+
+// FNV-1a over the robots' positions and azimuths and the flags' places
+static unsigned int checksum(void)
+{
+	unsigned int hash = 2166136261u;
+	std::vector<float> values;
+	for (int i = 0; i < numRobots; i++) {
+		values.insert(values.end(), robots[i]->getPosition(), robots[i]->getPosition() + 3);
+		values.push_back(robots[i]->getAngle());
+	}
+	for (int i = 0; i < numFlags; i++) {
+		Flag& flag = World::getWorld()->getFlag(i);
+		values.insert(values.end(), flag.position, flag.position + 3);
+		values.push_back((float)flag.status);
+	}
+	const unsigned char* bytes = (const unsigned char*)(values.empty() ? NULL : &values[0]);
+	for (size_t i = 0; i < values.size() * sizeof(float); i++)
+		hash = (hash ^ bytes[i]) * 16777619u;
+	return hash;
+}
+
+static bool makeMap(const Options& options)
+{
+	if (options.bzwFile.empty()) {
+		MapGenerator::generate(options.layout, options.size, options.seed);
+		return true;
+	}
+	if (!MapGenerator::load(options.bzwFile, options.seed)) {
+		fprintf(stderr, "cannot read %s\n", options.bzwFile.c_str());
+		return false;
+	}
+	return true;
+}
+
+static void simulate(int count, const Options& options)
+{
+	if (!makeMap(options))
+		return;
+	World* world = World::getWorld();
+	bzfsrand(options.seed);
+	srand(options.seed);
+	AIScheduler::reset();
+	AIScheduler::setBudget(options.budget);
+	captures = kills = 0;
+
+	// red and blue robots by turns, with their ids as player indices; the local tank (which the
+	// planners ask about) is an observer that never spawns
+	numRobots = count;
+	for (int i = 0; i < numRobots; i++) {
+		char name[32];
+		sprintf(name, "robot%d", i);
+		robots[i] = new RobotPlayer((PlayerId)i, name, serverLink, "");
+		robots[i]->setTeam(i % 2 == 0 ? RedTeam : BlueTeam);
+		world->players.push_back(robots[i]);
+	}
+	LocalPlayer observer((PlayerId)numRobots, "observer", "");
+	LocalPlayer::setMyTank(&observer);
+
+	// the game area, as the first region of playing.cxx's makeObstacleList (not split around buildings)
+	const float edge = 0.5f * BZDBCache::worldSize - BZDBCache::tankRadius;
+	const float gameArea[4][2] = { { -edge, -edge }, { edge, -edge }, { edge, edge }, { -edge, edge } };
+	obstacleList.push_back(new BzfRegion(4, gameArea));
+	RobotPlayer::setObstacleList(&obstacleList);
+	for (int p = 0; p < AIProfile::PARTS; p++)
+		AIProfile::take((AIProfile::Part)p);
+
+	std::vector<double> ai, tick;
+	double parts[AIProfile::PARTS] = { 0.0 };
+	for (int t = 0; t < options.ticks; t++) {
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		updateRobots(options.dt);
+		for (int i = 0; i < numRobots; i++)
+			checkEnvironment(robots[i]);
+		tick.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() * 1000.0);
+		double sum = 0.0;
+		for (int p = 0; p < AIProfile::PARTS; p++) {
+			double ms = AIProfile::take((AIProfile::Part)p);
+			parts[p] += ms;
+			sum += ms;
+		}
+		ai.push_back(sum);
+	}
+
+	double meanAI = 0.0, meanTick = 0.0;
+	for (int t = 0; t < options.ticks; t++) {
+		meanAI += ai[t] / options.ticks;
+		meanTick += tick[t] / options.ticks;
+	}
+	std::string name = options.bzwFile.empty() ? MapGenerator::getName(options.layout) : options.bzwFile;
+	fprintf(report, "{\"map\": \"%s\", \"world_size\": %g, \"robots\": %d, \"ticks\": %d, \"dt\": %g, "
+		"\"ai_ms_mean\": %.4f, \"ai_ms_p50\": %.4f, \"ai_ms_p99\": %.4f, \"ai_ms_max\": %.4f, ",
+		Report::escaped(name).c_str(), BZDBCache::worldSize, numRobots, options.ticks, options.dt,
+		meanAI, Report::percentile(ai, 0.5), Report::percentile(ai, 0.99), Report::percentile(ai, 1.0));
+	for (int p = 0; p < AIProfile::PARTS; p++)
+		fprintf(report, "\"%s_ms\": %.4f, ", AIProfile::getName((AIProfile::Part)p), parts[p] / options.ticks);
+	fprintf(report, "\"tick_ms_mean\": %.4f, \"captures\": %d, \"kills\": %d, \"peak_rss_kb\": %ld, \"checksum\": \"%08x\"}\n",
+		meanTick, captures, kills, Report::peakResidentKB(), checksum());
+	fflush(report);
+
+	// the robots go with the world's players
+	world->clear();
+	numRobots = 0;
+	LocalPlayer::setMyTank(NULL);
+	for (int i = 0; i < (int)obstacleList.size(); i++)
+		delete obstacleList[i];
+	obstacleList.clear();
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: robotsim [--robots 1,4,16,...] [--ticks N] [--dt SECONDS] [--map open|city|maze] [--size N] [--bzw FILE] [--seed N] [--budget MS]\n");
+	exit(2);
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	options.robotCounts.push_back(1);
+	options.robotCounts.push_back(4);
+	options.robotCounts.push_back(16);
+	options.robotCounts.push_back(64);
+	options.robotCounts.push_back(256);
+	options.ticks = 1500;
+	options.dt = 0.02f;
+	options.layout = MapGenerator::CITY;
+	options.size = 800.0f;
+	options.seed = 1;
+	options.budget = 0.0f;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (i + 1 >= argc)
+			usage();
+		std::string value = argv[++i];
+		if (arg == "--ticks")
+			options.ticks = std::max(1, atoi(value.c_str()));
+		else if (arg == "--dt")
+			options.dt = (float)atof(value.c_str());
+		else if (arg == "--size")
+			options.size = (float)atof(value.c_str());
+		else if (arg == "--budget")
+			options.budget = (float)atof(value.c_str()) / 1000.0f;
+		else if (arg == "--seed")
+			options.seed = (unsigned int)strtoul(value.c_str(), NULL, 10);
+		else if (arg == "--bzw")
+			options.bzwFile = value;
+		else if (arg == "--map") {
+			if (!MapGenerator::parseName(value, options.layout))
+				usage();
+		}
+		else if (arg == "--robots") {
+			options.robotCounts.clear();
+			std::vector<std::string> counts = Report::splitList(value);
+			for (int c = 0; c < (int)counts.size(); c++) {
+				int count = atoi(counts[c].c_str());
+				if (count < 1 || count > MAX_ROBOTS)
+					usage();
+				options.robotCounts.push_back(count);
+			}
+		}
+		else
+			usage();
+	}
+	if (options.dt <= 0.0f)
+		usage();
+
+	// the report keeps stdout; anything else printed there goes to stderr
+	fflush(stdout);
+	int reportFd = dup(STDOUT_FILENO);
+	if (reportFd >= 0 && (report = fdopen(reportFd, "w")) != NULL)
+		dup2(STDERR_FILENO, STDOUT_FILENO);
+	else
+		report = stdout;
+
+	for (int c = 0; c < (int)options.robotCounts.size(); c++)
+		simulate(options.robotCounts[c], options);
+	return 0;
+}
@@ -0,0 +1,479 @@
+// Definitions behind the stand-in bzflag headers in standin/: the world is a list of boxes
+// that the benchmarks' map generator fills in, and every query scans it
+
+#include "common.h"
+#include "BZDBCache.h"
+#include "CollisionManager.h"
+#include "ShotStrategy.h"
+#include "Intersect.h"
+#include "Region.h"
+#include "playing.h"
+#include <algorithm>
+
+float BZDBCache::tankRadius = 4.32f; // bzflag's defaults
+float BZDBCache::tankHeight = 2.05f;
+float BZDBCache::tankLength = 6.0f;
+float BZDBCache::tankSpeed = 25.0f;
+float BZDBCache::flagRadius = 2.5f;
+float BZDBCache::gravity = -9.8f;
+float BZDBCache::worldSize = 800.0f;
+
+const std::string StateDatabase::BZDB_MUZZLEFRONT = "_muzzleFront";
+const std::string StateDatabase::BZDB_MUZZLEHEIGHT = "_muzzleHeight";
+const std::string StateDatabase::BZDB_SHOTRADIUS = "_shotRadius";
+const std::string StateDatabase::BZDB_SHOTRANGE = "_shotRange";
+const std::string StateDatabase::BZDB_SHOTSPEED = "_shotSpeed";
+const std::string StateDatabase::BZDB_TANKANGVEL = "_tankAngVel";
+const std::string StateDatabase::BZDB_LASERADVEL = "_laserAdVel";
+const std::string StateDatabase::BZDB_RFIREADVEL = "_rFireAdVel";
+const std::string StateDatabase::BZDB_MGUNADVEL = "_mGunAdVel";
+StateDatabase BZDB;
+
+static FlagType nullFlag(NoTeam, FlagGood), redFlag(RedTeam, FlagGood), greenFlag(GreenTeam, FlagGood),
+	blueFlag(BlueTeam, FlagGood), purpleFlag(PurpleTeam, FlagGood), badFlag(NoTeam, FlagBad, FlagSticky),
+	genocideFlag(NoTeam, FlagGood), laserFlag(NoTeam, FlagGood), velocityFlag(NoTeam, FlagGood),
+	burrowFlag(NoTeam, FlagGood), seerFlag(NoTeam, FlagGood), jumpingFlag(NoTeam, FlagGood),
+	guidedMissileFlag(NoTeam, FlagGood), rapidFireFlag(NoTeam, FlagGood), machineGunFlag(NoTeam, FlagGood);
+FlagType* Flags::Null = &nullFlag;
+FlagType* Flags::RedTeam = &redFlag;
+FlagType* Flags::GreenTeam = &greenFlag;
+FlagType* Flags::BlueTeam = &blueFlag;
+FlagType* Flags::PurpleTeam = &purpleFlag;
+FlagType* Flags::Bad = &badFlag;
+FlagType* Flags::Genocide = &genocideFlag;
+FlagType* Flags::Laser = &laserFlag;
+FlagType* Flags::Velocity = &velocityFlag;
+FlagType* Flags::Burrow = &burrowFlag;
+FlagType* Flags::Seer = &seerFlag;
+FlagType* Flags::Jumping = &jumpingFlag;
+FlagType* Flags::GuidedMissile = &guidedMissileFlag;
+FlagType* Flags::RapidFire = &rapidFireFlag;
+FlagType* Flags::MachineGun = &machineGunFlag;
+
+static ControlPanel panel;
+ControlPanel* controlPanel = &panel;
+int numFlags = 0;
+CollisionManager COLLISIONMGR;
+LocalPlayer* LocalPlayer::myTank = NULL;
+
+// small deterministic generator, so runs do not depend on the standard library's rand
+static unsigned int randomState = 1;
+
+double bzfrand()
+{
+	randomState = randomState * 1664525u + 1013904223u;
+	return (randomState >> 8) / 16777216.0;
+}
+
+void bzfsrand(unsigned int seed)
+{
+	randomState = seed;
+}
+
+StateDatabase::StateDatabase()
+{
+	values[BZDB_MUZZLEFRONT] = BZDBCache::tankRadius + 0.1f;
+	values[BZDB_MUZZLEHEIGHT] = 1.57f;
+	values[BZDB_SHOTRADIUS] = 0.5f;
+	values[BZDB_SHOTRANGE] = 350.0f;
+	values[BZDB_SHOTSPEED] = 100.0f;
+	values[BZDB_TANKANGVEL] = (float)M_PI / 4.0f;
+	values[BZDB_LASERADVEL] = 1000.0f;
+	values[BZDB_RFIREADVEL] = 1.5f;
+	values[BZDB_MGUNADVEL] = 1.5f;
+}
+
+float StateDatabase::eval(const std::string& name)
+{
+	std::map<std::string, float>::const_iterator it = values.find(name);
+	return it == values.end() ? 0.0f : it->second;
+}
+
+void ControlPanel::addMessage(const std::string& message, const int)
+{
+	fprintf(stderr, "%s\n", message.c_str());
+}
+
+// -------------------------------
+// World
+
+World* World::getWorld()
+{
+	static World world;
+	return &world;
+}
+
+const Obstacle* World::inBuilding(const float* pos, float radius, float height) const
+{
+	for (int i = 0; i < (int)buildings.size(); i++)
+		if (buildings[i].inCylinder(pos, radius, height))
+			return &buildings[i];
+	return NULL;
+}
+
+TeamColor World::whoseBase(const float* position) const
+{
+	for (int team = 0; team < NumTeams; team++)
+		for (int b = 0; b < (int)bases[team].size(); b++)
+			if (fabsf(position[0] - bases[team][b].position[0]) <= bases[team][b].size[0]
+				&& fabsf(position[1] - bases[team][b].position[1]) <= bases[team][b].size[1])
+				return (TeamColor)team;
+	return NoTeam;
+}
+
+void World::clear()
+{
+	buildings.clear();
+	for (int team = 0; team < NumTeams; team++)
+		bases[team].clear();
+	flags.clear();
+	for (int i = 0; i < (int)players.size(); i++)
+		delete players[i];
+	players.clear();
+	numFlags = 0;
+}
+
+const ObsList* CollisionManager::cylinderTest(const float* pos, float radius, float height) const
+{
+	static std::vector<Obstacle*> found; // game thread only, like bzflag's
+	static ObsList list;
+	std::vector<BoxBuilding>& buildings = World::getWorld()->buildings;
+	found.clear();
+	for (int i = 0; i < (int)buildings.size(); i++) {
+		const float* p = buildings[i].getPosition();
+		const float* size = buildings[i].getSize();
+		if (hypotf(pos[0] - p[0], pos[1] - p[1]) <= radius + hypotf(size[0], size[1]))
+			found.push_back(&buildings[i]);
+	}
+	list.count = (int)found.size();
+	list.list = found.empty() ? NULL : &found[0];
+	return &list;
+}
+
+const Obstacle* ShotStrategy::getFirstBuilding(const Ray& r, float min, float& t)
+{
+	const Obstacle* first = NULL;
+	std::vector<BoxBuilding>& buildings = World::getWorld()->buildings;
+	for (int i = 0; i < (int)buildings.size(); i++) {
+		float hit = buildings[i].intersect(r);
+		if (hit > min && hit < t) {
+			t = hit;
+			first = &buildings[i];
+		}
+	}
+	return first;
+}
+
+// -------------------------------
+// BoxBuilding
+
+BoxBuilding::BoxBuilding(const float* p, float r, float width, float breadth, float height)
+	: rotation(r)
+{
+	for (int i = 0; i < 3; i++)
+		pos[i] = p[i];
+	size[0] = width;
+	size[1] = breadth;
+	size[2] = height;
+}
+
+void BoxBuilding::toBox(const float* p, float& x, float& y) const
+{
+	float dx = p[0] - pos[0], dy = p[1] - pos[1];
+	float c = cosf(rotation), s = sinf(rotation);
+	x = c * dx + s * dy;
+	y = -s * dx + c * dy;
+}
+
+bool BoxBuilding::inCylinder(const float* p, float radius, float height) const
+{
+	if (p[2] >= pos[2] + size[2] || p[2] + height < pos[2])
+		return false;
+	float x, y;
+	toBox(p, x, y);
+	float outX = std::max(0.0f, fabsf(x) - size[0]), outY = std::max(0.0f, fabsf(y) - size[1]);
+	return outX * outX + outY * outY < radius * radius;
+}
+
+float BoxBuilding::intersect(const Ray& r) const
+{
+	const float* o = r.getOrigin();
+	const float* d = r.getDirection();
+	if (o[2] >= pos[2] + size[2] || o[2] < pos[2])
+		return -1.0f;
+	float x, y;
+	toBox(o, x, y);
+	float c = cosf(rotation), s = sinf(rotation);
+	float origin[2] = { x, y };
+	float direction[2] = { c * d[0] + s * d[1], -s * d[0] + c * d[1] };
+	float enter = -1.0e30f, leave = 1.0e30f;
+	for (int i = 0; i < 2; i++) {
+		if (fabsf(direction[i]) < 1.0e-9f) {
+			if (fabsf(origin[i]) > size[i])
+				return -1.0f;
+			continue;
+		}
+		float t0 = (-size[i] - origin[i]) / direction[i], t1 = (size[i] - origin[i]) / direction[i];
+		enter = std::max(enter, std::min(t0, t1));
+		leave = std::min(leave, std::max(t0, t1));
+	}
+	if (enter > leave || leave < 0.0f)
+		return -1.0f;
+	return enter;
+}
+
+// -------------------------------
+// Player, LocalPlayer and ShotPath
+
+Player::Player(PlayerId id, TeamColor team, const float* pos, float azimuth, const char* callSign)
+	: id(id), team(team), azimuth(azimuth), angularVelocity(0.0f), status(PlayerState::Alive), flag(Flags::Null)
+{
+	strncpy(this->callSign, callSign, sizeof(this->callSign) - 1);
+	this->callSign[sizeof(this->callSign) - 1] = '\0';
+	for (int i = 0; i < 3; i++) {
+		position[i] = pos[i];
+		velocity[i] = 0.0f;
+	}
+}
+
+Player::~Player()
+{
+	for (int i = 0; i < (int)shots.size(); i++)
+		delete shots[i];
+}
+
+float Player::getRadius() const
+{
+	return BZDBCache::tankRadius;
+}
+
+bool Player::validTeamTarget(const Player* p) const
+{
+	return p->getTeam() != getTeam() || getTeam() == RogueTeam;
+}
+
+ShotPath::ShotPath(const float* pos, const float* vel, float lifetime, FlagType* flag)
+	: lifetime(lifetime), flag(flag), expired(false)
+{
+	for (int i = 0; i < 3; i++) {
+		position[i] = pos[i];
+		velocity[i] = vel[i];
+	}
+}
+
+void ShotPath::update(float dt)
+{
+	for (int i = 0; i < 3; i++)
+		position[i] += velocity[i] * dt;
+	lifetime -= dt;
+	if (lifetime <= 0.0f || World::getWorld()->inBuilding(position, BZDB.eval(StateDatabase::BZDB_SHOTRADIUS), 0.0f))
+		expired = true;
+}
+
+static const float origin[3] = { 0.0f, 0.0f, 0.0f };
+
+LocalPlayer::LocalPlayer(const PlayerId& id, const char* name, const char*)
+	: Player(id, RogueTeam, origin, 0.0f, name), gettingSound(false), server(NULL),
+	desiredSpeed(0.0f), desiredAngVel(0.0f), reloadTime(0.0f), explodeTime(0.0f)
+{
+	status = PlayerState::DeadStatus;
+	shots.resize(1, NULL); // bzflag's default of one shot at a time
+}
+
+LocalPlayer::~LocalPlayer()
+{
+}
+
+void LocalPlayer::update(float inputDT)
+{
+	float dt = inputDT < 0.0f ? 0.02f : inputDT;
+	doUpdate(dt);
+	doUpdateMotion(dt);
+}
+
+void LocalPlayer::explodeTank()
+{
+	status = PlayerState::Exploding;
+	explodeTime = 5.0f;
+	desiredSpeed = desiredAngVel = 0.0f;
+	velocity[0] = velocity[1] = velocity[2] = 0.0f;
+	angularVelocity = 0.0f;
+}
+
+void LocalPlayer::restart(const float* pos, float _azimuth)
+{
+	for (int i = 0; i < 3; i++) {
+		position[i] = pos[i];
+		velocity[i] = 0.0f;
+	}
+	azimuth = _azimuth;
+	angularVelocity = 0.0f;
+	status = PlayerState::Alive;
+	flag = Flags::Null;
+	desiredSpeed = desiredAngVel = 0.0f;
+	reloadTime = 0.0f;
+	for (int i = 0; i < (int)shots.size(); i++) {
+		delete shots[i];
+		shots[i] = NULL;
+	}
+}
+
+void LocalPlayer::setDesiredSpeed(float fracOfMaxSpeed)
+{
+	desiredSpeed = std::max(-1.0f, std::min(1.0f, fracOfMaxSpeed));
+}
+
+void LocalPlayer::setDesiredAngVel(float fracOfMaxAngVel)
+{
+	desiredAngVel = std::max(-1.0f, std::min(1.0f, fracOfMaxAngVel));
+}
+
+FiringStatus LocalPlayer::getFiringStatus() const
+{
+	if (!isAlive())
+		return Deceased;
+	if (reloadTime > 0.0f)
+		return Loading;
+	for (int i = 0; i < (int)shots.size(); i++)
+		if (!shots[i])
+			return Ready;
+	return Loading;
+}
+
+bool LocalPlayer::fireShot()
+{
+	if (getFiringStatus() != Ready)
+		return false;
+	int slot = 0;
+	while (shots[slot])
+		slot++;
+	float dir[3] = { cosf(azimuth), sinf(azimuth), 0.0f };
+	float front = BZDB.eval(StateDatabase::BZDB_MUZZLEFRONT), speed = BZDB.eval(StateDatabase::BZDB_SHOTSPEED);
+	float pos[3] = { position[0] + front * dir[0], position[1] + front * dir[1],
+		position[2] + BZDB.eval(StateDatabase::BZDB_MUZZLEHEIGHT) };
+	float vel[3] = { speed * dir[0] + velocity[0], speed * dir[1] + velocity[1], 0.0f };
+	float lifetime = BZDB.eval(StateDatabase::BZDB_SHOTRANGE) / speed;
+	shots[slot] = new ShotPath(pos, vel, lifetime, flag);
+	reloadTime = lifetime; // bzflag's reload time is a shot's time of flight
+	return true;
+}
+
+void LocalPlayer::doUpdate(float dt)
+{
+	for (int i = 0; i < (int)shots.size(); i++)
+		if (shots[i]) {
+			shots[i]->update(dt);
+			if (shots[i]->isExpired()) {
+				delete shots[i];
+				shots[i] = NULL;
+			}
+		}
+	reloadTime = std::max(0.0f, reloadTime - dt);
+	if (isExploding()) {
+		explodeTime -= dt;
+		if (explodeTime <= 0.0f)
+			status = PlayerState::DeadStatus;
+	}
+}
+
+// turns, then drives along the new azimuth; a move into a building or off the world is cut down to its
+// part along one axis (sliding along the wall), or to nothing
+void LocalPlayer::doUpdateMotion(float dt)
+{
+	if (!isAlive() || dt <= 0.0f) {
+		velocity[0] = velocity[1] = velocity[2] = 0.0f;
+		angularVelocity = 0.0f;
+		return;
+	}
+	angularVelocity = desiredAngVel * BZDB.eval(StateDatabase::BZDB_TANKANGVEL);
+	azimuth = fmodf(azimuth + angularVelocity * dt, 2.0f * (float)M_PI);
+	if (azimuth < 0.0f)
+		azimuth += 2.0f * (float)M_PI;
+	float speed = desiredSpeed * BZDBCache::tankSpeed * (desiredSpeed < 0.0f ? 0.5f : 1.0f);
+	float step[2] = { speed * cosf(azimuth) * dt, speed * sinf(azimuth) * dt };
+	const float tries[3][2] = { { step[0], step[1] }, { step[0], 0.0f }, { 0.0f, step[1] } };
+	const float radius = BZDBCache::tankRadius / 2, edge = BZDBCache::worldSize / 2 - radius;
+	float moved[2] = { 0.0f, 0.0f };
+	for (int t = 0; t < 3; t++) {
+		float next[3] = { position[0] + tries[t][0], position[1] + tries[t][1], position[2] };
+		if (fabsf(next[0]) <= edge && fabsf(next[1]) <= edge
+			&& !World::getWorld()->inBuilding(next, radius, BZDBCache::tankHeight)) {
+			moved[0] = tries[t][0];
+			moved[1] = tries[t][1];
+			break;
+		}
+	}
+	position[0] += moved[0];
+	position[1] += moved[1];
+	velocity[0] = moved[0] / dt;
+	velocity[1] = moved[1] / dt;
+}
+
+// -------------------------------
+// BzfRegion and intersections
+
+BzfRegion::BzfRegion(int sides, const float c[][2])
+	: distance(0.0f), target(NULL), mailbox(-1)
+{
+	for (int i = 0; i < sides; i++)
+		corners.push_back(RegionPoint(c[i]));
+	a[0] = a[1] = 0.0f;
+}
+
+bool BzfRegion::isInside(const float* p) const
+{
+	for (int i = 0; i < (int)corners.size(); i++) {
+		const float* p1 = corners[i].get();
+		const float* p2 = corners[(i + 1) % corners.size()].get();
+		if ((p2[0] - p1[0]) * (p[1] - p1[1]) - (p2[1] - p1[1]) * (p[0] - p1[0]) < 0.0f)
+			return false;
+	}
+	return true;
+}
+
+float BzfRegion::getDistance(const float* p, float* nearest) const
+{
+	float best = maxDistance;
+	for (int i = 0; i < (int)corners.size(); i++) {
+		const float* p1 = corners[i].get();
+		const float* p2 = corners[(i + 1) % corners.size()].get();
+		float d[2] = { p2[0] - p1[0], p2[1] - p1[1] };
+		float length2 = d[0] * d[0] + d[1] * d[1];
+		float t = length2 > 0.0f ? ((p[0] - p1[0]) * d[0] + (p[1] - p1[1]) * d[1]) / length2 : 0.0f;
+		t = std::max(0.0f, std::min(1.0f, t));
+		float q[2] = { p1[0] + t * d[0], p1[1] + t * d[1] };
+		float distance = hypotf(p[0] - q[0], p[1] - q[1]);
+		if (distance < best) {
+			best = distance;
+			nearest[0] = q[0];
+			nearest[1] = q[1];
+		}
+	}
+	return best;
+}
+
+void BzfRegion::setPathStuff(float _distance, BzfRegion* _target, const float* _a, int _mailbox)
+{
+	distance = _distance;
+	target = _target;
+	a[0] = _a[0];
+	a[1] = _a[1];
+	mailbox = _mailbox;
+}
+
+float rayAtDistanceFromOrigin(const Ray& r, float radius)
+{
+	const float* o = r.getOrigin();
+	const float* d = r.getDirection();
+	float a = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+	float b = 2.0f * (o[0] * d[0] + o[1] * d[1] + o[2] * d[2]);
+	float c = o[0] * o[0] + o[1] * o[1] + o[2] * o[2] - radius * radius;
+	float discriminant = b * b - 4.0f * a * c;
+	if (a <= 0.0f || discriminant < 0.0f)
+		return -1.0f;
+	float root = sqrtf(discriminant);
+	float t = (-b - root) / (2.0f * a);
+	if (t < 0.0f)
+		t = (-b + root) / (2.0f * a);
+	return t;
+}
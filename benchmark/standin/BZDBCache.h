@@ -0,0 +1,17 @@
+// Stand-in for bzflag's BZDBCache: the variables the planner and robot sources read, set by the benchmarks
+#pragma once
+
+#include "common.h"
+#include "StateDatabase.h"
+
+class BZDBCache
+{
+public:
+	static float tankRadius;
+	static float tankHeight;
+	static float tankLength;
+	static float tankSpeed;
+	static float flagRadius;
+	static float gravity;
+	static float worldSize;
+};
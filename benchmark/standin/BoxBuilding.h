@@ -0,0 +1,28 @@
+// Stand-in for bzflag's BoxBuilding: a box standing on pos, rotated about its vertical axis
+#pragma once
+
+#include "Obstacle.h"
+#include "Ray.h"
+
+class BoxBuilding : public Obstacle
+{
+public:
+	// pos is the middle of the bottom face, size half the width and breadth and the whole height
+	// (as in a BZW file), rotation in radians
+	BoxBuilding(const float* pos, float rotation, float width, float breadth, float height);
+
+	bool inCylinder(const float* p, float radius, float height) const;
+	// distance along r at which it enters the box's footprint, negative if it does not
+	float intersect(const Ray& r) const;
+
+	const float* getPosition() const { return pos; }
+	const float* getSize() const { return size; }
+	float getRotation() const { return rotation; }
+
+private:
+	void toBox(const float* p, float& x, float& y) const; // p relative to pos, along the box's sides
+
+	float pos[3];
+	float size[3];
+	float rotation;
+};
@@ -0,0 +1,19 @@
+// Stand-in for bzflag's CollisionManager: a linear scan of the world's buildings
+#pragma once
+
+#include "Obstacle.h"
+
+struct ObsList
+{
+	int count;
+	Obstacle** list;
+};
+
+class CollisionManager
+{
+public:
+	// the buildings whose bounds come within radius of pos
+	const ObsList* cylinderTest(const float* pos, float radius, float height) const;
+};
+
+extern CollisionManager COLLISIONMGR;
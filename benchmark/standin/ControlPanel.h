@@ -0,0 +1,10 @@
+// Stand-in for bzflag's ControlPanel: messages go to stderr, away from the benchmark's results
+#pragma once
+
+#include <string>
+
+class ControlPanel
+{
+public:
+	void addMessage(const std::string& message, const int mode = 3);
+};
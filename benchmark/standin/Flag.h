@@ -0,0 +1,35 @@
+// Stand-in for bzflag's Flag, with the fields the planner and robot sources read
+#pragma once
+
+#include "common.h"
+
+enum TeamColor { AutomaticTeam = -2, NoTeam = -1, RogueTeam = 0, RedTeam = 1, GreenTeam = 2, BlueTeam = 3, PurpleTeam = 4, NumTeams = 5 };
+enum FlagQuality { FlagGood = 0, FlagBad = 1 };
+enum FlagEndurance { FlagNormal = 0, FlagUnstable = 1, FlagSticky = 2 };
+enum FlagStatus { FlagNoExist = 0, FlagOnGround, FlagOnTank, FlagInAir, FlagComing, FlagGoing };
+typedef uint16_t PlayerId; // wider than bzflag's byte: the simulation runs up to 256 robots and the local tank
+
+class FlagType
+{
+public:
+	FlagType(TeamColor team, FlagQuality quality, FlagEndurance endurance = FlagNormal)
+		: flagTeam(team), flagQuality(quality), endurance(endurance) {}
+	TeamColor flagTeam;
+	FlagQuality flagQuality;
+	FlagEndurance endurance;
+};
+
+class Flag
+{
+public:
+	FlagType* type;
+	FlagStatus status;
+	PlayerId owner;
+	float position[3];
+};
+
+namespace Flags {
+	extern FlagType *Null, *RedTeam, *GreenTeam, *BlueTeam, *PurpleTeam;
+	extern FlagType *Bad; // any bad flag, sticky as in bzflag
+	extern FlagType *Genocide, *Laser, *Velocity, *Burrow, *Seer, *Jumping, *GuidedMissile, *RapidFire, *MachineGun;
+}
@@ -0,0 +1,7 @@
+// Stand-in for bzflag's Intersect, with the one test RobotPlayer makes
+#pragma once
+
+#include "Ray.h"
+
+// the first distance along r at which it comes within radius of the origin, negative if it never does
+float rayAtDistanceFromOrigin(const Ray& r, float radius);
@@ -0,0 +1,48 @@
+// Stand-in for bzflag's LocalPlayer: a tank driven by this process. It turns and drives at the
+// speeds asked for, slides along buildings and the world's edge instead of entering them, and fires
+// one shot at a time. No jumping, falling, teleporters or flag effects.
+#pragma once
+
+#include "Player.h"
+#include "ServerLink.h"
+
+enum FiringStatus { Deceased, Ready, Loading, Sealed, Zoned };
+
+class LocalPlayer : public Player
+{
+public:
+	enum Location { Dead, OnGround, InAir, OnBuilding, InBuilding };
+
+	LocalPlayer(const PlayerId& id, const char* name, const char* motto);
+	virtual ~LocalPlayer();
+
+	static LocalPlayer* getMyTank() { return myTank; }
+	static void setMyTank(LocalPlayer* tank) { myTank = tank; }
+
+	// doUpdate then doUpdateMotion, for a tick of inputDT seconds
+	void update(float inputDT = -1.0f);
+
+	virtual void explodeTank(); // dead, exploding for a while
+	virtual void restart(const float* pos, float azimuth); // alive at pos, without a flag or shots
+	bool isExploding() const { return Player::isExploding(); }
+
+	void setDesiredSpeed(float fracOfMaxSpeed); // -1 (backwards, at half speed) to 1
+	void setDesiredAngVel(float fracOfMaxAngVel); // -1 to 1, positive counterclockwise
+	bool fireShot(); // false unless Ready
+	FiringStatus getFiringStatus() const;
+	Location getLocation() const { return isAlive() ? OnGround : Dead; }
+
+protected:
+	virtual void doUpdate(float dt); // moves the shots on, reloads, ends an explosion
+	virtual void doUpdateMotion(float dt); // turns and drives
+
+	bool gettingSound;
+	ServerLink* server;
+
+private:
+	float desiredSpeed, desiredAngVel;
+	float reloadTime; // seconds until the next shot
+	float explodeTime; // seconds until an explosion is over
+
+	static LocalPlayer* myTank;
+};
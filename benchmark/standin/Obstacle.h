@@ -0,0 +1,10 @@
+// Stand-in for bzflag's Obstacle, with the one test the planner sources make
+#pragma once
+
+class Obstacle
+{
+public:
+	virtual ~Obstacle() {}
+	// true if a cylinder standing at p with the given radius and height overlaps the obstacle
+	virtual bool inCylinder(const float* p, float radius, float height) const = 0;
+};
@@ -0,0 +1,58 @@
+// Stand-in for bzflag's Player: a tank's state as the other players see it. A Player on its own stands
+// still where it was put; LocalPlayer moves it.
+#pragma once
+
+#include <vector>
+#include "Flag.h"
+#include "ShotPath.h"
+
+namespace PlayerState {
+	enum { DeadStatus = 0, Alive = 1, Exploding = 2, Paused = 4, Falling = 8 };
+}
+
+class Player
+{
+public:
+	// an alive tank at pos
+	Player(PlayerId id, TeamColor team, const float* pos, float azimuth, const char* callSign = "");
+	virtual ~Player();
+
+	PlayerId getId() const { return id; }
+	TeamColor getTeam() const { return team; }
+	TeamColor getColor() const { return team; }
+	void setTeam(TeamColor t) { team = t; }
+	void changeTeam(TeamColor t) { team = t; }
+	const char* getCallSign() const { return callSign; }
+
+	const float* getPosition() const { return position; }
+	const float* getVelocity() const { return velocity; }
+	float getAngle() const { return azimuth; }
+	float getAngularVelocity() const { return angularVelocity; }
+	short getStatus() const { return status; }
+	bool isAlive() const { return (status & PlayerState::Alive) != 0; }
+	bool isExploding() const { return (status & PlayerState::Exploding) != 0; }
+	bool isPaused() const { return (status & PlayerState::Paused) != 0; }
+	bool isPhantomZoned() const { return false; }
+	float getRadius() const;
+
+	FlagType* getFlag() const { return flag; }
+	void setFlag(FlagType* f) { flag = f; }
+
+	int getMaxShots() const { return (int)shots.size(); }
+	ShotPath* getShot(int index) const { return shots[index]; } // NULL for a free slot
+
+	// true if p is a tank this one may shoot at: not itself, and of another team unless both are rogues
+	bool validTeamTarget(const Player* p) const;
+
+protected:
+	PlayerId id;
+	TeamColor team;
+	char callSign[32];
+	float position[3];
+	float velocity[3];
+	float azimuth; // radians, 0 to 2 pi
+	float angularVelocity;
+	short status;
+	FlagType* flag;
+	std::vector<ShotPath*> shots;
+};
@@ -0,0 +1,20 @@
+// Stand-in for bzflag's Ray
+#pragma once
+
+class Ray
+{
+public:
+	Ray(const float* o, const float* d)
+	{
+		for (int i = 0; i < 3; i++) {
+			origin[i] = o[i];
+			direction[i] = d[i];
+		}
+	}
+	const float* getOrigin() const { return origin; }
+	const float* getDirection() const { return direction; }
+
+private:
+	float origin[3];
+	float direction[3];
+};
@@ -0,0 +1,45 @@
+// Stand-in for bzflag's BzfRegion: a convex polygon of the ground a tank can reach. RobotPlayer only
+// asks which region a point is in or nearest to; the regions have no neighbours.
+#pragma once
+
+#include <vector>
+#include "common.h"
+
+const float maxDistance = 1.0e6f;
+
+class RegionPoint
+{
+public:
+	RegionPoint(const float* p) { point[0] = p[0]; point[1] = p[1]; }
+	const float* get() const { return point; }
+
+private:
+	float point[2];
+};
+
+class BzfRegion
+{
+public:
+	BzfRegion(int sides, const float corners[][2]); // counterclockwise
+
+	bool isInside(const float* p) const;
+	// distance from p to the region's edge, and the nearest point of it
+	float getDistance(const float* p, float* nearest) const;
+	int getNumSides() const { return (int)corners.size(); }
+	const RegionPoint& getCorner(int index) const { return corners[index]; }
+	BzfRegion* getNeighbor(int) const { return NULL; }
+
+	// path search state, kept as bzflag does
+	float getDistance() const { return distance; }
+	const float* getA() const { return a; }
+	BzfRegion* getTarget() const { return target; }
+	bool test(int mailbox) const { return this->mailbox != mailbox; } // not reached in this search yet
+	void setPathStuff(float distance, BzfRegion* target, const float* a, int mailbox);
+
+private:
+	std::vector<RegionPoint> corners;
+	float distance;
+	BzfRegion* target;
+	float a[2];
+	int mailbox;
+};
@@ -0,0 +1,16 @@
+// Stand-in for bzflag's RegionPriorityQueue: regions by increasing priority
+#pragma once
+
+#include <map>
+#include "Region.h"
+
+class RegionPriorityQueue
+{
+public:
+	void insert(BzfRegion* region, float priority) { queue.insert(std::make_pair(priority, region)); }
+	BzfRegion* remove() { BzfRegion* region = queue.begin()->second; queue.erase(queue.begin()); return region; }
+	bool isEmpty() const { return queue.empty(); }
+
+private:
+	std::multimap<float, BzfRegion*> queue;
+};
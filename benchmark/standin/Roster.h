@@ -0,0 +1,7 @@
+// Stand-in for bzflag's Roster: the robots of this process, kept by the simulation
+#pragma once
+
+class RobotPlayer;
+
+extern RobotPlayer* robots[];
+extern int numRobots;
@@ -0,0 +1,16 @@
+// Stand-in for bzflag's ServerLink: the messages robots send to the server, answered by the
+// simulation's stand-in server (see ../RobotSim.cxx) on the spot
+#pragma once
+
+#include "Flag.h"
+
+class ServerLink
+{
+public:
+	void sendAlive(PlayerId id);
+	void sendDropFlag(PlayerId id, const float* position);
+	void sendGrabFlag(PlayerId id, int flagIndex);
+	void sendCaptureFlag(PlayerId id, TeamColor base);
+};
+
+extern ServerLink* serverLink;
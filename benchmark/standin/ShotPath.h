@@ -0,0 +1,25 @@
+// Stand-in for bzflag's ShotPath: a shot flying straight until its range is used up or it hits a building
+#pragma once
+
+#include "Flag.h"
+
+class ShotPath
+{
+public:
+	ShotPath(const float* pos, const float* vel, float lifetime, FlagType* flag);
+
+	bool isExpired() const { return expired; }
+	const float* getPosition() const { return position; }
+	const float* getVelocity() const { return velocity; }
+	FlagType* getFlag() const { return flag; }
+
+	void update(float dt); // moves on, and expires at the end of its range or in a building
+	void setExpired() { expired = true; }
+
+private:
+	float position[3];
+	float velocity[3];
+	float lifetime; // seconds left
+	FlagType* flag;
+	bool expired;
+};
@@ -0,0 +1,12 @@
+// Stand-in for bzflag's ShotStrategy, for RobotPlayer::pathIsClear's ray test
+#pragma once
+
+#include "Ray.h"
+#include "Obstacle.h"
+
+class ShotStrategy
+{
+public:
+	// the first building r hits beyond min and before t (which it then sets to the distance of the hit)
+	static const Obstacle* getFirstBuilding(const Ray& r, float min, float& t);
+};
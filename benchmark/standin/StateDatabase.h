@@ -0,0 +1,28 @@
+// Stand-in for bzflag's StateDatabase: the variables the robot sources evaluate, at bzflag's defaults
+#pragma once
+
+#include <string>
+#include <map>
+
+class StateDatabase
+{
+public:
+	static const std::string BZDB_MUZZLEFRONT;
+	static const std::string BZDB_MUZZLEHEIGHT;
+	static const std::string BZDB_SHOTRADIUS;
+	static const std::string BZDB_SHOTRANGE;
+	static const std::string BZDB_SHOTSPEED;
+	static const std::string BZDB_TANKANGVEL;
+	static const std::string BZDB_LASERADVEL;
+	static const std::string BZDB_RFIREADVEL;
+	static const std::string BZDB_MGUNADVEL;
+
+	StateDatabase();
+	float eval(const std::string& name); // 0 for a variable that is not set
+	void set(const std::string& name, float value) { values[name] = value; }
+
+private:
+	std::map<std::string, float> values;
+};
+
+extern StateDatabase BZDB;
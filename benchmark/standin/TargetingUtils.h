@@ -0,0 +1,12 @@
+// Stand-in for bzflag's TargetingUtils
+#pragma once
+
+#include "common.h"
+
+class TargetingUtils
+{
+public:
+	static float getTargetDistance(const float* src, const float* target)
+		{ return sqrtf((target[0] - src[0]) * (target[0] - src[0]) + (target[1] - src[1]) * (target[1] - src[1])
+			+ (target[2] - src[2]) * (target[2] - src[2])); }
+};
@@ -0,0 +1,32 @@
+// Stand-in for bzflag's World: the buildings, bases, flags and players of a generated map
+// (see ../MapGenerator.h), which the benchmarks fill in directly
+#pragma once
+
+#include <vector>
+#include "Player.h"
+#include "Obstacle.h"
+#include "BoxBuilding.h"
+
+class World
+{
+public:
+	static World* getWorld();
+
+	const Obstacle* inBuilding(const float* pos, float radius, float height) const;
+	bool allowTeamFlags() const { return true; }
+	Flag& getFlag(int index) const { return const_cast<Flag&>(flags[index]); }
+	int getCurMaxPlayers() const { return (int)players.size(); }
+	Player* getPlayer(int index) const { return players[index]; }
+	// position of a team's base, NULL past its last one
+	const float* getBase(int team, int base = 0) const
+		{ return (team >= 0 && team < NumTeams && base < (int)bases[team].size()) ? bases[team][base].position : NULL; }
+	TeamColor whoseBase(const float* position) const; // team of the base position is on, NoTeam if it is on none
+
+	void clear(); // also deletes the players
+
+	struct Base { float position[3]; float size[2]; }; // size: half width and breadth, along the axes
+	std::vector<BoxBuilding> buildings;
+	std::vector<Base> bases[NumTeams];
+	std::vector<Flag> flags; // numFlags follows its size
+	std::vector<Player*> players; // by id, owned by the world
+};
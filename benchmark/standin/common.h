@@ -0,0 +1,18 @@
+// Stand-in for bzflag's common.h, with only what the planner and robot sources use (see ../README.txt)
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define ZERO_TOLERANCE 1.0e-06f
+
+// bzflag's random numbers in [0, 1), from a seeded generator so that runs repeat
+double bzfrand();
+void bzfsrand(unsigned int seed);
@@ -0,0 +1,11 @@
+// Stand-in for bzflag's playing.h: the globals the planner and robot sources use
+#pragma once
+
+#include "ControlPanel.h"
+#include "ServerLink.h"
+#include "LocalPlayer.h"
+#include "World.h"
+#include "ShotStrategy.h"
+
+extern ControlPanel* controlPanel;
+extern int numFlags;
@@ -52,7 +52,7 @@ namespace aicore
 		return (bot->*decFuncPtr)(dt);
 	}
 
-	void DecisionPtr::runDecisionTree(DecisionPtr decTree[], RobotPlayer* bot, float dt)
+	RobotPlayer::Action DecisionPtr::findAction(DecisionPtr decTree[], RobotPlayer* bot, float dt)
 	{
 		// Find the decision
 		DecisionTreeNode *node = decTree[0].makeDecision(bot, dt);
@@ -63,7 +63,13 @@ namespace aicore
 			throw "NULL action function pointer in decision tree.";
 #endif // TRACE_DECTREE
 		}
-		else {
+		return actFuncPtr;
+	}
+
+	void DecisionPtr::runDecisionTree(DecisionPtr decTree[], RobotPlayer* bot, float dt)
+	{
+		void (RobotPlayer::*actFuncPtr)(float dt) = findAction(decTree, bot, dt);
+		if (actFuncPtr != NULL) {
 			(bot->*actFuncPtr)(dt);
 		}
 	}
@@ -99,7 +105,7 @@ namespace aicore
 
 		doUpdateShootingDecisions[3].decFuncPtr = &RobotPlayer::isTargetClose;
 		doUpdateShootingDecisions[3].trueBranch = &doUpdateShootingDecisions[7];
-		doUpdateShootingDecisions[3].falseBranch = &doUpdateShootingActions[4];
+		doUpdateShootingDecisions[3].falseBranch = &doUpdateShootingDecisions[4];
 		
 		doUpdateShootingDecisions[4].decFuncPtr = &RobotPlayer::isShotCloseToTarget;
 		doUpdateShootingDecisions[4].trueBranch = &doUpdateShootingDecisions[5];
@@ -99,6 +99,11 @@ namespace aicore
         virtual DecisionTreeNode* makeDecision(RobotPlayer* bot, float dt);
 		virtual bool getBranch(RobotPlayer* bot, float dt);
 		static void runDecisionTree(DecisionPtr decTree[], RobotPlayer* bot, float dt);
+		/**
+		* Walks the tree like runDecisionTree, but returns the action
+		* it reaches instead of running it (NULL if it has none).
+		*/
+		static RobotPlayer::Action findAction(DecisionPtr decTree[], RobotPlayer* bot, float dt);
 	};
 
 	/**